@@ -0,0 +1,240 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "CliSession.h"
+
+#include <string.h>
+
+#include "custom_assert.h"
+
+#define CLI_SESSION_MAX_VARINT_SIZE (5U) /* LEB128 of an uint32_t */
+
+/* #############################################################################
+ * # static function prototypes
+ * ###########################################################################*/
+
+static void prv_write_record(cli_session_recorder_t* const inout_recorder, uint8_t in_kind, const cli_iovec_t* in_iov,
+                             size_t in_nof_iov);
+static size_t prv_encode_varint(uint32_t in_value, uint8_t* out_data);
+static bool prv_decode_varint(cli_session_reader_t* const inout_reader, uint32_t* const out_value);
+
+static int prv_transport_read(void* context, char* out_data, size_t in_capacity);
+static int prv_transport_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static int prv_transport_flush(void* context);
+static bool prv_transport_poll_ready(void* context);
+
+/* #############################################################################
+ * # global function implementations
+ * ###########################################################################*/
+
+void cli_session_start_recording(cli_session_recorder_t* const out_recorder, const cli_transport_t* const in_inner,
+                                 cli_clock_fn in_clock_fn, cli_session_write_fn in_write_fn, void* in_write_context,
+                                 cli_transport_t* const out_transport)
+{
+    { // Input Checks
+        ASSERT(out_recorder);
+        ASSERT(in_inner);
+        ASSERT(in_clock_fn);
+        ASSERT(in_write_fn);
+        ASSERT(out_transport);
+    }
+
+    out_recorder->inner = in_inner;
+    out_recorder->clock_fn = in_clock_fn;
+    out_recorder->write_fn = in_write_fn;
+    out_recorder->write_context = in_write_context;
+    out_recorder->last_record_time_us = in_clock_fn();
+    out_recorder->nof_records = 0;
+
+    const uint8_t header[CLI_SESSION_HEADER_SIZE] = {CLI_SESSION_MAGIC[0], CLI_SESSION_MAGIC[1], CLI_SESSION_MAGIC[2],
+                                                     CLI_SESSION_MAGIC[3], CLI_SESSION_VERSION};
+    in_write_fn(header, sizeof(header), in_write_context);
+
+    // The optional functions stay optional
+    out_transport->read = prv_transport_read;
+    out_transport->writev = prv_transport_writev;
+    out_transport->flush = (NULL != in_inner->flush) ? prv_transport_flush : NULL;
+    out_transport->poll_ready = (NULL != in_inner->poll_ready) ? prv_transport_poll_ready : NULL;
+    out_transport->context = out_recorder;
+}
+
+bool cli_session_open(cli_session_reader_t* const out_reader, const uint8_t* in_data, size_t in_size)
+{
+    { // Input Checks
+        ASSERT(out_reader);
+        ASSERT(in_data || (0 == in_size));
+    }
+
+    out_reader->data = in_data;
+    out_reader->size = in_size;
+    out_reader->pos = CLI_SESSION_HEADER_SIZE;
+
+    return (in_size >= CLI_SESSION_HEADER_SIZE) && (0 == memcmp(in_data, CLI_SESSION_MAGIC, 4))
+           && (CLI_SESSION_VERSION == in_data[4]);
+}
+
+bool cli_session_next_record(cli_session_reader_t* const inout_reader, cli_session_record_t* const out_record)
+{
+    { // Input Checks
+        ASSERT(inout_reader);
+        ASSERT(out_record);
+    }
+
+    cli_session_reader_t reader = *inout_reader;
+    if (reader.pos >= reader.size)
+    {
+        return false;
+    }
+
+    const uint8_t kind = reader.data[reader.pos];
+    reader.pos++;
+
+    uint32_t delta_us = 0;
+    uint32_t len = 0;
+    if ((false == prv_decode_varint(&reader, &delta_us)) || (false == prv_decode_varint(&reader, &len))
+        || (len > (reader.size - reader.pos)))
+    {
+        return false;
+    }
+
+    out_record->kind = kind;
+    out_record->delta_us = delta_us;
+    out_record->data = &reader.data[reader.pos];
+    out_record->len = len;
+
+    // The reader only moves on over complete records
+    inout_reader->pos = reader.pos + len;
+    return true;
+}
+
+/* #############################################################################
+ * # static function implementations
+ * ###########################################################################*/
+
+static void prv_write_record(cli_session_recorder_t* const inout_recorder, uint8_t in_kind, const cli_iovec_t* in_iov,
+                             size_t in_nof_iov)
+{
+    uint8_t header[1 + (2 * CLI_SESSION_MAX_VARINT_SIZE)];
+    size_t header_len = 0;
+    size_t nof_bytes = 0;
+
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        nof_bytes += in_iov[i].len;
+    }
+
+    const uint32_t now_us = inout_recorder->clock_fn();
+    header[header_len++] = in_kind;
+    header_len += prv_encode_varint(now_us - inout_recorder->last_record_time_us, &header[header_len]);
+    header_len += prv_encode_varint((uint32_t)nof_bytes, &header[header_len]);
+    inout_recorder->last_record_time_us = now_us;
+
+    // One record per call - the iovecs are not gathered into a copy
+    inout_recorder->write_fn(header, header_len, inout_recorder->write_context);
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        if (in_iov[i].len > 0)
+        {
+            inout_recorder->write_fn((const uint8_t*)in_iov[i].base, in_iov[i].len, inout_recorder->write_context);
+        }
+    }
+    inout_recorder->nof_records++;
+}
+
+static size_t prv_encode_varint(uint32_t in_value, uint8_t* out_data)
+{
+    size_t len = 0;
+
+    // 7 bits per byte, least significant group first - the high bit marks that another byte follows
+    while (in_value >= 0x80U)
+    {
+        out_data[len++] = (uint8_t)(in_value | 0x80U);
+        in_value >>= 7;
+    }
+    out_data[len++] = (uint8_t)in_value;
+    return len;
+}
+
+static bool prv_decode_varint(cli_session_reader_t* const inout_reader, uint32_t* const out_value)
+{
+    uint32_t value = 0;
+
+    for (uint32_t i = 0; i < CLI_SESSION_MAX_VARINT_SIZE; i++)
+    {
+        if (inout_reader->pos >= inout_reader->size)
+        {
+            return false;
+        }
+        const uint8_t byte = inout_reader->data[inout_reader->pos];
+        inout_reader->pos++;
+
+        value |= (uint32_t)(byte & 0x7FU) << (7 * i);
+        if (0 == (byte & 0x80U))
+        {
+            *out_value = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int prv_transport_read(void* context, char* out_data, size_t in_capacity)
+{
+    cli_session_recorder_t* const recorder = (cli_session_recorder_t*)context;
+    ASSERT(recorder);
+
+    const int nof_read_chars = recorder->inner->read(recorder->inner->context, out_data, in_capacity);
+    if (nof_read_chars > 0)
+    {
+        const cli_iovec_t input = {out_data, (size_t)nof_read_chars};
+        prv_write_record(recorder, CLI_SESSION_RECORD_INPUT, &input, 1);
+    }
+    return nof_read_chars;
+}
+
+static int prv_transport_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    cli_session_recorder_t* const recorder = (cli_session_recorder_t*)context;
+    ASSERT(recorder);
+
+    prv_write_record(recorder, CLI_SESSION_RECORD_OUTPUT, in_iov, in_nof_iov);
+    return recorder->inner->writev(recorder->inner->context, in_iov, in_nof_iov);
+}
+
+static int prv_transport_flush(void* context)
+{
+    cli_session_recorder_t* const recorder = (cli_session_recorder_t*)context;
+    ASSERT(recorder);
+
+    return recorder->inner->flush(recorder->inner->context);
+}
+
+static bool prv_transport_poll_ready(void* context)
+{
+    cli_session_recorder_t* const recorder = (cli_session_recorder_t*)context;
+    ASSERT(recorder);
+
+    return recorder->inner->poll_ready(recorder->inner->context);
+}
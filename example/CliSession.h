@@ -0,0 +1,98 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#if !defined(CLI_SESSION_H)
+#define CLI_SESSION_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Cli.h"
+
+#define CLI_SESSION_MAGIC          "CLIS"
+#define CLI_SESSION_VERSION        (1U)
+#define CLI_SESSION_HEADER_SIZE    (5U)
+#define CLI_SESSION_RECORD_INPUT   (0x01U) /* bytes the cli read from its transport */
+#define CLI_SESSION_RECORD_OUTPUT  (0x02U) /* bytes of one writev call of the cli */
+
+    /**
+     * Session log - the traffic of a transport, so that real operator sessions can be replayed later:
+     *   "CLIS" | version (uint8) | record | record | ...
+     *   record: kind (uint8) | us since the previous record (LEB128) | nof bytes (LEB128) | bytes
+     * The first record is timed relative to the start of the recording.
+     */
+    typedef void (*cli_session_write_fn)(const uint8_t* in_data, size_t in_len, void* context);
+
+    /**
+     * Records the traffic of another transport - hand the transport filled in by cli_session_start_recording
+     * to cli_set_transport. The log bytes go to the write function as they are produced, nothing is buffered.
+     * Gaps between records must be shorter than the wrap around of the (microsecond) clock.
+     */
+    typedef struct
+    {
+        const cli_transport_t* inner;
+        cli_clock_fn clock_fn;
+        cli_session_write_fn write_fn;
+        void* write_context;
+        uint32_t last_record_time_us;
+        uint32_t nof_records;
+    } cli_session_recorder_t;
+
+    typedef struct
+    {
+        const uint8_t* data;
+        size_t size;
+        size_t pos;
+    } cli_session_reader_t;
+
+    typedef struct
+    {
+        uint8_t kind;
+        uint32_t delta_us;   // since the previous record
+        const uint8_t* data; // points into the log
+        uint32_t len;
+    } cli_session_record_t;
+
+    void cli_session_start_recording(cli_session_recorder_t* const out_recorder, const cli_transport_t* const in_inner,
+                                     cli_clock_fn in_clock_fn, cli_session_write_fn in_write_fn, void* in_write_context,
+                                     cli_transport_t* const out_transport);
+
+    /** Checks the header of a session log in memory. Returns false, if it is no (supported) session log. */
+    bool cli_session_open(cli_session_reader_t* const out_reader, const uint8_t* in_data, size_t in_size);
+
+    /** Returns false at the end of the log - or at a truncated record, which is not returned. */
+    bool cli_session_next_record(cli_session_reader_t* const inout_reader, cli_session_record_t* const out_record);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif // CLI_SESSION_H
@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file bench_profile.c
+ * @brief Measures the RAM and the cost per received character of one feature profile (see cli_config.h).
+ *
+ * Built once per profile by profile_matrix.sh, which adds the flash size of Cli.c to the report. Prints one row:
+ * the profile name, sizeof(cli_cfg_t), and the cycles and nanoseconds per character for typed command lines -
+ * echo, tokenizing, dispatch and the status line included. Cycles are read from the time stamp counter on x86
+ * and are not available elsewhere.
+ */
+
+#define _DEFAULT_SOURCE // clock_gettime
+
+#include "Cli.h"
+#include "custom_assert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLE_COUNTER (1)
+#else
+#define BENCH_HAS_CYCLE_COUNTER (0)
+#endif
+
+#define BENCH_NOF_LINES (200000)
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static int prv_cmd_dummy(int argc, char* argv[], void* context);
+static int prv_discard_char(char in_char);
+static void prv_assert_failed(const char* file, uint32_t line, const char* expr);
+static uint64_t prv_now_ns(void);
+static uint64_t prv_now_cycles(void);
+
+// ###########################################################################
+// # Private Variables
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg = {0};
+
+static cli_binding_t g_bindings[] = {
+    {"led", prv_cmd_dummy, NULL, "Set a led - led n on|off", NULL, NULL},
+    {"adc", prv_cmd_dummy, NULL, "Read an adc channel - adc n", NULL, NULL},
+    {"pwm", prv_cmd_dummy, NULL, "Set a pwm duty - pwm n duty", NULL, NULL},
+};
+
+static const char* const g_lines[] = {"led 1 on\n", "adc 3\n", "pwm 2 50\n"};
+
+// #############################################################################
+// # Main
+// ###########################################################################
+
+int main(int argc, char* argv[])
+{
+    const char* const profile_name = (argc > 1) ? argv[1] : "default";
+
+    custom_assert_init(prv_assert_failed);
+    cli_init(&g_cli_cfg, prv_discard_char);
+    cli_set_terminal_caps(CLI_TERM_CAP_ANSI);
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(g_bindings); i++)
+    {
+        cli_register(&g_bindings[i]);
+    }
+
+    uint64_t nof_chars = 0;
+    const uint64_t start_ns = prv_now_ns();
+    const uint64_t start_cycles = prv_now_cycles();
+    for (uint32_t line_idx = 0; line_idx < BENCH_NOF_LINES; line_idx++)
+    {
+        const char* const line = g_lines[line_idx % CLI_GET_ARRAY_SIZE(g_lines)];
+        for (const char* c = line; '\0' != *c; c++)
+        {
+            cli_receive(*c);
+        }
+        cli_process();
+        nof_chars += strlen(line);
+    }
+    const double cycles_per_char = (double)(prv_now_cycles() - start_cycles) / (double)nof_chars;
+    const double ns_per_char = (double)(prv_now_ns() - start_ns) / (double)nof_chars;
+
+    printf("%-16s | %10zu | ", profile_name, sizeof(cli_cfg_t));
+    if (0 != BENCH_HAS_CYCLE_COUNTER)
+    {
+        printf("%11.1f | ", cycles_per_char);
+    }
+    else
+    {
+        printf("%11s | ", "-");
+    }
+    printf("%9.1f\n", ns_per_char);
+
+    cli_deinit(&g_cli_cfg);
+    return 0;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static int prv_cmd_dummy(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    cli_print("done");
+    return CLI_OK_STATUS;
+}
+
+static int prv_discard_char(char in_char)
+{
+    (void)in_char;
+    return 0;
+}
+
+static void prv_assert_failed(const char* file, uint32_t line, const char* expr)
+{
+    printf("%s(%u): ASSERT failed: %s\n", file, line, expr);
+    exit(EXIT_FAILURE);
+}
+
+static uint64_t prv_now_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t prv_now_cycles(void)
+{
+#if (0 != BENCH_HAS_CYCLE_COUNTER)
+    return (uint64_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
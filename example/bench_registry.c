@@ -0,0 +1,182 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * @file bench_registry.c
+ * @brief Measures register / unregister churn and command lookup with large binding tables.
+ *
+ * Build with a large table, e.g. through the `bench-registry` CMake target (CLI_MAX_NOF_CALLBACKS=10001).
+ * For 1k and 10k registered commands random commands are unregistered and registered again, then
+ * every command is dispatched once - from the binding table of the instance and from a shared registry.
+ */
+
+#define _DEFAULT_SOURCE // clock_gettime
+
+#include "Cli.h"
+#include "custom_assert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static int prv_cmd_dummy(int argc, char* argv[], void* context);
+static int prv_discard_char(char in_char);
+static void prv_assert_failed(const char* file, uint32_t line, const char* expr);
+static uint64_t prv_now_ns(void);
+static void prv_run_benchmark(size_t in_nof_commands, size_t in_nof_churn_rounds);
+static uint64_t prv_dispatch_all(size_t in_nof_commands);
+
+// ###########################################################################
+// # Private Variables
+// ###########################################################################
+
+#define BENCH_MAX_NOF_COMMANDS (CLI_MAX_NOF_CALLBACKS - 1) // the help command takes one slot
+
+static cli_cfg_t g_cli_cfg = {0};
+static cli_binding_t g_commands[BENCH_MAX_NOF_COMMANDS];
+static cli_registry_t g_registry;
+static cli_size_t g_registry_index[CLI_REGISTRY_INDEX_SIZE(BENCH_MAX_NOF_COMMANDS)];
+
+// #############################################################################
+// # Main
+// ###########################################################################
+
+int main(void)
+{
+    custom_assert_init(prv_assert_failed);
+
+    for (size_t i = 0; i < BENCH_MAX_NOF_COMMANDS; i++)
+    {
+        snprintf((char*)g_commands[i].name, CLI_MAX_CMD_NAME_LENGTH, "module%zu_cmd", i);
+        snprintf((char*)g_commands[i].help, CLI_MAX_HELPER_STRING_LENGTH, "benchmark command %zu", i);
+        g_commands[i].cmd_fn = prv_cmd_dummy;
+    }
+
+    printf("%10s | %16s | %16s | %16s\n", "commands", "churn [ns/op]", "dispatch [ns/op]", "shared [ns/op]");
+    if (BENCH_MAX_NOF_COMMANDS >= 1000)
+    {
+        prv_run_benchmark(1000, 100000);
+    }
+    if (BENCH_MAX_NOF_COMMANDS >= 10000)
+    {
+        prv_run_benchmark(10000, 100000);
+    }
+    if (BENCH_MAX_NOF_COMMANDS < 1000)
+    {
+        printf("Build with -DCLI_MAX_NOF_CALLBACKS=10001 to run the benchmark\n");
+    }
+    printf("A shared registry saves %zu bytes per command in every cli instance\n", sizeof(cli_binding_t));
+
+    return 0;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static void prv_run_benchmark(size_t in_nof_commands, size_t in_nof_churn_rounds)
+{
+    cli_init(&g_cli_cfg, prv_discard_char);
+
+    for (size_t i = 0; i < in_nof_commands; i++)
+    {
+        cli_register(&g_commands[i]);
+    }
+
+    // Unregister a random command and register it again - one op is one unregister plus one register
+    srand(1);
+    uint64_t start_ns = prv_now_ns();
+    for (size_t round = 0; round < in_nof_churn_rounds; round++)
+    {
+        const size_t victim = (size_t)rand() % in_nof_commands;
+        cli_unregister(g_commands[victim].name);
+        cli_register(&g_commands[victim]);
+    }
+    const uint64_t churn_ns = prv_now_ns() - start_ns;
+
+    const uint64_t dispatch_ns = prv_dispatch_all(in_nof_commands);
+    cli_deinit(&g_cli_cfg);
+
+    // The same commands from a shared registry - the instance holds only the help command
+    cli_init(&g_cli_cfg, prv_discard_char);
+    if (false == cli_registry_build(&g_registry, g_commands, (cli_size_t)in_nof_commands, g_registry_index,
+                                    (cli_size_t)CLI_REGISTRY_INDEX_SIZE(in_nof_commands)))
+    {
+        printf("Building the registry failed\n");
+        exit(EXIT_FAILURE);
+    }
+    cli_set_registry(&g_registry);
+    const uint64_t shared_dispatch_ns = prv_dispatch_all(in_nof_commands);
+    cli_deinit(&g_cli_cfg);
+
+    printf("%10zu | %16.1f | %16.1f | %16.1f\n", in_nof_commands, (double)churn_ns / (double)in_nof_churn_rounds,
+           (double)dispatch_ns / (double)in_nof_commands, (double)shared_dispatch_ns / (double)in_nof_commands);
+}
+
+static uint64_t prv_dispatch_all(size_t in_nof_commands)
+{
+    // Dispatch every command once through the regular receive / process path
+    const uint64_t start_ns = prv_now_ns();
+    for (size_t i = 0; i < in_nof_commands; i++)
+    {
+        for (const char* c = g_commands[i].name; '\0' != *c; c++)
+        {
+            cli_receive(*c);
+        }
+        cli_receive('\n');
+        cli_process();
+    }
+    return prv_now_ns() - start_ns;
+}
+
+static int prv_cmd_dummy(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    return CLI_OK_STATUS;
+}
+
+static int prv_discard_char(char in_char)
+{
+    (void)in_char;
+    return 0;
+}
+
+static uint64_t prv_now_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+static void prv_assert_failed(const char* file, uint32_t line, const char* expr)
+{
+    printf("%s(%u): ASSERT failed: %s\n", file, line, expr);
+    exit(EXIT_FAILURE);
+}
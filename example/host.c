@@ -30,10 +30,23 @@
  * CLI library. 
  */
 
+#define _DEFAULT_SOURCE // clock_gettime, nanosleep, sigaction
+
 #include "Cli.h"
+#include "CliSession.h"
 #include "custom_assert.h"
+#include "host_executor.h"
+#include "host_replay.h"
+#include "host_shm.h"
+#include "host_transport.h"
 
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
 
 // ###########################################################################
 // # Private function decleration
@@ -42,10 +55,27 @@ static int prv_cmd_hello_world(int argc, char* argv[], void* context);
 static int prv_cmd_echo_string(int argc, char* argv[], void* context);
 static int prv_cmd_display_args(int argc, char* argv[], void* context);
 static int prv_cmd_dummy(int argc, char* argv[], void* context);
+static int prv_cmd_upload(int argc, char* argv[], void* context);
+static int prv_cmd_flash(int argc, char* argv[], void* context);
+static int prv_cmd_regs(int argc, char* argv[], void* context);
+static int prv_upload_chunk(uint32_t in_offset, const uint8_t* in_data, size_t in_len, void* context);
+static void prv_upload_done(int in_status, uint32_t in_nof_bytes, void* context);
 
 static int prv_console_put_char(char in_char);
-static char prv_console_get_char(void);
 static void prv_assert_failed(const char* file, uint32_t line, const char* expr);
+static void prv_open_transport(int argc, char* argv[]);
+static const char* prv_find_option_value(int argc, char* argv[], const char* const in_option);
+static void prv_write_session_log(const uint8_t* in_data, size_t in_len, void* context);
+static void prv_enter_raw_mode(void);
+static void prv_restore_terminal_mode(void);
+static void prv_handle_stop_signal(int signal_number);
+
+static uint32_t prv_clock_us(void);
+static uint32_t prv_clock_ms(void);
+static int prv_measured_read(void* context, char* out_data, size_t in_capacity);
+static int prv_measured_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static int prv_compare_samples(const void* in_a, const void* in_b);
+static void prv_print_latency_report(void);
 
 // ###########################################################################
 // # Private Variables
@@ -54,6 +84,30 @@ static void prv_assert_failed(const char* file, uint32_t line, const char* expr)
 // embedded cli object - contains all data. This memory is to be managed by the user
 static cli_cfg_t g_cli_cfg = {0};
 
+// transport (stdio, pty or tcp socket) the cli talks through
+static host_transport_fd_t g_transport_fds = {-1, -1, -1};
+static cli_transport_t g_transport = {0};
+static host_shm_t* g_shm = NULL; // set with --shm - then the rings replace the file descriptors
+
+// terminal settings before switching to raw mode - restored on exit
+static struct termios g_saved_terminal_mode;
+static int g_is_raw_mode_active = 0;
+
+static volatile sig_atomic_t g_is_stop_requested = 0;
+
+// input-to-echo latency measurement (--latency)
+#define HOST_MAX_NOF_LATENCY_SAMPLES (1U << 16)
+static cli_transport_t g_measured_transport = {0};
+static uint32_t g_latency_samples_us[HOST_MAX_NOF_LATENCY_SAMPLES];
+static size_t g_nof_latency_samples = 0;
+static size_t g_nof_unechoed_keystrokes = 0;
+static uint32_t g_last_read_timestamp_us = 0;
+
+// session recording (--record)
+static FILE* g_session_file = NULL;
+static cli_session_recorder_t g_session_recorder;
+static cli_transport_t g_recorded_transport = {0};
+
 /**
  * 'command name' - 'command handler' - 'pointer to context' - 'help string'
  * 
@@ -63,17 +117,24 @@ static cli_cfg_t g_cli_cfg = {0};
  * - The 'help string' is the string that is printed when the help command is executed. (Have a look at the Readme.md file for an example)
  */
 static cli_binding_t cli_bindings[] = {
-    {"hello", prv_cmd_hello_world, NULL, "Say hello"},
-    {"args", prv_cmd_display_args, NULL, "Displays the given cli arguments"},
-    {"echo", prv_cmd_echo_string, NULL, "Echoes the given string"},
-    {"dummy", prv_cmd_dummy, NULL, "dummy stuffens"},
+    {"hello", prv_cmd_hello_world, NULL, "Say hello", NULL, NULL},
+    {"args", prv_cmd_display_args, NULL, "Displays the given cli arguments", NULL, NULL},
+    {"echo", prv_cmd_echo_string, NULL, "Echoes the given string", NULL, NULL},
+    {"dummy", prv_cmd_dummy, NULL, "dummy stuffens", NULL, NULL},
+    {"upload", prv_cmd_upload, NULL, "Binary transfer - upload [-b64] [offset]", NULL, NULL},
+    {"flash", prv_cmd_flash, NULL, "Slow I/O, runs on a worker - flash [nof sectors]", NULL, NULL},
+    {"regs", prv_cmd_regs, NULL, "Dumps the registers of a peripheral - see output", NULL, NULL},
 };
 
+// Commands whose handlers run on the worker threads of host_executor - the cli stays responsive meanwhile
+static const char* const g_offloaded_commands[] = {"flash", NULL};
+static cli_executor_t g_executor = {0};
+
 // #############################################################################
 // # Main
 // ###########################################################################
 
-int main(void)
+int main(int argc, char* argv[])
 {
     // sets up the assert with its assert_failed function
     custom_assert_init(prv_assert_failed);
@@ -85,6 +146,17 @@ int main(void)
      * on the state of this memory).
      */
     cli_init(&g_cli_cfg, prv_console_put_char);
+    fflush(stdout);
+
+    /**
+     * Tell the cli what the connected terminal understands. With CLI_TERM_CAP_NONE only printable
+     * characters, backspaces and CR/LF are sent. ANSI terminals get colors and erase-to-end-of-line,
+     * terminals that support ECMA-48 REP (like xterm) get the rulers as a single repeat sequence.
+     */
+    cli_set_terminal_caps(CLI_TERM_CAP_ANSI | CLI_TERM_CAP_REP);
+
+    // The clock is used by cli_process_budget - this demo has no deadline, so it calls cli_process
+    cli_set_clock(prv_clock_us);
 
     /**
      * Register all external command bindings - these are the ones listed here in this demo
@@ -103,17 +175,101 @@ int main(void)
      */
     cli_unregister("dummy");
 
-    while (1)
+    // Optional: "alias" and "set" - e.g. "alias hi = echo $NAME", "set NAME world", "hi"
+    cli_register_alias_commands();
+
+    // Optional: "watch", "jobs" and "kill" - e.g. "watch 1000 hello" - driven by cli_tick in the main loop
+    cli_register_job_commands();
+
+    // Optional: "stats" - how much of the rx buffer, the binding table and argv was used, and what was dropped
+    cli_register_stats_command();
+
+    // Optional: "output" - "output json" or "output cbor" for host tools, e.g. "args a b" gives {"argc":3,...}
+    cli_register_output_command();
+
+    /**
+     * The cli talks through a transport instead of cli_receive and the put_char function:
+     *   ./firmware-cli               -> this terminal (switched to raw mode, so every key reaches the cli at once)
+     *   ./firmware-cli --pty         -> connect with e.g. `screen /dev/pts/<n>`
+     *   ./firmware-cli --tcp 4000    -> connect with e.g. `nc localhost 4000`
+     *   ./firmware-cli --shm FD      -> shared memory rings, started this way by the load generator (cli-loadgen)
+     * Add --latency to print the input-to-echo latency percentiles when the demo is stopped with Ctrl-C.
+     * Add --record FILE to write the session (input, output and their timing) to a session log, which
+     *   ./firmware-cli --replay FILE [--paced]
+     * feeds through the cli again - comparing the output and reporting the throughput and the time per command.
+     * The cli pulls its input in chunks and writes each answer with one writev() call.
+     */
+    const char* const replay_path = prv_find_option_value(argc, argv, "--replay");
+    if (NULL != replay_path)
     {
-        // Get a character entered by the user
-        char c = prv_console_get_char();
+        bool is_paced = false;
+        for (int i = 1; i < argc; i++)
+        {
+            is_paced |= (0 == strcmp(argv[i], "--paced"));
+        }
+        return host_replay_run(replay_path, is_paced);
+    }
+    prv_open_transport(argc, argv);
 
-        // Add the character to a queue for later processing
-        cli_receive(c);
+    if (0 == host_executor_start(g_offloaded_commands, &g_executor))
+    {
+        cli_set_executor(&g_executor);
+    }
 
-        // Process the rx buffer (all entered characters)
+    struct sigaction stop_action = {0};
+    stop_action.sa_handler = prv_handle_stop_signal;
+    (void)sigaction(SIGINT, &stop_action, NULL);
+    (void)sigaction(SIGTERM, &stop_action, NULL);
+
+    while (0 == g_is_stop_requested)
+    {
+        // Sleep in poll() until there is input or the next job expires - without jobs there is no timeout at all
+        uint32_t next_deadline_ms = 0;
+        const uint8_t work = cli_poll(&next_deadline_ms);
+        int timeout_ms = -1;
+        if (0 != (work & (CLI_WORK_LINE_READY | CLI_WORK_OUTPUT_PENDING | CLI_WORK_INPUT_PENDING | CLI_WORK_JOB_DUE)))
+        {
+            timeout_ms = 0;
+        }
+        else if (0 != (work & CLI_WORK_JOB_SCHEDULED))
+        {
+            const int32_t nof_ms_to_go = (int32_t)(next_deadline_ms - prv_clock_ms());
+            timeout_ms = (nof_ms_to_go > 0) ? (int)nof_ms_to_go : 0;
+        }
+        if ((0 != (work & CLI_WORK_OFFLOAD_RUNNING)) && ((timeout_ms < 0) || (timeout_ms > 10)))
+        {
+            // The workers do not wake up poll() - look for finished handlers every 10 ms
+            timeout_ms = 10;
+        }
+        if (NULL != g_shm)
+        {
+            // The rings cannot be polled - wake up every 100 ms to see a stop request
+            const int shm_timeout_ms = ((timeout_ms < 0) || (timeout_ms > 100)) ? 100 : timeout_ms;
+            (void)host_shm_wait(&g_shm->to_cli, shm_timeout_ms);
+        }
+        else
+        {
+            (void)host_transport_wait(&g_transport_fds, timeout_ms);
+        }
+        cli_tick(prv_clock_ms());
         cli_process();
     }
+
+    // Finishes the handlers that are still running and prints their output
+    host_executor_stop();
+    cli_process();
+    cli_set_executor(NULL);
+
+    cli_set_transport(NULL);
+    prv_restore_terminal_mode();
+    prv_print_latency_report();
+    host_transport_close(&g_transport_fds);
+    host_shm_detach(g_shm);
+    if (NULL != g_session_file)
+    {
+        (void)fclose(g_session_file);
+    }
+
     return 0;
 }
 
@@ -149,16 +305,40 @@ static int prv_cmd_echo_string(int argc, char* argv[], void* context)
 
 static int prv_cmd_display_args(int argc, char* argv[], void* context)
 {
-    int i;
-    for (i = 0; i < argc; i++)
+    // Structured output - text, JSON or CBOR, whatever the output mode is
+    cli_out_begin_map(NULL);
+    cli_out_kv_int("argc", argc);
+    cli_out_begin_array("argv");
+    for (int i = 0; i < argc; i++)
     {
-        cli_print("argv[%d] --> \"%s\" \n", i, argv[i]);
+        cli_out_kv_str(NULL, argv[i]);
     }
+    cli_out_end_array();
+    cli_out_end_map();
 
     (void)context;
     return CLI_OK_STATUS;
 }
 
+static int prv_cmd_regs(int argc, char* argv[], void* context)
+{
+    // A made up peripheral with 64 registers - each one is written as it is read, the dump is never held in RAM
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    cli_out_begin_array(NULL);
+    for (uint32_t offset = 0; offset < (64U * 4U); offset += 4U)
+    {
+        cli_out_begin_map(NULL);
+        cli_out_kv_hex("offset", offset);
+        cli_out_kv_hex("value", (offset * 0x01010101U) ^ 0xA5A50000U);
+        cli_out_end_map();
+    }
+    cli_out_end_array();
+    return CLI_OK_STATUS;
+}
+
 static int prv_cmd_dummy(int argc, char* argv[], void* context)
 {
     (void)argc;
@@ -167,17 +347,274 @@ static int prv_cmd_dummy(int argc, char* argv[], void* context)
     return CLI_OK_STATUS;
 }
 
+static int prv_cmd_flash(int argc, char* argv[], void* context)
+{
+    // Runs on a worker thread (see g_offloaded_commands) - the sleep stands in for a slow flash erase / write
+    const uint32_t nof_sectors = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 4U;
+    const struct timespec sector_time = {0, 250L * 1000L * 1000L};
+
+    (void)context;
+    for (uint32_t i = 0; i < nof_sectors; i++)
+    {
+        (void)nanosleep(&sector_time, NULL);
+        cli_print("sector %u written\n", (unsigned)i);
+    }
+    return CLI_OK_STATUS;
+}
+
+static int prv_cmd_upload(int argc, char* argv[], void* context)
+{
+    /**
+     * Switches the cli into transfer mode after this command - the sender waits for "READY <offset> <chunk size>"
+     * and then sends frames (see cli_start_transfer). This demo only adds up the received bytes.
+     */
+    static uint32_t checksum = 0;
+    cli_transfer_t transfer = {prv_upload_chunk, prv_upload_done, &checksum, 0, false};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "-b64"))
+        {
+            transfer.is_base64 = true;
+        }
+        else
+        {
+            transfer.start_offset = (uint32_t)strtoul(argv[i], NULL, 10);
+        }
+    }
+
+    checksum = 0;
+    cli_start_transfer(&transfer);
+
+    (void)context;
+    return CLI_OK_STATUS;
+}
+
+static int prv_upload_chunk(uint32_t in_offset, const uint8_t* in_data, size_t in_len, void* context)
+{
+    uint32_t* const checksum = (uint32_t*)context;
+    for (size_t i = 0; i < in_len; i++)
+    {
+        *checksum += in_data[i];
+    }
+    (void)in_offset;
+    return CLI_OK_STATUS;
+}
+
+static void prv_upload_done(int in_status, uint32_t in_nof_bytes, void* context)
+{
+    if (CLI_OK_STATUS == in_status)
+    {
+        cli_print("Received %lu bytes, sum %lu", (unsigned long)in_nof_bytes, (unsigned long)*(uint32_t*)context);
+    }
+}
+
 // ============================
 // = Console Setup
 // ============================
 
 static int prv_console_put_char(char in_char) { return putchar(in_char); }
 
-static char prv_console_get_char(void) { return (char)getchar(); }
+static void prv_open_transport(int argc, char* argv[])
+{
+    int is_latency_measured = 0;
+    int result = -1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        is_latency_measured |= (0 == strcmp(argv[i], "--latency")) ? 1 : 0;
+    }
+
+    if ((argc >= 2) && (0 == strcmp(argv[1], "--pty")))
+    {
+        char slave_name[64] = {0};
+        result = host_transport_pty_open(&g_transport_fds, &g_transport, slave_name, sizeof(slave_name));
+        printf("\nCli is listening on %s\n", slave_name);
+    }
+    else if ((argc >= 3) && (0 == strcmp(argv[1], "--tcp")))
+    {
+        uint16_t port = (uint16_t)strtoul(argv[2], NULL, 10);
+        printf("\nWaiting for a connection on 127.0.0.1:%u\n", port);
+        fflush(stdout);
+        result = host_transport_tcp_open(&g_transport_fds, &g_transport, port);
+    }
+    else if ((argc >= 3) && (0 == strcmp(argv[1], "--shm")))
+    {
+        g_shm = host_shm_attach((int)strtol(argv[2], NULL, 10));
+        if (NULL != g_shm)
+        {
+            host_shm_transport_open(g_shm, &g_transport);
+            result = 0;
+        }
+    }
+    else
+    {
+        prv_enter_raw_mode();
+        result = host_transport_stdio_open(&g_transport_fds, &g_transport);
+    }
+    fflush(stdout);
+
+    if (0 != result)
+    {
+        prv_restore_terminal_mode();
+        printf("Could not open the transport\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const cli_transport_t* transport = &g_transport;
+    if (0 != is_latency_measured)
+    {
+        // Wrap the transport to take a timestamp when keystrokes are read and when their echo is written
+        g_measured_transport = g_transport;
+        g_measured_transport.read = prv_measured_read;
+        g_measured_transport.writev = prv_measured_writev;
+        transport = &g_measured_transport;
+    }
+
+    const char* const record_path = prv_find_option_value(argc, argv, "--record");
+    if (NULL != record_path)
+    {
+        g_session_file = fopen(record_path, "wb");
+        if (NULL == g_session_file)
+        {
+            prv_restore_terminal_mode();
+            printf("Could not open %s\n", record_path);
+            exit(EXIT_FAILURE);
+        }
+        cli_session_start_recording(&g_session_recorder, transport, prv_clock_us, prv_write_session_log,
+                                    g_session_file, &g_recorded_transport);
+        transport = &g_recorded_transport;
+    }
+    cli_set_transport(transport);
+}
+
+static const char* prv_find_option_value(int argc, char* argv[], const char* const in_option)
+{
+    for (int i = 1; i < (argc - 1); i++)
+    {
+        if (0 == strcmp(argv[i], in_option))
+        {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+static void prv_write_session_log(const uint8_t* in_data, size_t in_len, void* context)
+{
+    (void)fwrite(in_data, 1, in_len, (FILE*)context);
+}
+
+static void prv_enter_raw_mode(void)
+{
+    if ((0 == isatty(STDIN_FILENO)) || (0 != tcgetattr(STDIN_FILENO, &g_saved_terminal_mode)))
+    {
+        // Input is piped in - there is no line discipline to switch off
+        return;
+    }
+
+    struct termios raw_mode = g_saved_terminal_mode;
+
+    // Non-canonical: every key is delivered at once (Tab, Backspace, ...) - the cli echoes on its own.
+    // Ctrl-C still raises SIGINT, which ends the demo.
+    raw_mode.c_lflag &= ~(tcflag_t)(ICANON | ECHO | IEXTEN);
+    raw_mode.c_iflag &= ~(tcflag_t)(IXON | ICRNL | INLCR);
+    raw_mode.c_cc[VMIN] = 1;
+    raw_mode.c_cc[VTIME] = 0;
+
+    if (0 == tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw_mode))
+    {
+        g_is_raw_mode_active = 1;
+    }
+}
+
+static void prv_restore_terminal_mode(void)
+{
+    if (1 == g_is_raw_mode_active)
+    {
+        (void)tcsetattr(STDIN_FILENO, TCSAFLUSH, &g_saved_terminal_mode);
+        g_is_raw_mode_active = 0;
+    }
+}
+
+static void prv_handle_stop_signal(int signal_number)
+{
+    (void)signal_number;
+    g_is_stop_requested = 1;
+}
+
+// ============================
+// = Latency Measurement
+// ============================
+
+static uint32_t prv_clock_us(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000U + (uint64_t)now.tv_nsec / 1000U);
+}
+
+static uint32_t prv_clock_ms(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000U + (uint64_t)now.tv_nsec / 1000000U);
+}
+
+static int prv_measured_read(void* context, char* out_data, size_t in_capacity)
+{
+    int nof_read_chars = g_transport.read(context, out_data, in_capacity);
+    if (nof_read_chars > 0)
+    {
+        g_last_read_timestamp_us = prv_clock_us();
+        g_nof_unechoed_keystrokes += (size_t)nof_read_chars;
+    }
+    return nof_read_chars;
+}
+
+static int prv_measured_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    int result = g_transport.writev(context, in_iov, in_nof_iov);
+
+    // All keystrokes of the last chunk are echoed with this write
+    const uint32_t latency_us = prv_clock_us() - g_last_read_timestamp_us;
+    while ((g_nof_unechoed_keystrokes > 0) && (g_nof_latency_samples < HOST_MAX_NOF_LATENCY_SAMPLES))
+    {
+        g_latency_samples_us[g_nof_latency_samples] = latency_us;
+        g_nof_latency_samples++;
+        g_nof_unechoed_keystrokes--;
+    }
+    g_nof_unechoed_keystrokes = 0;
+
+    return result;
+}
+
+static int prv_compare_samples(const void* in_a, const void* in_b)
+{
+    const uint32_t a = *(const uint32_t*)in_a;
+    const uint32_t b = *(const uint32_t*)in_b;
+    return (a > b) - (a < b);
+}
+
+static void prv_print_latency_report(void)
+{
+    if (0 == g_nof_latency_samples)
+    {
+        return;
+    }
+
+    qsort(g_latency_samples_us, g_nof_latency_samples, sizeof(uint32_t), prv_compare_samples);
+
+    const size_t last_idx = g_nof_latency_samples - 1;
+    printf("\ninput-to-echo latency over %zu keystrokes [us]: p50 %u | p90 %u | p99 %u | max %u\n",
+           g_nof_latency_samples, g_latency_samples_us[last_idx * 50 / 100], g_latency_samples_us[last_idx * 90 / 100],
+           g_latency_samples_us[last_idx * 99 / 100], g_latency_samples_us[last_idx]);
+}
 
 static void prv_assert_failed(const char* file, uint32_t line, const char* expr)
 {
+    prv_restore_terminal_mode();
     printf("%s(%u): ASSERT failed: %s\n", file, line, expr);
     while (1)
         ;
-}
\ No newline at end of file
+}
@@ -0,0 +1,162 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "host_executor.h"
+
+#include <pthread.h>
+#include <string.h>
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_t workers[HOST_EXECUTOR_NOF_WORKERS];
+    size_t nof_workers;
+
+    // ring of submitted offloads - never holds more than the cli has slots
+    cli_offload_t* queue[CLI_MAX_NOF_OFFLOADS];
+    size_t idx_oldest;
+    size_t nof_queued;
+
+    const char* const* offloaded_names;
+    bool is_stop_requested;
+} host_executor_t;
+
+static host_executor_t g_executor = {.lock = PTHREAD_MUTEX_INITIALIZER, .work_available = PTHREAD_COND_INITIALIZER};
+
+static void* prv_worker_main(void* arg);
+static bool prv_is_offloaded(void* context, const cli_binding_t* in_binding);
+static bool prv_submit(void* context, cli_offload_t* inout_offload);
+
+// ###########################################################################
+// # Public function implementation
+// ###########################################################################
+
+int host_executor_start(const char* const* in_offloaded_names, cli_executor_t* const out_executor)
+{
+    if ((NULL == in_offloaded_names) || (NULL == out_executor))
+    {
+        return -1;
+    }
+
+    g_executor.offloaded_names = in_offloaded_names;
+    g_executor.idx_oldest = 0;
+    g_executor.nof_queued = 0;
+    g_executor.is_stop_requested = false;
+    for (g_executor.nof_workers = 0; g_executor.nof_workers < HOST_EXECUTOR_NOF_WORKERS; g_executor.nof_workers++)
+    {
+        if (0 != pthread_create(&g_executor.workers[g_executor.nof_workers], NULL, prv_worker_main, &g_executor))
+        {
+            break;
+        }
+    }
+    if (0 == g_executor.nof_workers)
+    {
+        return -1;
+    }
+
+    out_executor->is_offloaded = prv_is_offloaded;
+    out_executor->submit = prv_submit;
+    out_executor->context = &g_executor;
+    return 0;
+}
+
+void host_executor_stop(void)
+{
+    pthread_mutex_lock(&g_executor.lock);
+    g_executor.is_stop_requested = true;
+    pthread_cond_broadcast(&g_executor.work_available);
+    pthread_mutex_unlock(&g_executor.lock);
+
+    for (size_t i = 0; i < g_executor.nof_workers; i++)
+    {
+        (void)pthread_join(g_executor.workers[i], NULL);
+    }
+    g_executor.nof_workers = 0;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static void* prv_worker_main(void* arg)
+{
+    host_executor_t* const executor = (host_executor_t*)arg;
+
+    pthread_mutex_lock(&executor->lock);
+    for (;;)
+    {
+        while ((0 == executor->nof_queued) && (false == executor->is_stop_requested))
+        {
+            pthread_cond_wait(&executor->work_available, &executor->lock);
+        }
+        // Queued lines are still run when stopping - the cli waits for every submitted offload
+        if (0 == executor->nof_queued)
+        {
+            break;
+        }
+        cli_offload_t* const offload = executor->queue[executor->idx_oldest];
+        executor->idx_oldest = (executor->idx_oldest + 1) % CLI_MAX_NOF_OFFLOADS;
+        executor->nof_queued--;
+
+        pthread_mutex_unlock(&executor->lock);
+        cli_run_offload(offload);
+        pthread_mutex_lock(&executor->lock);
+    }
+    pthread_mutex_unlock(&executor->lock);
+
+    return NULL;
+}
+
+static bool prv_is_offloaded(void* context, const cli_binding_t* in_binding)
+{
+    const host_executor_t* const executor = (const host_executor_t*)context;
+
+    for (const char* const* name = executor->offloaded_names; NULL != *name; name++)
+    {
+        if (0 == strcmp(*name, in_binding->name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool prv_submit(void* context, cli_offload_t* inout_offload)
+{
+    host_executor_t* const executor = (host_executor_t*)context;
+
+    pthread_mutex_lock(&executor->lock);
+    const bool is_accepted = (false == executor->is_stop_requested) && (executor->nof_queued < CLI_MAX_NOF_OFFLOADS);
+    if (true == is_accepted)
+    {
+        executor->queue[(executor->idx_oldest + executor->nof_queued) % CLI_MAX_NOF_OFFLOADS] = inout_offload;
+        executor->nof_queued++;
+        pthread_cond_signal(&executor->work_available);
+    }
+    pthread_mutex_unlock(&executor->lock);
+
+    return is_accepted;
+}
@@ -0,0 +1,55 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file host_executor.h
+ * @brief cli_executor_t for the host demo: a small pthread pool that runs the handlers of slow commands.
+ *
+ * The commands to offload are listed by name. Their lines are queued in a fixed size ring and picked up by the
+ * workers, which call cli_run_offload. Everything else keeps running inline on the thread that calls cli_process.
+ */
+
+#if !defined(HOST_EXECUTOR_H)
+#define HOST_EXECUTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Cli.h"
+
+#if !defined(HOST_EXECUTOR_NOF_WORKERS)
+#define HOST_EXECUTOR_NOF_WORKERS (2)
+#endif
+
+/**
+ * Starts the workers and fills out_executor - hand it over with cli_set_executor.
+ * in_offloaded_names (NULL terminated) must stay valid until host_executor_stop. Returns 0 on success.
+ */
+int host_executor_start(const char* const* in_offloaded_names, cli_executor_t* const out_executor);
+
+/** Lets the workers finish the queued lines and joins them - call cli_process afterwards to print the results. */
+void host_executor_stop(void);
+
+#endif // HOST_EXECUTOR_H
@@ -0,0 +1,476 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file host_replay.c
+ * @brief Session replay for the host demo - performance regression runs on real operator sessions.
+ */
+
+#define _DEFAULT_SOURCE // clock_gettime, nanosleep
+
+#include "host_replay.h"
+
+#include "Cli.h"
+#include "CliSession.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_REPLAY_MAX_NOF_COMMANDS (32)
+#define HOST_REPLAY_MAX_NOF_SAMPLES  (1U << 16)
+#define HOST_REPLAY_MAX_SHOWN_CHARS  (72)
+
+typedef struct
+{
+    char name[CLI_MAX_CMD_NAME_LENGTH];
+    uint32_t nof_lines;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} host_replay_cmd_stats_t;
+
+typedef struct
+{
+    // input chunk that is currently fed to the cli
+    const uint8_t* input;
+    size_t nof_input_bytes;
+    size_t idx_next_input_byte;
+
+    uint8_t* actual_output;
+    size_t actual_output_size;
+    size_t actual_output_capacity;
+
+    // the line that is typed - for the name of the command
+    char line[CLI_MAX_RX_BUFFER_SIZE];
+    size_t line_length;
+
+    host_replay_cmd_stats_t cmds[HOST_REPLAY_MAX_NOF_COMMANDS];
+    size_t nof_cmds;
+    uint64_t line_samples_ns[HOST_REPLAY_MAX_NOF_SAMPLES];
+    size_t nof_line_samples;
+} host_replay_t;
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static uint8_t* prv_load_file(const char* const in_path, size_t* const out_size);
+static uint64_t prv_now_ns(void);
+static void prv_sleep_us(uint32_t in_delay_us);
+static uint64_t prv_feed_input(const uint8_t* in_data, size_t in_len);
+static bool prv_track_line(uint8_t in_byte);
+static void prv_add_line_sample(uint64_t in_duration_ns);
+static int prv_replay_read(void* context, char* out_data, size_t in_capacity);
+static int prv_replay_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static int prv_compare_samples(const void* in_a, const void* in_b);
+static bool prv_compare_output(const uint8_t* in_expected, size_t in_expected_size);
+static void prv_print_output_line(const char* in_label, const uint8_t* in_data, size_t in_size, size_t in_offset);
+
+// ###########################################################################
+// # Private Variables
+// ###########################################################################
+
+static host_replay_t g_replay;
+
+static const cli_transport_t g_replay_transport = {prv_replay_read, prv_replay_writev, NULL, NULL, &g_replay};
+
+// ###########################################################################
+// # Public function implementation
+// ###########################################################################
+
+int host_replay_run(const char* const in_path, bool in_is_paced)
+{
+    size_t log_size = 0;
+    uint8_t* const log = prv_load_file(in_path, &log_size);
+    cli_session_reader_t reader;
+    cli_session_record_t record;
+
+    if ((NULL == log) || (false == cli_session_open(&reader, log, log_size)))
+    {
+        printf("%s is no session log\n", in_path);
+        free(log);
+        return 1;
+    }
+
+    // The recorded output is one stream - how the cli splits it into writev calls does not matter
+    size_t expected_size = 0;
+    cli_session_reader_t output_reader = reader;
+    while (true == cli_session_next_record(&output_reader, &record))
+    {
+        expected_size += (CLI_SESSION_RECORD_OUTPUT == record.kind) ? record.len : 0;
+    }
+    uint8_t* const expected = malloc(expected_size + 1);
+    if (NULL == expected)
+    {
+        printf("No memory for the recorded output of %s\n", in_path);
+        free(log);
+        return 1;
+    }
+    expected_size = 0;
+    output_reader = reader;
+    while (true == cli_session_next_record(&output_reader, &record))
+    {
+        if (CLI_SESSION_RECORD_OUTPUT == record.kind)
+        {
+            memcpy(&expected[expected_size], record.data, record.len);
+            expected_size += record.len;
+        }
+    }
+
+    memset(&g_replay, 0, sizeof(g_replay));
+    cli_set_transport(&g_replay_transport);
+
+    uint64_t session_us = 0;
+    uint64_t processing_ns = 0;
+    size_t nof_records = 0;
+    size_t nof_input_bytes = 0;
+
+    // The host demo starts to tick right after the recording was started
+    cli_tick(0);
+    while (true == cli_session_next_record(&reader, &record))
+    {
+        // Jobs expire on the recorded timeline - in ticks, like in the main loop of the host demo. The wake ups of
+        // the recorded main loop are not logged, so the output of a job may end up one tick before or after an input.
+        const uint64_t record_us = session_us + record.delta_us;
+        while (session_us < record_us)
+        {
+            const uint64_t left_us = record_us - session_us;
+            const uint64_t step_us = (left_us < (CLI_WHEEL_TICK_MS * 1000U)) ? left_us : (CLI_WHEEL_TICK_MS * 1000U);
+            if (true == in_is_paced)
+            {
+                prv_sleep_us((uint32_t)step_us);
+            }
+            session_us += step_us;
+            cli_tick((uint32_t)(session_us / 1000U));
+
+            if (session_us < record_us)
+            {
+                const uint64_t start_ns = prv_now_ns();
+                cli_process();
+                processing_ns += prv_now_ns() - start_ns;
+            }
+        }
+
+        if (CLI_SESSION_RECORD_INPUT == record.kind)
+        {
+            processing_ns += prv_feed_input(record.data, record.len);
+            nof_input_bytes += record.len;
+        }
+        else
+        {
+            const uint64_t start_ns = prv_now_ns();
+            cli_process();
+            processing_ns += prv_now_ns() - start_ns;
+        }
+        nof_records++;
+    }
+    if (reader.pos != log_size)
+    {
+        printf("The session log is truncated after %zu records\n", nof_records);
+    }
+
+    cli_set_transport(NULL);
+
+    const double processing_s = (double)processing_ns / 1e9;
+    printf("\nreplayed %zu records: %zu input bytes, %zu lines, %zu output bytes in %.3f ms (recorded: %.3f s)\n",
+           nof_records, nof_input_bytes, g_replay.nof_line_samples, g_replay.actual_output_size, processing_s * 1e3,
+           (double)session_us / 1e6);
+    if (processing_ns > 0)
+    {
+        printf("throughput: %.0f lines/s, %.0f input bytes/s, %.0f output bytes/s\n",
+               (double)g_replay.nof_line_samples / processing_s, (double)nof_input_bytes / processing_s,
+               (double)g_replay.actual_output_size / processing_s);
+    }
+
+    if (g_replay.nof_line_samples > 0)
+    {
+        qsort(g_replay.line_samples_ns, g_replay.nof_line_samples, sizeof(uint64_t), prv_compare_samples);
+        const size_t last_idx = g_replay.nof_line_samples - 1;
+        printf("time per line [us]: p50 %.1f | p90 %.1f | p99 %.1f | max %.1f\n",
+               (double)g_replay.line_samples_ns[last_idx * 50 / 100] / 1e3,
+               (double)g_replay.line_samples_ns[last_idx * 90 / 100] / 1e3,
+               (double)g_replay.line_samples_ns[last_idx * 99 / 100] / 1e3,
+               (double)g_replay.line_samples_ns[last_idx] / 1e3);
+
+        printf("%-*s | %8s | %10s | %10s\n", CLI_MAX_CMD_NAME_LENGTH / 2, "command", "lines", "avg [us]", "max [us]");
+        for (size_t i = 0; i < g_replay.nof_cmds; i++)
+        {
+            const host_replay_cmd_stats_t* const cmd = &g_replay.cmds[i];
+            printf("%-*s | %8u | %10.1f | %10.1f\n", CLI_MAX_CMD_NAME_LENGTH / 2, cmd->name, cmd->nof_lines,
+                   (double)cmd->total_ns / cmd->nof_lines / 1e3, (double)cmd->max_ns / 1e3);
+        }
+    }
+
+    const bool is_output_identical = prv_compare_output(expected, expected_size);
+
+    free(g_replay.actual_output);
+    free(expected);
+    free(log);
+    return (true == is_output_identical) ? 0 : 1;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static uint8_t* prv_load_file(const char* const in_path, size_t* const out_size)
+{
+    FILE* const file = fopen(in_path, "rb");
+    if (NULL == file)
+    {
+        return NULL;
+    }
+
+    uint8_t* data = NULL;
+    long size = -1;
+    if ((0 == fseek(file, 0, SEEK_END)) && ((size = ftell(file)) >= 0) && (0 == fseek(file, 0, SEEK_SET)))
+    {
+        data = malloc((size_t)size + 1);
+        if ((NULL != data) && (fread(data, 1, (size_t)size, file) != (size_t)size))
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+    (void)fclose(file);
+
+    *out_size = (NULL != data) ? (size_t)size : 0;
+    return data;
+}
+
+static uint64_t prv_now_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+static void prv_sleep_us(uint32_t in_delay_us)
+{
+    const struct timespec delay = {(time_t)(in_delay_us / 1000000U), (long)(in_delay_us % 1000000U) * 1000L};
+    (void)nanosleep(&delay, NULL);
+}
+
+static uint64_t prv_feed_input(const uint8_t* in_data, size_t in_len)
+{
+    uint64_t processing_ns = 0;
+    size_t start = 0;
+
+    // Every line of the chunk is processed and timed on its own
+    while (start < in_len)
+    {
+        size_t end = start;
+        bool is_line_complete = false;
+        while ((end < in_len) && (false == is_line_complete))
+        {
+            is_line_complete = prv_track_line(in_data[end]);
+            end++;
+        }
+
+        g_replay.input = &in_data[start];
+        g_replay.nof_input_bytes = end - start;
+        g_replay.idx_next_input_byte = 0;
+
+        const uint64_t start_ns = prv_now_ns();
+        size_t nof_left_bytes = g_replay.nof_input_bytes;
+        do
+        {
+            // The cli pulls at most one transport chunk per step without a complete line
+            nof_left_bytes = g_replay.nof_input_bytes - g_replay.idx_next_input_byte;
+            cli_process();
+        } while ((g_replay.idx_next_input_byte < g_replay.nof_input_bytes)
+                 && (nof_left_bytes != (g_replay.nof_input_bytes - g_replay.idx_next_input_byte)));
+        const uint64_t duration_ns = prv_now_ns() - start_ns;
+
+        processing_ns += duration_ns;
+        if (true == is_line_complete)
+        {
+            prv_add_line_sample(duration_ns);
+        }
+        start = end;
+    }
+
+    g_replay.nof_input_bytes = 0;
+    g_replay.idx_next_input_byte = 0;
+    return processing_ns;
+}
+
+static bool prv_track_line(uint8_t in_byte)
+{
+    if (('\r' == in_byte) || ('\n' == in_byte))
+    {
+        return true;
+    }
+    if ((('\b' == in_byte) || (0x7F == in_byte)) && (g_replay.line_length > 0))
+    {
+        g_replay.line_length--;
+    }
+    else if ((in_byte >= ' ') && (in_byte < 0x7F) && (g_replay.line_length < (sizeof(g_replay.line) - 1)))
+    {
+        g_replay.line[g_replay.line_length] = (char)in_byte;
+        g_replay.line_length++;
+    }
+    return false;
+}
+
+static void prv_add_line_sample(uint64_t in_duration_ns)
+{
+    // The first word of the line names the command - empty lines are not counted
+    g_replay.line[g_replay.line_length] = '\0';
+    g_replay.line_length = 0;
+
+    char name[CLI_MAX_CMD_NAME_LENGTH] = {0};
+    if (1 != sscanf(g_replay.line, "%31s", name))
+    {
+        return;
+    }
+
+    if (g_replay.nof_line_samples < HOST_REPLAY_MAX_NOF_SAMPLES)
+    {
+        g_replay.line_samples_ns[g_replay.nof_line_samples] = in_duration_ns;
+        g_replay.nof_line_samples++;
+    }
+
+    size_t idx = 0;
+    while ((idx < g_replay.nof_cmds) && (0 != strcmp(g_replay.cmds[idx].name, name)))
+    {
+        idx++;
+    }
+    if (idx == g_replay.nof_cmds)
+    {
+        if (g_replay.nof_cmds == HOST_REPLAY_MAX_NOF_COMMANDS)
+        {
+            return;
+        }
+        memcpy(g_replay.cmds[idx].name, name, sizeof(name));
+        g_replay.nof_cmds++;
+    }
+
+    host_replay_cmd_stats_t* const cmd = &g_replay.cmds[idx];
+    cmd->nof_lines++;
+    cmd->total_ns += in_duration_ns;
+    cmd->max_ns = (in_duration_ns > cmd->max_ns) ? in_duration_ns : cmd->max_ns;
+}
+
+static int prv_replay_read(void* context, char* out_data, size_t in_capacity)
+{
+    host_replay_t* const replay = (host_replay_t*)context;
+    const size_t nof_left_bytes = replay->nof_input_bytes - replay->idx_next_input_byte;
+    const size_t nof_bytes = (nof_left_bytes < in_capacity) ? nof_left_bytes : in_capacity;
+
+    memcpy(out_data, &replay->input[replay->idx_next_input_byte], nof_bytes);
+    replay->idx_next_input_byte += nof_bytes;
+    return (int)nof_bytes;
+}
+
+static int prv_replay_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    host_replay_t* const replay = (host_replay_t*)context;
+    size_t nof_written_bytes = 0;
+
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        if ((replay->actual_output_size + in_iov[i].len) > replay->actual_output_capacity)
+        {
+            const size_t capacity = 2 * (replay->actual_output_capacity + in_iov[i].len);
+            uint8_t* const output = realloc(replay->actual_output, capacity);
+            if (NULL == output)
+            {
+                break;
+            }
+            replay->actual_output = output;
+            replay->actual_output_capacity = capacity;
+        }
+        memcpy(&replay->actual_output[replay->actual_output_size], in_iov[i].base, in_iov[i].len);
+        replay->actual_output_size += in_iov[i].len;
+        nof_written_bytes += in_iov[i].len;
+    }
+    return (int)nof_written_bytes;
+}
+
+static int prv_compare_samples(const void* in_a, const void* in_b)
+{
+    const uint64_t a = *(const uint64_t*)in_a;
+    const uint64_t b = *(const uint64_t*)in_b;
+    return (a > b) - (a < b);
+}
+
+static bool prv_compare_output(const uint8_t* in_expected, size_t in_expected_size)
+{
+    const uint8_t* const actual = g_replay.actual_output;
+    const size_t actual_size = g_replay.actual_output_size;
+    const size_t common_size = (in_expected_size < actual_size) ? in_expected_size : actual_size;
+
+    size_t offset = 0;
+    while ((offset < common_size) && (in_expected[offset] == actual[offset]))
+    {
+        offset++;
+    }
+    if ((offset == common_size) && (in_expected_size == actual_size))
+    {
+        printf("output: identical (%zu bytes)\n", actual_size);
+        return true;
+    }
+
+    size_t line_number = 1;
+    for (size_t i = 0; i < offset; i++)
+    {
+        line_number += ('\n' == in_expected[i]) ? 1 : 0;
+    }
+    printf("output: differs at byte %zu (line %zu) - %zu bytes recorded, %zu bytes replayed\n", offset, line_number,
+           in_expected_size, actual_size);
+    prv_print_output_line("recorded", in_expected, in_expected_size, offset);
+    prv_print_output_line("replayed", actual, actual_size, offset);
+    return false;
+}
+
+static void prv_print_output_line(const char* in_label, const uint8_t* in_data, size_t in_size, size_t in_offset)
+{
+    // The line with the first difference - control characters are shown escaped
+    size_t start = (in_offset < in_size) ? in_offset : in_size;
+    while ((start > 0) && ('\n' != in_data[start - 1]))
+    {
+        start--;
+    }
+
+    printf("  %s: \"", in_label);
+    for (size_t i = start; (i < in_size) && ((i - start) < HOST_REPLAY_MAX_SHOWN_CHARS); i++)
+    {
+        const uint8_t byte = in_data[i];
+        if ((byte >= ' ') && (byte < 0x7F) && ('"' != byte) && ('\\' != byte))
+        {
+            putchar(byte);
+        }
+        else
+        {
+            printf("\\x%02X", byte);
+        }
+        if ('\n' == byte)
+        {
+            break;
+        }
+    }
+    printf("\"\n");
+}
@@ -0,0 +1,46 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file host_replay.h
+ * @brief Replays a recorded session log (see CliSession.h) through the cli of the host demo.
+ *
+ * The input records are fed back in their original chunks - as fast as possible or with their original pacing -
+ * and the produced output is compared with the recorded one. Reports the throughput and the processing time
+ * per entered line, grouped by command.
+ */
+
+#if !defined(HOST_REPLAY_H)
+#define HOST_REPLAY_H
+
+#include <stdbool.h>
+
+/**
+ * The cli must be initialized with the same bindings and terminal caps as when the session was recorded.
+ * Returns 0, when the output matches the recording.
+ */
+int host_replay_run(const char* const in_path, bool in_is_paced);
+
+#endif // HOST_REPLAY_H
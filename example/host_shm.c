@@ -0,0 +1,244 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#define _GNU_SOURCE // memfd_create
+
+#include "host_shm.h"
+
+#include <sched.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_SHM_NOF_SPINS        (4096)    // checks before the waiting side starts to yield
+#define HOST_SHM_YIELD_NS         (1000000) // then it yields for a millisecond, before it sleeps
+#define HOST_SHM_SLEEP_NS         (50000)
+#define HOST_SHM_WRITE_TIMEOUT_NS (1000000000ULL) // output is dropped, when the ring stays full that long
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static int prv_shm_read(void* context, char* out_data, size_t in_capacity);
+static int prv_shm_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static bool prv_shm_poll_ready(void* context);
+static uint64_t prv_clock_ns(void);
+
+// ###########################################################################
+// # Public function implementation
+// ###########################################################################
+
+host_shm_t* host_shm_create(int* const out_fd)
+{
+    int fd = memfd_create("cli-shm", 0);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (0 != ftruncate(fd, (off_t)sizeof(host_shm_t)))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // A new memfd reads as zeros - empty rings
+    host_shm_t* const shm = host_shm_attach(fd);
+    if (NULL == shm)
+    {
+        close(fd);
+        return NULL;
+    }
+    shm->magic = HOST_SHM_MAGIC;
+
+    *out_fd = fd;
+    return shm;
+}
+
+host_shm_t* host_shm_attach(int in_fd)
+{
+    void* const memory = mmap(NULL, sizeof(host_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, in_fd, 0);
+    if (MAP_FAILED == memory)
+    {
+        return NULL;
+    }
+
+    host_shm_t* const shm = (host_shm_t*)memory;
+    if ((0 != shm->magic) && (HOST_SHM_MAGIC != shm->magic))
+    {
+        (void)munmap(memory, sizeof(host_shm_t));
+        return NULL;
+    }
+    return shm;
+}
+
+void host_shm_detach(host_shm_t* const inout_shm)
+{
+    if (NULL != inout_shm)
+    {
+        (void)munmap(inout_shm, sizeof(host_shm_t));
+    }
+}
+
+size_t host_shm_ring_write(host_shm_ring_t* const inout_ring, const void* in_data, size_t in_len)
+{
+    // Only the producer writes head - the consumer publishes the space it freed with a release store of tail
+    const uint32_t head = inout_ring->head;
+    const uint32_t tail = __atomic_load_n(&inout_ring->tail, __ATOMIC_ACQUIRE);
+    const size_t nof_free_bytes = HOST_SHM_RING_SIZE - (size_t)(head - tail);
+    const size_t nof_bytes = (in_len < nof_free_bytes) ? in_len : nof_free_bytes;
+
+    const size_t idx = head & (HOST_SHM_RING_SIZE - 1);
+    const size_t nof_bytes_to_end = HOST_SHM_RING_SIZE - idx;
+    const size_t first_part = (nof_bytes < nof_bytes_to_end) ? nof_bytes : nof_bytes_to_end;
+    memcpy(&inout_ring->data[idx], in_data, first_part);
+    memcpy(&inout_ring->data[0], (const uint8_t*)in_data + first_part, nof_bytes - first_part);
+
+    __atomic_store_n(&inout_ring->head, head + (uint32_t)nof_bytes, __ATOMIC_RELEASE);
+    return nof_bytes;
+}
+
+size_t host_shm_ring_read(host_shm_ring_t* const inout_ring, void* out_data, size_t in_capacity)
+{
+    const uint32_t tail = inout_ring->tail;
+    const uint32_t head = __atomic_load_n(&inout_ring->head, __ATOMIC_ACQUIRE);
+    const size_t nof_stored_bytes = (size_t)(head - tail);
+    const size_t nof_bytes = (in_capacity < nof_stored_bytes) ? in_capacity : nof_stored_bytes;
+
+    const size_t idx = tail & (HOST_SHM_RING_SIZE - 1);
+    const size_t nof_bytes_to_end = HOST_SHM_RING_SIZE - idx;
+    const size_t first_part = (nof_bytes < nof_bytes_to_end) ? nof_bytes : nof_bytes_to_end;
+    memcpy(out_data, &inout_ring->data[idx], first_part);
+    memcpy((uint8_t*)out_data + first_part, &inout_ring->data[0], nof_bytes - first_part);
+
+    __atomic_store_n(&inout_ring->tail, tail + (uint32_t)nof_bytes, __ATOMIC_RELEASE);
+    return nof_bytes;
+}
+
+size_t host_shm_ring_nof_bytes(const host_shm_ring_t* const in_ring)
+{
+    const uint32_t head = __atomic_load_n(&in_ring->head, __ATOMIC_ACQUIRE);
+    const uint32_t tail = __atomic_load_n(&in_ring->tail, __ATOMIC_ACQUIRE);
+    return (size_t)(head - tail);
+}
+
+int host_shm_wait(const host_shm_ring_t* const in_ring, int in_timeout_ms)
+{
+    // A busy peer answers within microseconds - spin first, then yield, then sleep in short steps
+    const uint64_t start_ns = prv_clock_ns();
+    for (uint32_t nof_checks = 0;; nof_checks++)
+    {
+        if (host_shm_ring_nof_bytes(in_ring) > 0)
+        {
+            return 1;
+        }
+        if (nof_checks < HOST_SHM_NOF_SPINS)
+        {
+            continue;
+        }
+
+        const uint64_t waited_ns = prv_clock_ns() - start_ns;
+        if ((in_timeout_ms >= 0) && (waited_ns >= ((uint64_t)in_timeout_ms * 1000000ULL)))
+        {
+            return 0;
+        }
+        if (waited_ns < HOST_SHM_YIELD_NS)
+        {
+            (void)sched_yield();
+        }
+        else
+        {
+            const struct timespec sleep_time = {0, HOST_SHM_SLEEP_NS};
+            (void)nanosleep(&sleep_time, NULL);
+        }
+    }
+}
+
+void host_shm_transport_open(host_shm_t* const in_shm, cli_transport_t* const out_transport)
+{
+    out_transport->read = prv_shm_read;
+    out_transport->writev = prv_shm_writev;
+    out_transport->flush = NULL; // writev copies straight into the ring
+    out_transport->poll_ready = prv_shm_poll_ready;
+    out_transport->context = in_shm;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static int prv_shm_read(void* context, char* out_data, size_t in_capacity)
+{
+    host_shm_t* const shm = (host_shm_t*)context;
+    return (int)host_shm_ring_read(&shm->to_cli, out_data, in_capacity);
+}
+
+static int prv_shm_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    host_shm_t* const shm = (host_shm_t*)context;
+    size_t nof_written_bytes = 0;
+    bool is_reader_gone = false;
+
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        const uint8_t* data = (const uint8_t*)in_iov[i].base;
+        size_t nof_bytes_left = in_iov[i].len;
+        uint64_t full_since_ns = 0;
+
+        // The reader usually keeps up - wait for it while the ring is full, drop the rest when it went away
+        while ((nof_bytes_left > 0) && (false == is_reader_gone))
+        {
+            const size_t nof_bytes = host_shm_ring_write(&shm->from_cli, data, nof_bytes_left);
+            data += nof_bytes;
+            nof_bytes_left -= nof_bytes;
+            nof_written_bytes += nof_bytes;
+            if (nof_bytes > 0)
+            {
+                full_since_ns = 0;
+                continue;
+            }
+
+            const uint64_t now_ns = prv_clock_ns();
+            full_since_ns = (0 == full_since_ns) ? now_ns : full_since_ns;
+            is_reader_gone = ((now_ns - full_since_ns) >= HOST_SHM_WRITE_TIMEOUT_NS) ? true : false;
+            (void)sched_yield();
+        }
+        shm->nof_dropped_bytes += (uint32_t)nof_bytes_left;
+    }
+    return (int)nof_written_bytes;
+}
+
+static bool prv_shm_poll_ready(void* context)
+{
+    const host_shm_t* const shm = (const host_shm_t*)context;
+    return (host_shm_ring_nof_bytes(&shm->to_cli) > 0) ? true : false;
+}
+
+static uint64_t prv_clock_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,86 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file host_shm.h
+ * @brief Shared memory transport for the host demo - two lock-free single producer / single consumer byte rings in
+ * a memfd, which the load generator (loadgen.c) maps as well.
+ *
+ * The load generator creates the memory and starts `firmware-cli --shm <fd>`, which inherits the file descriptor.
+ * Neither side makes a system call per line: the rings are polled, first busy, then with sched_yield and short
+ * sleeps (see host_shm_wait). Linux only (memfd_create).
+ */
+
+#if !defined(HOST_SHM_H)
+#define HOST_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Cli.h"
+
+#define HOST_SHM_RING_SIZE (1U << 16) /* bytes per direction - must be a power of two */
+#define HOST_SHM_MAGIC     (0x434C4953U)
+
+typedef struct
+{
+    uint32_t head; // free running - written by the producer only
+    uint8_t head_padding[60];
+    uint32_t tail; // free running - written by the consumer only
+    uint8_t tail_padding[60];
+    uint8_t data[HOST_SHM_RING_SIZE];
+} host_shm_ring_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t nof_dropped_bytes; // output the cli dropped, because nobody read the ring for a second
+    host_shm_ring_t to_cli;     // written by the load generator, read by the cli
+    host_shm_ring_t from_cli;   // written by the cli, read by the load generator
+} host_shm_t;
+
+/** Creates and maps the shared memory - out_fd is inherited by child processes. Returns NULL on failure. */
+host_shm_t* host_shm_create(int* const out_fd);
+
+/** Maps the shared memory created by host_shm_create in another process. Returns NULL on failure. */
+host_shm_t* host_shm_attach(int in_fd);
+
+void host_shm_detach(host_shm_t* const inout_shm);
+
+/** Copies up to in_len bytes into the ring and returns how many fit. */
+size_t host_shm_ring_write(host_shm_ring_t* const inout_ring, const void* in_data, size_t in_len);
+
+/** Copies up to in_capacity bytes out of the ring and returns how many were read. */
+size_t host_shm_ring_read(host_shm_ring_t* const inout_ring, void* out_data, size_t in_capacity);
+
+size_t host_shm_ring_nof_bytes(const host_shm_ring_t* const in_ring);
+
+/** Blocks until the ring has data or in_timeout_ms (-1: forever) expired. Returns 1 if data is available. */
+int host_shm_wait(const host_shm_ring_t* const in_ring, int in_timeout_ms);
+
+/** Fills out_transport for the cli side - it reads to_cli and writes from_cli. */
+void host_shm_transport_open(host_shm_t* const in_shm, cli_transport_t* const out_transport);
+
+#endif // HOST_SHM_H
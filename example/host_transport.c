@@ -0,0 +1,260 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * @file host_transport.c
+ * @brief File descriptor based cli transports for the host demo (POSIX only).
+ */
+
+#define _DEFAULT_SOURCE // posix_openpt & friends, writev
+#define _XOPEN_SOURCE 600
+
+#include "host_transport.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static int prv_fd_read(void* context, char* out_data, size_t in_capacity);
+static int prv_fd_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static bool prv_fd_poll_ready(void* context);
+static void prv_fill_transport(host_transport_fd_t* const in_fds, cli_transport_t* const out_transport);
+static int prv_set_non_blocking(int fd);
+
+// ###########################################################################
+// # Public function implementation
+// ###########################################################################
+
+int host_transport_stdio_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport)
+{
+    out_fds->in_fd = STDIN_FILENO;
+    out_fds->out_fd = STDOUT_FILENO;
+    out_fds->listen_fd = -1;
+
+    if (0 != prv_set_non_blocking(out_fds->in_fd))
+    {
+        return -1;
+    }
+
+    prv_fill_transport(out_fds, out_transport);
+    return 0;
+}
+
+int host_transport_pty_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport,
+                            char* const out_slave_name, size_t in_slave_name_capacity)
+{
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master_fd < 0) || (0 != grantpt(master_fd)) || (0 != unlockpt(master_fd)))
+    {
+        return -1;
+    }
+
+    const char* slave_name = ptsname(master_fd);
+    if ((NULL == slave_name) || (strlen(slave_name) >= in_slave_name_capacity))
+    {
+        close(master_fd);
+        return -1;
+    }
+    strcpy(out_slave_name, slave_name);
+
+    out_fds->in_fd = master_fd;
+    out_fds->out_fd = master_fd;
+    out_fds->listen_fd = -1;
+
+    if (0 != prv_set_non_blocking(master_fd))
+    {
+        close(master_fd);
+        return -1;
+    }
+
+    prv_fill_transport(out_fds, out_transport);
+    return 0;
+}
+
+int host_transport_tcp_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport,
+                            uint16_t in_port)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        return -1;
+    }
+
+    int reuse_addr = 1;
+    (void)setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_addr, sizeof(reuse_addr));
+
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(in_port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((0 != bind(listen_fd, (struct sockaddr*)&address, sizeof(address))) || (0 != listen(listen_fd, 1)))
+    {
+        close(listen_fd);
+        return -1;
+    }
+
+    int client_fd = accept(listen_fd, NULL, NULL);
+    if ((client_fd < 0) || (0 != prv_set_non_blocking(client_fd)))
+    {
+        if (client_fd >= 0)
+        {
+            close(client_fd);
+        }
+        close(listen_fd);
+        return -1;
+    }
+
+    out_fds->in_fd = client_fd;
+    out_fds->out_fd = client_fd;
+    out_fds->listen_fd = listen_fd;
+
+    prv_fill_transport(out_fds, out_transport);
+    return 0;
+}
+
+int host_transport_wait(const host_transport_fd_t* const in_fds, int in_timeout_ms)
+{
+    struct pollfd poll_fd = {.fd = in_fds->in_fd, .events = POLLIN, .revents = 0};
+
+    int nof_ready_fds = poll(&poll_fd, 1, in_timeout_ms);
+    return ((nof_ready_fds > 0) && (0 != (poll_fd.revents & (POLLIN | POLLHUP)))) ? 1 : 0;
+}
+
+void host_transport_close(host_transport_fd_t* const inout_fds)
+{
+    if ((inout_fds->in_fd > STDERR_FILENO))
+    {
+        close(inout_fds->in_fd);
+    }
+    if (inout_fds->listen_fd >= 0)
+    {
+        close(inout_fds->listen_fd);
+    }
+    inout_fds->in_fd = -1;
+    inout_fds->out_fd = -1;
+    inout_fds->listen_fd = -1;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static void prv_fill_transport(host_transport_fd_t* const in_fds, cli_transport_t* const out_transport)
+{
+    out_transport->read = prv_fd_read;
+    out_transport->writev = prv_fd_writev;
+    out_transport->flush = NULL; // writev goes straight to the file descriptor - nothing is buffered
+    out_transport->poll_ready = prv_fd_poll_ready;
+    out_transport->context = in_fds;
+}
+
+static int prv_set_non_blocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return ((flags >= 0) && (0 == fcntl(fd, F_SETFL, flags | O_NONBLOCK))) ? 0 : -1;
+}
+
+static int prv_fd_read(void* context, char* out_data, size_t in_capacity)
+{
+    const host_transport_fd_t* const fds = (const host_transport_fd_t*)context;
+
+    ssize_t nof_read_bytes = read(fds->in_fd, out_data, in_capacity);
+    if (nof_read_bytes < 0)
+    {
+        // EAGAIN - nothing to read right now
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) ? 0 : -1;
+    }
+    return (int)nof_read_bytes;
+}
+
+static int prv_fd_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    const host_transport_fd_t* const fds = (const host_transport_fd_t*)context;
+    struct iovec iovecs[CLI_MAX_NOF_TX_IOVECS];
+    size_t nof_iovecs = 0;
+    size_t nof_total_bytes = 0;
+
+    if (in_nof_iov > CLI_MAX_NOF_TX_IOVECS)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        iovecs[i].iov_base = (void*)in_iov[i].base;
+        iovecs[i].iov_len = in_iov[i].len;
+        nof_total_bytes += in_iov[i].len;
+    }
+    nof_iovecs = in_nof_iov;
+
+    // Usually done with the first call - partial writes (full socket / pty buffer) are continued
+    size_t nof_written_bytes = 0;
+    size_t idx_iovec = 0;
+    while (nof_written_bytes < nof_total_bytes)
+    {
+        ssize_t result = writev(fds->out_fd, &iovecs[idx_iovec], (int)(nof_iovecs - idx_iovec));
+        if (result < 0)
+        {
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno))
+            {
+                struct pollfd poll_fd = {.fd = fds->out_fd, .events = POLLOUT, .revents = 0};
+                (void)poll(&poll_fd, 1, -1);
+                continue;
+            }
+            return -1;
+        }
+
+        nof_written_bytes += (size_t)result;
+        while ((idx_iovec < nof_iovecs) && ((size_t)result >= iovecs[idx_iovec].iov_len))
+        {
+            result -= (ssize_t)iovecs[idx_iovec].iov_len;
+            idx_iovec++;
+        }
+        if (idx_iovec < nof_iovecs)
+        {
+            iovecs[idx_iovec].iov_base = (char*)iovecs[idx_iovec].iov_base + result;
+            iovecs[idx_iovec].iov_len -= (size_t)result;
+        }
+    }
+
+    return (int)nof_written_bytes;
+}
+
+static bool prv_fd_poll_ready(void* context)
+{
+    return (1 == host_transport_wait((const host_transport_fd_t*)context, 0)) ? true : false;
+}
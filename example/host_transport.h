@@ -0,0 +1,62 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * @file host_transport.h
+ * @brief cli_transport_t implementations for the host demo: stdio, a pseudo terminal and a loopback TCP socket.
+ *
+ * All of them are backed by a pair of (non-blocking) file descriptors. The gathered output of the cli is
+ * written with a single writev() system call.
+ */
+
+#if !defined(HOST_TRANSPORT_H)
+#define HOST_TRANSPORT_H
+
+#include <stdint.h>
+
+#include "Cli.h"
+
+typedef struct
+{
+    int in_fd;
+    int out_fd;
+    int listen_fd; // only used by the TCP transport
+} host_transport_fd_t;
+
+int host_transport_stdio_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport);
+
+/** Opens a pseudo terminal - connect to it with e.g. `screen <slave name>`. */
+int host_transport_pty_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport,
+                            char* const out_slave_name, size_t in_slave_name_capacity);
+
+/** Listens on 127.0.0.1:in_port and blocks until one client (e.g. `nc localhost <port>`) connects. */
+int host_transport_tcp_open(host_transport_fd_t* const out_fds, cli_transport_t* const out_transport,
+                            uint16_t in_port);
+
+/** Blocks until input is available or in_timeout_ms (-1: forever) expired. Returns 1 if input is available. */
+int host_transport_wait(const host_transport_fd_t* const in_fds, int in_timeout_ms);
+
+void host_transport_close(host_transport_fd_t* const inout_fds);
+
+#endif // HOST_TRANSPORT_H
@@ -0,0 +1,446 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/**
+ * @file loadgen.c
+ * @brief Soak / load generator - drives host cli instances (firmware-cli) over shared memory rings.
+ *
+ *   ./cli-loadgen [--cli ./firmware-cli] [--instances N] [--seconds S] [--mix "line:weight;line:weight"]
+ *
+ * Each instance is started as `firmware-cli --shm <fd>` and runs the real cli_receive / cli_process path. The
+ * generator sends one line per instance, waits for its complete answer (up to the status line) and then sends
+ * the next one, picked from the mix by weight. The first answer to each line of the mix is its reference - every
+ * later answer must be identical, otherwise it is reported as corrupted. At the end the sustained throughput and
+ * the p50 / p99 / p999 latency from sending a line to the end of its answer are printed.
+ */
+
+#define _DEFAULT_SOURCE // clock_gettime, kill
+
+#include "host_shm.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOADGEN_MAX_NOF_INSTANCES   (16)
+#define LOADGEN_MAX_NOF_MIX_ENTRIES (16)
+#define LOADGEN_RESPONSE_SIZE       (8192)
+#define LOADGEN_LATENCY_BUCKET_NS   (100)    // resolution of the latency histogram
+#define LOADGEN_NOF_LATENCY_BUCKETS (100000) // up to 10 ms - slower answers are counted in the last bucket
+#define LOADGEN_STATUS_MARKER       "Status -> " // the line with it ends each answer
+#define LOADGEN_DEFAULT_MIX         "hello:4;echo soak:3;args a b c:2;help:1"
+
+typedef struct
+{
+    char line[CLI_MAX_RX_BUFFER_SIZE];
+    uint32_t weight;
+    char* reference; // first answer, NULL until it arrived
+    size_t nof_reference_bytes;
+    uint64_t nof_lines;
+    uint64_t nof_corrupted_lines;
+} loadgen_mix_entry_t;
+
+typedef struct
+{
+    host_shm_t* shm;
+    int shm_fd;
+    pid_t pid;
+    bool is_waiting;
+    bool is_warm; // the first answer of an instance includes its start up and is not measured
+    size_t idx_entry;
+    uint64_t sent_ns;
+    size_t nof_response_bytes;
+    char response[LOADGEN_RESPONSE_SIZE];
+} loadgen_instance_t;
+
+// ###########################################################################
+// # Private function decleration
+// ###########################################################################
+static int prv_parse_mix(const char* const in_mix);
+static int prv_start_instance(loadgen_instance_t* const out_instance, const char* const in_cli_path);
+static void prv_stop_instance(loadgen_instance_t* const inout_instance);
+static void prv_send_next_line(loadgen_instance_t* const inout_instance);
+static bool prv_receive_answer(loadgen_instance_t* const inout_instance);
+static void prv_check_answer(loadgen_instance_t* const inout_instance, uint64_t in_now_ns);
+static void prv_write_escaped(const char* const in_data, size_t in_len);
+static uint64_t prv_percentile_ns(double in_fraction);
+static void prv_print_report(double in_elapsed_s);
+static const char* prv_find_option_value(int argc, char* argv[], const char* const in_option);
+static uint64_t prv_clock_ns(void);
+
+// ###########################################################################
+// # Private Variables
+// ###########################################################################
+
+static loadgen_mix_entry_t g_mix[LOADGEN_MAX_NOF_MIX_ENTRIES];
+static size_t g_nof_mix_entries = 0;
+static uint32_t g_total_weight = 0;
+
+static loadgen_instance_t g_instances[LOADGEN_MAX_NOF_INSTANCES];
+static size_t g_nof_instances = 0;
+
+static uint32_t g_latency_buckets[LOADGEN_NOF_LATENCY_BUCKETS];
+static uint64_t g_nof_latency_samples = 0;
+static uint64_t g_max_latency_ns = 0;
+static uint64_t g_nof_lines = 0;
+static uint64_t g_nof_corrupted_lines = 0;
+static uint32_t g_random_state = 0x2545F491U;
+
+// #############################################################################
+// # Main
+// ###########################################################################
+
+int main(int argc, char* argv[])
+{
+    const char* const cli_option = prv_find_option_value(argc, argv, "--cli");
+    const char* const instances_option = prv_find_option_value(argc, argv, "--instances");
+    const char* const seconds_option = prv_find_option_value(argc, argv, "--seconds");
+    const char* const mix_option = prv_find_option_value(argc, argv, "--mix");
+
+    const char* const cli_path = (NULL != cli_option) ? cli_option : "./firmware-cli";
+    const long nof_instances = (NULL != instances_option) ? strtol(instances_option, NULL, 10) : 1;
+    const double nof_seconds = (NULL != seconds_option) ? strtod(seconds_option, NULL) : 10.0;
+
+    if ((nof_instances < 1) || (nof_instances > LOADGEN_MAX_NOF_INSTANCES) || (nof_seconds <= 0.0)
+        || (0 != prv_parse_mix((NULL != mix_option) ? mix_option : LOADGEN_DEFAULT_MIX)))
+    {
+        printf("Usage: %s [--cli PATH] [--instances 1..%d] [--seconds S] [--mix \"line:weight;...\"]\n", argv[0],
+               LOADGEN_MAX_NOF_INSTANCES);
+        return EXIT_FAILURE;
+    }
+
+    // The cli exits on SIGTERM - a failed start must not leave the others behind
+    for (g_nof_instances = 0; g_nof_instances < (size_t)nof_instances; g_nof_instances++)
+    {
+        if (0 != prv_start_instance(&g_instances[g_nof_instances], cli_path))
+        {
+            printf("Could not start %s\n", cli_path);
+            for (size_t i = 0; i < g_nof_instances; i++)
+            {
+                prv_stop_instance(&g_instances[i]);
+            }
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%zu instance(s) of %s for %.1f s\n", g_nof_instances, cli_path, nof_seconds);
+    fflush(stdout);
+
+    const uint64_t start_ns = prv_clock_ns();
+    const uint64_t end_ns = start_ns + (uint64_t)(nof_seconds * 1e9);
+    uint64_t now_ns = start_ns;
+    bool is_instance_lost = false;
+
+    while ((now_ns < end_ns) && (false == is_instance_lost))
+    {
+        // One line in flight per instance - a cli drops characters while it processes a line
+        bool is_progress_made = false;
+        for (size_t i = 0; i < g_nof_instances; i++)
+        {
+            loadgen_instance_t* const instance = &g_instances[i];
+            if (false == instance->is_waiting)
+            {
+                prv_send_next_line(instance);
+                is_progress_made = true;
+            }
+            else if (true == prv_receive_answer(instance))
+            {
+                now_ns = prv_clock_ns();
+                prv_check_answer(instance, now_ns);
+                is_progress_made = true;
+            }
+        }
+
+        // All instances are busy - hand the CPU over, spinning would starve them on a machine with few cores
+        if (false == is_progress_made)
+        {
+            (void)sched_yield();
+        }
+
+        // The clock and the children are looked at once per round of answers
+        if (0 == (g_nof_lines & 0x3FFU))
+        {
+            now_ns = prv_clock_ns();
+            for (size_t i = 0; i < g_nof_instances; i++)
+            {
+                is_instance_lost |= (0 != waitpid(g_instances[i].pid, NULL, WNOHANG)) ? true : false;
+            }
+        }
+    }
+    const double elapsed_s = (double)(prv_clock_ns() - start_ns) / 1e9;
+
+    for (size_t i = 0; i < g_nof_instances; i++)
+    {
+        prv_stop_instance(&g_instances[i]);
+    }
+    if (true == is_instance_lost)
+    {
+        printf("A cli instance exited during the run\n");
+    }
+
+    prv_print_report(elapsed_s);
+    return ((0 == g_nof_corrupted_lines) && (false == is_instance_lost) && (g_nof_lines > 0)) ? EXIT_SUCCESS
+                                                                                              : EXIT_FAILURE;
+}
+
+// ###########################################################################
+// # Private function implementation
+// ###########################################################################
+
+static int prv_parse_mix(const char* const in_mix)
+{
+    // line:weight;line:weight - the weight is optional (1)
+    const char* entry_start = in_mix;
+    while ('\0' != *entry_start)
+    {
+        const size_t entry_length = strcspn(entry_start, ";");
+        if ((entry_length > 0) && (g_nof_mix_entries < LOADGEN_MAX_NOF_MIX_ENTRIES))
+        {
+            loadgen_mix_entry_t* const entry = &g_mix[g_nof_mix_entries];
+            const char* const colon = memchr(entry_start, ':', entry_length);
+            const size_t line_length = (NULL != colon) ? (size_t)(colon - entry_start) : entry_length;
+            if ((0 == line_length) || (line_length >= (CLI_MAX_RX_BUFFER_SIZE - 1)))
+            {
+                return -1;
+            }
+            memcpy(entry->line, entry_start, line_length);
+            entry->line[line_length] = '\0';
+            entry->weight = (NULL != colon) ? (uint32_t)strtoul(colon + 1, NULL, 10) : 1U;
+            g_total_weight += entry->weight;
+            g_nof_mix_entries++;
+        }
+        entry_start += entry_length;
+        entry_start += (';' == *entry_start) ? 1 : 0;
+    }
+    return ((g_nof_mix_entries > 0) && (g_total_weight > 0)) ? 0 : -1;
+}
+
+static int prv_start_instance(loadgen_instance_t* const out_instance, const char* const in_cli_path)
+{
+    memset(out_instance, 0, sizeof(*out_instance));
+    out_instance->shm = host_shm_create(&out_instance->shm_fd);
+    if (NULL == out_instance->shm)
+    {
+        return -1;
+    }
+
+    out_instance->pid = fork();
+    if (0 == out_instance->pid)
+    {
+        // The child inherits the memfd - its banner and reports are not part of the answers
+        char fd_text[16];
+        snprintf(fd_text, sizeof(fd_text), "%d", out_instance->shm_fd);
+        const int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0)
+        {
+            (void)dup2(null_fd, STDOUT_FILENO);
+            (void)dup2(null_fd, STDERR_FILENO);
+        }
+        execl(in_cli_path, in_cli_path, "--shm", fd_text, (char*)NULL);
+        _exit(127);
+    }
+    return (out_instance->pid > 0) ? 0 : -1;
+}
+
+static void prv_stop_instance(loadgen_instance_t* const inout_instance)
+{
+    if (inout_instance->pid > 0)
+    {
+        (void)kill(inout_instance->pid, SIGTERM);
+        (void)waitpid(inout_instance->pid, NULL, 0);
+        inout_instance->pid = 0;
+    }
+    host_shm_detach(inout_instance->shm);
+    inout_instance->shm = NULL;
+    (void)close(inout_instance->shm_fd);
+}
+
+static void prv_send_next_line(loadgen_instance_t* const inout_instance)
+{
+    // xorshift32 - the same sequence of lines in every run
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+
+    uint32_t pick = g_random_state % g_total_weight;
+    size_t idx_entry = 0;
+    while (pick >= g_mix[idx_entry].weight)
+    {
+        pick -= g_mix[idx_entry].weight;
+        idx_entry++;
+    }
+
+    char line[CLI_MAX_RX_BUFFER_SIZE];
+    const int line_length = snprintf(line, sizeof(line), "%s\n", g_mix[idx_entry].line);
+
+    inout_instance->idx_entry = idx_entry;
+    inout_instance->nof_response_bytes = 0;
+    inout_instance->sent_ns = prv_clock_ns();
+    inout_instance->is_waiting = true;
+    (void)host_shm_ring_write(&inout_instance->shm->to_cli, line, (size_t)line_length);
+}
+
+static bool prv_receive_answer(loadgen_instance_t* const inout_instance)
+{
+    char* const response = inout_instance->response;
+    const size_t nof_free_bytes = LOADGEN_RESPONSE_SIZE - 1 - inout_instance->nof_response_bytes;
+    const size_t nof_bytes = host_shm_ring_read(&inout_instance->shm->from_cli,
+                                                &response[inout_instance->nof_response_bytes], nof_free_bytes);
+    if (0 == nof_bytes)
+    {
+        return (0 == nof_free_bytes) ? true : false;
+    }
+    inout_instance->nof_response_bytes += nof_bytes;
+    response[inout_instance->nof_response_bytes] = '\0';
+
+    // Complete with the end of the status line
+    const char* const status_line = strstr(response, LOADGEN_STATUS_MARKER);
+    return ((NULL != status_line) && (NULL != strchr(status_line, '\n'))) ? true : false;
+}
+
+static void prv_check_answer(loadgen_instance_t* const inout_instance, uint64_t in_now_ns)
+{
+    loadgen_mix_entry_t* const entry = &g_mix[inout_instance->idx_entry];
+    const char* const response = inout_instance->response;
+    const size_t nof_bytes = inout_instance->nof_response_bytes;
+
+    inout_instance->is_waiting = false;
+    g_nof_lines++;
+    entry->nof_lines++;
+
+    if (NULL == entry->reference)
+    {
+        entry->reference = malloc(nof_bytes);
+        if (NULL != entry->reference)
+        {
+            memcpy(entry->reference, response, nof_bytes);
+            entry->nof_reference_bytes = nof_bytes;
+        }
+    }
+    else if ((nof_bytes != entry->nof_reference_bytes) || (0 != memcmp(response, entry->reference, nof_bytes)))
+    {
+        if (0 == g_nof_corrupted_lines)
+        {
+            printf("Corrupted answer to \"%s\"\n  expected: ", entry->line);
+            prv_write_escaped(entry->reference, entry->nof_reference_bytes);
+            printf("\n  received: ");
+            prv_write_escaped(response, nof_bytes);
+            printf("\n");
+        }
+        g_nof_corrupted_lines++;
+        entry->nof_corrupted_lines++;
+    }
+
+    if (false == inout_instance->is_warm)
+    {
+        inout_instance->is_warm = true;
+        return;
+    }
+    const uint64_t latency_ns = in_now_ns - inout_instance->sent_ns;
+    const uint64_t idx_bucket = latency_ns / LOADGEN_LATENCY_BUCKET_NS;
+    g_latency_buckets[(idx_bucket < LOADGEN_NOF_LATENCY_BUCKETS) ? idx_bucket : (LOADGEN_NOF_LATENCY_BUCKETS - 1)]++;
+    g_nof_latency_samples++;
+    g_max_latency_ns = (latency_ns > g_max_latency_ns) ? latency_ns : g_max_latency_ns;
+}
+
+static void prv_write_escaped(const char* const in_data, size_t in_len)
+{
+    for (size_t i = 0; i < in_len; i++)
+    {
+        const unsigned char c = (unsigned char)in_data[i];
+        if ((c >= 0x20) && (c < 0x7F))
+        {
+            putchar(c);
+        }
+        else
+        {
+            printf("\\x%02X", c);
+        }
+    }
+}
+
+static uint64_t prv_percentile_ns(double in_fraction)
+{
+    const uint64_t rank = (uint64_t)(in_fraction * (double)g_nof_latency_samples);
+    uint64_t nof_samples = 0;
+    for (size_t i = 0; i < LOADGEN_NOF_LATENCY_BUCKETS; i++)
+    {
+        nof_samples += g_latency_buckets[i];
+        if (nof_samples > rank)
+        {
+            // Upper edge of the bucket
+            return (uint64_t)(i + 1) * LOADGEN_LATENCY_BUCKET_NS;
+        }
+    }
+    return g_max_latency_ns;
+}
+
+static void prv_print_report(double in_elapsed_s)
+{
+    const double lines_per_s = (double)g_nof_lines / in_elapsed_s;
+
+    printf("\n%llu lines in %.2f s: %.0f lines/s, %.2f M lines/min\n", (unsigned long long)g_nof_lines, in_elapsed_s,
+           lines_per_s, lines_per_s * 60.0 / 1e6);
+    if (g_nof_latency_samples > 0)
+    {
+        printf("latency [us]: p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n", (double)prv_percentile_ns(0.5) / 1e3,
+               (double)prv_percentile_ns(0.99) / 1e3, (double)prv_percentile_ns(0.999) / 1e3,
+               (double)g_max_latency_ns / 1e3);
+    }
+    printf("%-32s | %12s | %10s\n", "line", "answers", "corrupted");
+    for (size_t i = 0; i < g_nof_mix_entries; i++)
+    {
+        printf("%-32.32s | %12llu | %10llu\n", g_mix[i].line, (unsigned long long)g_mix[i].nof_lines,
+               (unsigned long long)g_mix[i].nof_corrupted_lines);
+        free(g_mix[i].reference);
+    }
+    printf("corrupted answers: %llu\n", (unsigned long long)g_nof_corrupted_lines);
+}
+
+static const char* prv_find_option_value(int argc, char* argv[], const char* const in_option)
+{
+    for (int i = 1; i < (argc - 1); i++)
+    {
+        if (0 == strcmp(argv[i], in_option))
+        {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+static uint64_t prv_clock_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+#
+# Builds the cli once per feature profile (see src/cli_config.h) and prints flash, RAM and cost per character.
+#
+#   flash      text + data of Cli.o, built with $TARGET_CC $TARGET_CFLAGS (defaults: the host compiler, -Os)
+#   cfg RAM    sizeof(cli_cfg_t) - the object the application owns
+#   cycles/ns  per received character of typed command lines, measured on the host by bench_profile.c
+#
+# Usage: example/profile_matrix.sh [repo root]
+# Environment: CC, TARGET_CC, TARGET_CFLAGS, SIZE, ASSERT_DIR (directory of custom_assert.c / .h)
+#
+# For a cross build, e.g.:
+#   TARGET_CC=arm-none-eabi-gcc TARGET_CFLAGS="-Os -mcpu=cortex-m4 -mthumb" SIZE=arm-none-eabi-size \
+#       example/profile_matrix.sh
+
+set -euo pipefail
+
+ROOT=${1:-$(cd "$(dirname "$0")/.." && pwd)}
+CC=${CC:-cc}
+TARGET_CC=${TARGET_CC:-$CC}
+TARGET_CFLAGS=${TARGET_CFLAGS:--Os}
+SIZE=${SIZE:-size}
+ASSERT_DIR=${ASSERT_DIR:-$ROOT/utils/embedded_utils/utils}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+MINIMAL="-DCLI_FEATURE_AUTOCOMPLETE=0 -DCLI_FEATURE_HELP=0 -DCLI_FEATURE_COLOR=0 -DCLI_FEATURE_DECORATION=0"
+MINIMAL="$MINIMAL -DCLI_FEATURE_PRINT_FORMATTER=0 -DCLI_FEATURE_UNREGISTER=0"
+MINIMAL="$MINIMAL -DCLI_FEATURE_STRUCTURED_OUTPUT=0 -DCLI_INTEGRITY_TIER=0"
+
+PROFILES=(
+    "full|"
+    "no-autocomplete|-DCLI_FEATURE_AUTOCOMPLETE=0"
+    "no-help|-DCLI_FEATURE_HELP=0"
+    "plain|-DCLI_FEATURE_COLOR=0 -DCLI_FEATURE_DECORATION=0"
+    "no-formatter|-DCLI_FEATURE_PRINT_FORMATTER=0"
+    "no-unregister|-DCLI_FEATURE_UNREGISTER=0"
+    "no-structured|-DCLI_FEATURE_STRUCTURED_OUTPUT=0"
+    "integrity-api|-DCLI_INTEGRITY_TIER=1"
+    "integrity-off|-DCLI_INTEGRITY_TIER=0"
+    "minimal|$MINIMAL"
+)
+
+INCLUDES="-I$ROOT/src -I$ASSERT_DIR"
+
+printf "%-16s | %10s | %10s | %11s | %9s\n" "profile" "flash [B]" "cfg [B]" "cycles/char" "ns/char"
+printf -- "-----------------+------------+------------+-------------+----------\n"
+for entry in "${PROFILES[@]}"; do
+    name=${entry%%|*}
+    defs=${entry#*|}
+
+    # shellcheck disable=SC2086 # word splitting of the flag lists is intended
+    "$TARGET_CC" $TARGET_CFLAGS $defs $INCLUDES -c "$ROOT/src/Cli.c" -o "$OUT/$name.o"
+    flash=$("$SIZE" "$OUT/$name.o" | awk 'NR == 2 { print $1 + $2 }')
+
+    # shellcheck disable=SC2086
+    "$CC" -std=c99 -O2 $defs $INCLUDES "$ROOT/example/bench_profile.c" "$ROOT"/src/*.c "$ASSERT_DIR"/*.c \
+        -o "$OUT/$name"
+    row=$("$OUT/$name" "$name")
+
+    # bench_profile prints "name | cfg | cycles | ns" - splice the flash column in after the name
+    printf "%-16s | %10s | %s\n" "$name" "$flash" "${row#*| }"
+done
@@ -27,7 +27,10 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
+#if (0 != CLI_FEATURE_PRINT_FORMATTER)
 #include <stdio.h>
+#endif
+#include <stdlib.h>
 #include <string.h>
 
 #include "custom_assert.h"
@@ -37,14 +40,114 @@
  * # Defines
  * ###########################################################################*/
 
-#define CLI_MAX_NOF_ARGUMENTS (16)
 #define CLI_PROMPT            "> "
 #define CLI_PROMPT_SPACER     '='
 #define CLI_SECTION_SPACER    '-'
 #define CLI_OUTPUT_WIDTH      50
 #define CLI_CANARY            (0xA5A5A5A5U)
+#if (0 != CLI_FEATURE_COLOR)
 #define CLI_OK_PROMPT         "\033[32m[OK]  \033[0m "
 #define CLI_FAIL_PROMPT       "\033[31m[FAIL]\033[0m "
+#endif
+#define CLI_OK_PROMPT_PLAIN   "[OK]   "
+#define CLI_FAIL_PROMPT_PLAIN "[FAIL] "
+#define CLI_CSI               "\033["
+#define CLI_MIN_REP_LENGTH    (6) // below this a CSI REP sequence is not shorter than the plain characters
+#define CLI_HELP_INDENT       (14)
+#define CLI_HELP_COMPACT_FLAG "-c"
+#define CLI_NOF_HELP_ENTRIES_PER_CALL (4)
+#define CLI_AUTOCOMPLETE_CHUNK_SIZE   (16)
+#define CLI_ALIAS_CMD_SEPARATOR       ";"
+#define CLI_ALIAS_DEFINE_TOKEN        "="
+#define CLI_ALIAS_APPEND_TOKEN        "+="
+#define CLI_VARIABLE_PREFIX           '$'
+#define CLI_PIPELINE_SEPARATOR        "|"
+
+#define CLI_TRANSFER_STX              (0x02U) // starts a raw frame
+#define CLI_TRANSFER_CAN              (0x18U) // aborts a transfer
+#define CLI_TRANSFER_HEADER_SIZE      (3)     // seq (2) and length (1)
+#define CLI_TRANSFER_CRC_SIZE         (2)
+#define CLI_NO_JOB                    ((uint8_t)CLI_MAX_NOF_JOBS) // end of a wheel slot list
+#define CLI_STACK_PAINT_PATTERN       (0xA5U) // bytes of the painted stack area that no handler reached
+
+#if (0 != (CLI_WHEEL_SIZE & (CLI_WHEEL_SIZE - 1)))
+#error "CLI_WHEEL_SIZE must be a power of two"
+#endif
+
+#if (CLI_MAX_NOF_JOBS > 254)
+#error "CLI_MAX_NOF_JOBS must fit into the uint8_t job indices"
+#endif
+
+#if (0 != (CLI_LOG_QUEUE_DEPTH & (CLI_LOG_QUEUE_DEPTH - 1)))
+#error "CLI_LOG_QUEUE_DEPTH must be a power of two"
+#endif
+
+#if !defined(CLI_SIZE_TYPE_MAX)
+#error "CLI_SIZE_TYPE_MAX must be defined together with CLI_SIZE_TYPE"
+#endif
+
+#if ((CLI_MAX_NOF_CALLBACKS + 1) > CLI_SIZE_TYPE_MAX)
+#error "CLI_MAX_NOF_CALLBACKS + 1 must fit into CLI_SIZE_TYPE - the index stores binding idx + 1"
+#endif
+
+#if (CLI_CMD_INDEX_SIZE > CLI_SIZE_TYPE_MAX)
+#error "CLI_CMD_INDEX_SIZE must fit into CLI_SIZE_TYPE - use a larger CLI_SIZE_TYPE"
+#endif
+
+#if (CLI_MAX_RX_BUFFER_SIZE > CLI_SIZE_TYPE_MAX)
+#error "CLI_MAX_RX_BUFFER_SIZE must fit into CLI_SIZE_TYPE"
+#endif
+
+#if (CLI_ALIAS_ARENA_SIZE > CLI_SIZE_TYPE_MAX)
+#error "CLI_ALIAS_ARENA_SIZE must fit into CLI_SIZE_TYPE - the alias offsets and lengths are cli_size_t"
+#endif
+
+#if (CLI_TYPEAHEAD_SIZE < 1) || (CLI_TYPEAHEAD_SIZE > 255)
+#error "CLI_TYPEAHEAD_SIZE must be 1 to 255 - the number of queued characters is a uint8_t"
+#endif
+
+#if defined(CLI_ENABLE_COST_COUNTERS)
+#define CLI_ADD_COST(counter, amount) (g_cli_cost_counters.counter += (uint32_t)(amount))
+#else
+#define CLI_ADD_COST(counter, amount) ((void)0)
+#endif
+
+/* #############################################################################
+ * # Types
+ * ###########################################################################*/
+
+// Steps a received line goes through - one step is the smallest unit of work cli_process_budget can do
+typedef enum
+{
+    CLI_PROCESS_STATE_IDLE = 0,
+    CLI_PROCESS_STATE_TOKENIZE,
+    CLI_PROCESS_STATE_HEADER,
+    CLI_PROCESS_STATE_DISPATCH,
+    CLI_PROCESS_STATE_FOOTER,
+    CLI_PROCESS_STATE_DONE,
+} cli_process_state_t;
+
+typedef enum
+{
+    CLI_TRANSFER_STATE_OFF = 0,
+    CLI_TRANSFER_STATE_PENDING,   // requested by the handler, starts when its line is finished
+    CLI_TRANSFER_STATE_WAIT_FRAME, // between raw frames / base64 lines
+    CLI_TRANSFER_STATE_IN_FRAME,
+} cli_transfer_state_t;
+
+typedef enum
+{
+    CLI_OFFLOAD_STATE_FREE = 0,
+    CLI_OFFLOAD_STATE_RUNNING, // owned by the executor
+    CLI_OFFLOAD_STATE_DONE,    // output and status wait for cli_process
+} cli_offload_state_t;
+
+typedef enum
+{
+    CLI_FILTER_GREP = 0,
+    CLI_FILTER_HEAD,
+    CLI_FILTER_COUNT,
+} cli_filter_kind_t;
 
 /* #############################################################################
  * # static variables
@@ -52,6 +155,14 @@
 
 static cli_cfg_t* g_cli_cfg_reference = NULL;
 
+#if defined(CLI_ENABLE_COST_COUNTERS)
+static cli_cost_counters_t g_cli_cost_counters;
+#endif
+
+#if defined(CLI_ENABLE_EXECUTOR)
+static __thread cli_offload_t* g_cli_worker_offload = NULL; // set while a worker runs an offloaded handler
+#endif
+
 /* #############################################################################
  * # static function prototypes
  * ###########################################################################*/
@@ -59,26 +170,142 @@ static cli_cfg_t* g_cli_cfg_reference = NULL;
 static void prv_write_string(const char* str);
 static void prv_write_char(char in_char);
 static void prv_put_char(char in_char);
+static void prv_emit_char(char in_char);
+static void prv_write_const_string(const char* in_string);
+static void prv_append_tx_iovec(const char* in_base, size_t in_len);
+static void prv_flush_tx(void);
 static void prv_write_cli_prompt(void);
 static void prv_write_cmd_unknown(const char* const in_cmd_name);
 static void prv_plot_lines(char in_char, int length);
 static void prv_clear_screen(void);
+static void prv_write_uint(uint32_t in_value);
+static uint8_t prv_format_uint(uint32_t in_value, char* const out_digits);
+#if (0 != CLI_FEATURE_DECORATION) || (0 != CLI_FEATURE_HELP) // rulers and the help indent
+static void prv_write_repeated_char(char in_char, int in_count);
+#endif
+static void prv_erase_chars(cli_size_t in_nof_chars);
+static bool prv_has_terminal_cap(uint8_t in_terminal_cap);
+static bool prv_is_output_decorated(void);
 
 static void prv_reset_rx_buffer(void);
 static bool prv_is_rx_buffer_full(void);
 static char prv_get_last_recv_char_from_rx_buffer(void);
 
 static const cli_binding_t* prv_find_cmd(const char* const in_cmd_name);
-static uint8_t prv_get_args_from_rx_buffer(char* array_of_arguments[], uint8_t max_arguments);
+static const cli_binding_t* prv_get_binding(cli_size_t in_idx);
+static cli_size_t prv_get_nof_bindings(void);
+static uint32_t prv_hash_name(const char* const in_name);
+static cli_size_t prv_hash_cmd_name(const char* const in_cmd_name);
+static cli_size_t prv_find_registry_slot(const cli_registry_t* const in_registry, const char* const in_cmd_name);
+static cli_size_t* prv_find_cmd_index_slot(const char* const in_cmd_name);
+#if (0 != CLI_FEATURE_UNREGISTER)
+static void prv_remove_cmd_index_slot(cli_size_t* const inout_slot);
+#endif
+static uint8_t prv_get_args_from_rx_tokens(char* array_of_arguments[], uint8_t max_arguments);
+static bool prv_is_token_delimiter(char in_char);
+static bool prv_advance_rx_tokens(cli_rx_tokens_t* const inout_tokens, const char* const in_rx, cli_size_t in_idx);
+static void prv_resolve_rx_cmd(cli_size_t in_delimiter_idx);
+static void prv_scan_rx_char(void);
+static void prv_unscan_rx_char(char in_deleted_char);
+static void prv_rescan_rx_buffer(void);
+#if (0 != CLI_FEATURE_AUTOCOMPLETE)
 STATIC void prv_find_matching_strings(const char* in_partial_string, const char* const in_string_array[],
-                                      uint8_t in_nof_strings, const char* out_matches_array[],
-                                      uint8_t* out_nof_matches);
-static bool prv_is_char_in_string(char character, const char* in_string, uint8_t string_length);
+                                      cli_size_t in_nof_strings, const char* out_matches_array[],
+                                      cli_size_t* out_nof_matches);
+static bool prv_is_char_in_string(char character, const char* in_string, cli_size_t string_length);
 static void prv_autocomplete_command(void);
+static void prv_autocomplete_argument(void);
+static void prv_list_completions(const cli_binding_t* const in_binding, int in_arg_idx, const char* const in_prefix);
+#endif
 
+#if (0 != CLI_FEATURE_HELP)
 static int prv_cmd_handler_help(int argc, char* argv[], void* context);
+#endif
+static int prv_cmd_handler_alias(int argc, char* argv[], void* context);
+static int prv_cmd_handler_set(int argc, char* argv[], void* context);
+
+static cli_alias_t* prv_find_alias(const char* const in_name, bool in_is_variable);
+static bool prv_add_alias(const char* const in_name, char* in_tokens[], int in_nof_tokens, bool in_is_variable);
+static bool prv_append_to_alias(cli_alias_t* const inout_alias, char* in_tokens[], int in_nof_tokens);
+static void prv_remove_alias(cli_alias_t* const inout_alias);
+static void prv_release_arena_chars(cli_size_t in_offset, cli_size_t in_length);
+static void prv_write_aliases(bool in_is_variable);
+static bool prv_load_next_alias_cmd(void);
+static char* prv_expand_variable(char* const in_arg);
+
+static int prv_cmd_handler_watch(int argc, char* argv[], void* context);
+static int prv_cmd_handler_jobs(int argc, char* argv[], void* context);
+static int prv_cmd_handler_kill(int argc, char* argv[], void* context);
+static int prv_cmd_handler_stats(int argc, char* argv[], void* context);
+static void prv_write_stat(const char* const in_name, uint32_t in_value, uint32_t in_limit);
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+static int prv_cmd_handler_output(int argc, char* argv[], void* context);
+#endif
+static void prv_insert_job(uint8_t in_job_idx);
+static void prv_unlink_job(uint8_t in_job_idx);
+static void prv_advance_wheel(void);
+static bool prv_start_ready_job(void);
+static void prv_load_job_args(cli_job_t* const inout_job);
+
+static void prv_begin_transfer(void);
+static void prv_receive_transfer_char(char in_char);
+static void prv_receive_base64_char(char in_char);
+static void prv_add_frame_byte(uint8_t in_byte);
+static void prv_check_frame(void);
+static void prv_end_transfer(int in_status);
+static void prv_write_transfer_reply(const char* const in_reply, uint32_t in_value);
+STATIC uint16_t prv_crc16(const uint8_t* in_data, size_t in_len);
+
+static void prv_split_pipeline(void);
+static void prv_filter_char(char in_char);
+static void prv_filter_line(uint8_t in_first_filter, const char* const in_line, cli_size_t in_length);
+static void prv_finish_filters(void);
+static bool prv_is_filter_output_closed(void);
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+static bool prv_out_begin_item(const char* const in_key, bool in_is_container);
+static void prv_out_end_item(void);
+static void prv_out_open(const char* const in_key, bool in_is_array);
+static void prv_out_close(bool in_is_array);
+static void prv_out_close_all(void);
+static void prv_out_write_hex(uint32_t in_value);
+static void prv_out_write_json_string(const char* const in_string);
+static void prv_out_write_cbor_head(uint8_t in_major_type, uint32_t in_value);
+static void prv_out_write_cbor_string(const char* const in_string);
+static void prv_put_raw_byte(uint8_t in_byte);
+#endif
+
+static bool prv_process_step(void);
+static bool prv_is_line_pending(void);
+static bool prv_is_line_ready(void);
+static void prv_write_cmd_footer(int in_status);
+static void prv_receive_char(char in_char);
+static void prv_queue_typeahead_char(char in_char);
+static void prv_replay_typeahead(void);
+static void prv_stream_arg(void);
+static void prv_write_cmd_feedback(void);
+static void prv_pump_transport_input(void);
+static void prv_drain_log_queue(void);
+static void prv_write_log_message(const char* const in_message, bool* const inout_is_input_line_erased);
+static void prv_erase_input_line(void);
+static void prv_restore_input_line(void);
+
+#if defined(CLI_ENABLE_EXECUTOR)
+static bool prv_is_line_offloaded(void);
+static bool prv_submit_offload(void);
+static void prv_finish_offloads(void);
+static void prv_print_to_offload(cli_offload_t* const inout_offload, const char* const fmt, va_list args);
+#endif
+
+#if defined(CLI_ENABLE_STACK_PAINTING)
+static uint32_t prv_paint_stack(bool in_is_painting);
+#endif
 
+static void prv_verify_api_integrity(const cli_cfg_t* const in_ptCfg);
 static void prv_verify_object_integrity(const cli_cfg_t* const in_ptCfg);
+#if (CLI_INTEGRITY_TIER > 0)
+static void prv_check_object_integrity(const cli_cfg_t* const in_ptCfg);
+#endif
 
 /* #############################################################################
  * # global function implementations
@@ -97,17 +324,73 @@ void cli_init(cli_cfg_t* const inout_module_cfg, cli_put_char_fn in_put_char_fn)
     inout_module_cfg->end_canary_word = CLI_CANARY;
     inout_module_cfg->mid_canary_word = CLI_CANARY;
     inout_module_cfg->put_char_fn = in_put_char_fn;
+    inout_module_cfg->terminal_caps = CLI_TERM_CAP_ANSI;
     inout_module_cfg->nof_stored_chars_in_rx_buffer = 0;
+    memset(&inout_module_cfg->rx_tokens, 0, sizeof(inout_module_cfg->rx_tokens));
+    inout_module_cfg->nof_typeahead_chars = 0;
+    inout_module_cfg->stream_binding = NULL;
+    inout_module_cfg->stream_token_start = 0;
+    inout_module_cfg->nof_streamed_args = 0;
+    inout_module_cfg->registry = NULL;
     inout_module_cfg->nof_stored_cmd_bindings = 0;
+    memset(inout_module_cfg->cmd_index, 0, sizeof(inout_module_cfg->cmd_index));
+    inout_module_cfg->clock_fn = NULL;
+    inout_module_cfg->line_fn = NULL;
+    inout_module_cfg->line_context = NULL;
+    inout_module_cfg->transport = NULL;
+    inout_module_cfg->nof_stored_chars_in_tx_buffer = 0;
+    inout_module_cfg->nof_tx_iovecs = 0;
+    inout_module_cfg->nof_pending_transport_chars = 0;
+    inout_module_cfg->idx_next_transport_char = 0;
+    inout_module_cfg->process_state = CLI_PROCESS_STATE_IDLE;
+    inout_module_cfg->cmd_binding = NULL;
+    inout_module_cfg->active_alias = 0;
+    inout_module_cfg->nof_filters = 0;
+    inout_module_cfg->is_output_filtered = false;
+    inout_module_cfg->active_job = 0;
+    inout_module_cfg->capture_buffer = NULL;
+    inout_module_cfg->transfer_state = CLI_TRANSFER_STATE_OFF;
+    memset(inout_module_cfg->jobs, 0, sizeof(inout_module_cfg->jobs));
+    memset(inout_module_cfg->wheel, CLI_NO_JOB, sizeof(inout_module_cfg->wheel));
+    inout_module_cfg->is_wheel_started = false;
+    inout_module_cfg->current_tick = 0;
+    inout_module_cfg->last_tick_ms = 0;
+    inout_module_cfg->invalid_filter = NULL;
+    inout_module_cfg->bindings_generation = 0;
+    inout_module_cfg->nof_aliases = 0;
+    inout_module_cfg->nof_used_arena_chars = 0;
+    for (uint32_t i = 0; i < CLI_LOG_QUEUE_DEPTH; i++)
+    {
+        inout_module_cfg->log_slots[i].sequence = i;
+    }
+    inout_module_cfg->log_enqueue_pos = 0;
+    inout_module_cfg->log_dequeue_pos = 0;
+#if defined(CLI_ENABLE_EXECUTOR)
+    inout_module_cfg->executor = NULL;
+    inout_module_cfg->oldest_offload = 0;
+    inout_module_cfg->nof_offloads = 0;
+    memset(inout_module_cfg->offloads, 0, sizeof(inout_module_cfg->offloads));
+#endif
+    inout_module_cfg->nof_dropped_logs = 0;
+    memset(&inout_module_cfg->stats, 0, sizeof(inout_module_cfg->stats));
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+    inout_module_cfg->output_mode = CLI_OUTPUT_MODE_TEXT;
+    inout_module_cfg->out_depth = 0;
+    inout_module_cfg->out_array_levels = 0;
+    inout_module_cfg->out_filled_levels = 0;
+#endif
 
     // Store the config locally in a static variable
     g_cli_cfg_reference = inout_module_cfg;
 
     g_cli_cfg_reference->is_initialized = true;
 
+#if (0 != CLI_FEATURE_HELP)
     // Register the default commands
-    cli_binding_t help_cmd_binding = {"help", prv_cmd_handler_help, NULL, "List all commands"};
+    cli_binding_t help_cmd_binding = {"help", prv_cmd_handler_help, NULL, "List all commands - help [-c] [prefix]",
+                                      NULL, NULL};
     cli_register(&help_cmd_binding);
+#endif
 
     // reset the cli
     prv_clear_screen();
@@ -115,123 +398,405 @@ void cli_init(cli_cfg_t* const inout_module_cfg, cli_put_char_fn in_put_char_fn)
     // Print the prompt
     prv_write_cli_prompt();
 
+    prv_flush_tx();
+
     return;
 }
 
 void cli_receive(char in_char)
 {
-    prv_verify_object_integrity(g_cli_cfg_reference);
+    prv_verify_api_integrity(g_cli_cfg_reference);
 
-    if (true == prv_is_rx_buffer_full())
+    // Only looked at with a callback - the per character cost stays the same without
+    const cli_line_fn line_fn = g_cli_cfg_reference->line_fn;
+    const bool was_line_pending = (NULL != line_fn) && (true == prv_is_line_pending());
+
+    prv_receive_char(in_char);
+
+    // send the echo
+    prv_flush_tx();
+
+    if ((NULL != line_fn) && (false == was_line_pending) && (true == prv_is_line_pending()))
     {
-        // Buffer full - ignore the character
-        prv_write_string("Buffer is full\n");
+        line_fn(g_cli_cfg_reference->line_context);
+    }
+}
 
-        // Reset the buffer to avoid overflows
-        prv_reset_rx_buffer();
+void cli_process()
+{
+    prv_verify_api_integrity(g_cli_cfg_reference);
 
-        return;
+    // Run all steps of the pending line (if any) back to back
+    while (true == prv_process_step())
+    {
     }
 
-    switch (in_char)
+    prv_flush_tx();
+}
+
+bool cli_process_budget(uint32_t in_max_us)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_clock_fn clock_fn = g_cli_cfg_reference->clock_fn;
+
+    if (NULL == clock_fn)
     {
-        case 0x7F: // DEL
-        case '\b': // Backspace
-        {
-            bool rx_buffer_has_chars = (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > 0);
+        // Without a clock the budget cannot be measured - do the smallest amount of work possible
+        bool is_work_pending = prv_process_step();
+        prv_flush_tx();
+        return is_work_pending;
+    }
 
-            // Only delete characters, when there are characters in the buffer.
-            if (true == rx_buffer_has_chars)
-            {
-                g_cli_cfg_reference->nof_stored_chars_in_rx_buffer--;
-                uint8_t idx = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+    const uint32_t start_us = clock_fn();
+    bool is_work_pending = true;
 
-                // Remove the last character (the one that was deleted)
-                // Replace it with a null character
-                g_cli_cfg_reference->rx_char_buffer[idx] = '\0';
+    // At least one step is done per call, so that the line is processed eventually
+    do
+    {
+        is_work_pending = prv_process_step();
+    } while ((true == is_work_pending) && ((uint32_t)(clock_fn() - start_us) < in_max_us));
 
-                // Remove character from cli
-                prv_write_char('\b');
-            }
-            break;
-        }
-        case '\t': // Tab
+    prv_flush_tx();
+
+    return is_work_pending;
+}
+
+void cli_set_transport(const cli_transport_t* in_transport)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT((NULL == in_transport) || (NULL != in_transport->read));
+        ASSERT((NULL == in_transport) || (NULL != in_transport->writev));
+    }
+
+    // Everything that was gathered so far belongs to the previous output
+    prv_flush_tx();
+
+    g_cli_cfg_reference->transport = in_transport;
+    g_cli_cfg_reference->nof_pending_transport_chars = 0;
+    g_cli_cfg_reference->idx_next_transport_char = 0;
+}
+
+void cli_set_clock(cli_clock_fn in_clock_fn)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    g_cli_cfg_reference->clock_fn = in_clock_fn;
+}
+
+uint8_t cli_poll(uint32_t* const out_next_deadline_ms)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_transport_t* const transport = cfg->transport;
+    uint8_t work = 0;
+
+    if (true == prv_is_line_ready())
+    {
+        work |= CLI_WORK_LINE_READY;
+    }
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    if (cfg->nof_offloads > 0)
+    {
+        const cli_offload_t* const oldest_offload = &cfg->offloads[cfg->oldest_offload];
+        const bool is_done = (CLI_OFFLOAD_STATE_DONE == __atomic_load_n(&oldest_offload->state, __ATOMIC_ACQUIRE));
+        work |= (true == is_done) ? CLI_WORK_OUTPUT_PENDING : CLI_WORK_OFFLOAD_RUNNING;
+    }
+#endif
+
+    // Only the consumer moves the dequeue position - a published slot at that position means queued logs
+    const cli_log_slot_t* const slot = &cfg->log_slots[cfg->log_dequeue_pos % CLI_LOG_QUEUE_DEPTH];
+    if (((int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - (cfg->log_dequeue_pos + 1)) >= 0)
+        || (__atomic_load_n(&cfg->nof_dropped_logs, __ATOMIC_RELAXED) > 0) || (cfg->nof_tx_iovecs > 0))
+    {
+        work |= CLI_WORK_OUTPUT_PENDING;
+    }
+
+    if ((NULL != transport)
+        && ((cfg->idx_next_transport_char < cfg->nof_pending_transport_chars)
+            || ((NULL != transport->poll_ready) && (true == transport->poll_ready(transport->context)))))
+    {
+        work |= CLI_WORK_INPUT_PENDING;
+    }
+    if ((cfg->nof_typeahead_chars > 0) && (false == prv_is_line_pending()))
+    {
+        // The line the characters waited for is done - they are received with the next cli_process
+        work |= CLI_WORK_INPUT_PENDING;
+    }
+
+    // Few jobs - a scan is cheaper than keeping the earliest expiry up to date in the wheel
+    uint32_t min_nof_ticks_to_go = UINT32_MAX;
+    for (uint8_t job_idx = 0; job_idx < CLI_MAX_NOF_JOBS; job_idx++)
+    {
+        const cli_job_t* const job = &cfg->jobs[job_idx];
+        if (false == job->is_used)
         {
-            // autocomplete the currently incomplete command (if possible)
-            prv_autocomplete_command();
-            break;
+            continue;
         }
-        case '\r': // Carriage Return
+        if (true == job->is_ready)
         {
-            // Convert CR to LF to handle Enter key from terminal programs
-            in_char = '\n';
-            // Fall through to default case to process as normal character
-            __attribute__((fallthrough));
+            work |= CLI_WORK_JOB_DUE;
         }
-        default:
+        const uint32_t nof_ticks_to_go = job->expiry_tick - cfg->current_tick;
+        min_nof_ticks_to_go = (nof_ticks_to_go < min_nof_ticks_to_go) ? nof_ticks_to_go : min_nof_ticks_to_go;
+    }
+
+    if (UINT32_MAX != min_nof_ticks_to_go)
+    {
+        work |= CLI_WORK_JOB_SCHEDULED;
+        if (NULL != out_next_deadline_ms)
         {
-            // Add the character to the buffer
-            uint8_t idx = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
-            g_cli_cfg_reference->rx_char_buffer[idx] = in_char;
-            g_cli_cfg_reference->nof_stored_chars_in_rx_buffer++;
+            *out_next_deadline_ms = cfg->last_tick_ms + (min_nof_ticks_to_go * CLI_WHEEL_TICK_MS);
+        }
+    }
 
-            prv_verify_object_integrity(g_cli_cfg_reference);
+    return work;
+}
 
-            // write the character back out to the console
-            prv_write_char(in_char);
+void cli_set_line_callback(cli_line_fn in_line_fn, void* in_context)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    g_cli_cfg_reference->line_fn = in_line_fn;
+    g_cli_cfg_reference->line_context = in_context;
+}
 
-            break;
+#if defined(CLI_ENABLE_EXECUTOR)
+void cli_set_executor(const cli_executor_t* in_executor)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT((NULL == in_executor) || (NULL != in_executor->is_offloaded));
+        ASSERT((NULL == in_executor) || (NULL != in_executor->submit));
+        ASSERT(0 == g_cli_cfg_reference->nof_offloads);
+    }
+    g_cli_cfg_reference->executor = in_executor;
+}
+
+void cli_run_offload(cli_offload_t* const inout_offload)
+{
+    { // Input Checks
+        // Runs on a worker - the cfg belongs to the thread of cli_process and is not looked at
+        ASSERT(inout_offload);
+        ASSERT(CLI_OFFLOAD_STATE_RUNNING == inout_offload->state);
+        ASSERT(inout_offload->cmd_fn);
+    }
+
+    // cli_print and cli_get_continuation_index of this thread refer to the offload now
+    g_cli_worker_offload = inout_offload;
+    do
+    {
+        inout_offload->status = inout_offload->cmd_fn(inout_offload->nof_args, inout_offload->args,
+                                                      inout_offload->context);
+        if (CLI_PENDING_STATUS == inout_offload->status)
+        {
+            inout_offload->nof_handler_calls++;
         }
+    } while (CLI_PENDING_STATUS == inout_offload->status);
+    g_cli_worker_offload = NULL;
+
+    // Hands the offload back - everything written above is visible to cli_process once it sees the new state
+    __atomic_store_n(&inout_offload->state, (uint8_t)CLI_OFFLOAD_STATE_DONE, __ATOMIC_RELEASE);
+}
+#endif
+
+void cli_receive_and_process(char in_char)
+{
+    cli_receive(in_char);
+    cli_process();
+}
+
+#if defined(CLI_ENABLE_COST_COUNTERS)
+void cli_get_cost_counters(cli_cost_counters_t* const out_counters)
+{
+    { // Input Checks
+        ASSERT(out_counters);
     }
+    *out_counters = g_cli_cost_counters;
 }
 
-void cli_process()
+void cli_reset_cost_counters(void)
 {
-    char* argv[CLI_MAX_NOF_ARGUMENTS] = {0};
-    uint8_t argc = 0;
-    int cmd_status = CLI_FAIL_STATUS;
+    memset(&g_cli_cost_counters, 0, sizeof(g_cli_cost_counters));
+}
+#endif
 
-    prv_verify_object_integrity(g_cli_cfg_reference);
+void cli_get_stats(cli_stats_t* const out_stats)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(out_stats);
+    }
 
-    if ((prv_get_last_recv_char_from_rx_buffer() != '\n') && ((false == prv_is_rx_buffer_full())))
+    if (NULL == out_stats)
     {
-        // Do nothing, if these conditions are not met
         return;
     }
+    *out_stats = g_cli_cfg_reference->stats;
+
+    // Log lines dropped since the last cli_process call are not reported yet
+    out_stats->nof_dropped_logs += __atomic_load_n(&g_cli_cfg_reference->nof_dropped_logs, __ATOMIC_RELAXED);
+}
+
+void cli_reset_stats(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
 
-    argc = prv_get_args_from_rx_buffer(argv, CLI_MAX_NOF_ARGUMENTS);
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    memset(&cfg->stats, 0, sizeof(cfg->stats));
+    cfg->stats.max_nof_rx_chars = cfg->nof_stored_chars_in_rx_buffer;
+    cfg->stats.max_nof_bindings = cfg->nof_stored_cmd_bindings;
+}
+
+int cli_execute(const char* const in_line, char* const out_buffer, size_t in_capacity, size_t* const out_len)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(in_line);
+        ASSERT(out_buffer);
+        ASSERT(in_capacity > 0);
+        ASSERT(CLI_PROCESS_STATE_IDLE == g_cli_cfg_reference->process_state);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
 
-    if (argc >= 1)
+    if ((NULL == in_line) || (NULL == out_buffer) || (0 == in_capacity)
+        || (CLI_PROCESS_STATE_IDLE != cfg->process_state) || (strlen(in_line) >= CLI_MAX_RX_BUFFER_SIZE)
+        || (cfg->transfer_state >= CLI_TRANSFER_STATE_WAIT_FRAME))
     {
-        // plot a line on the console
-        prv_plot_lines(CLI_SECTION_SPACER, CLI_OUTPUT_WIDTH);
+        return CLI_FAIL_STATUS;
+    }
 
-        // call the command handler (if available)
-        const cli_binding_t* ptCmdBinding = prv_find_cmd(argv[0]);
-        if (NULL == ptCmdBinding)
+    // The line takes the place of the partial input - which is put back afterwards
+    char input_line[CLI_MAX_RX_BUFFER_SIZE];
+    const cli_size_t nof_input_chars = cfg->nof_stored_chars_in_rx_buffer;
+    const cli_binding_t* const stream_binding = cfg->stream_binding;
+    const cli_size_t stream_token_start = cfg->stream_token_start;
+    const uint16_t nof_streamed_args = cfg->nof_streamed_args;
+    const cli_rx_tokens_t input_tokens = cfg->rx_tokens;
+    memcpy(input_line, cfg->rx_char_buffer, CLI_MAX_RX_BUFFER_SIZE);
+
+    prv_reset_rx_buffer();
+    const size_t line_length = strlen(in_line);
+    memcpy(cfg->rx_char_buffer, in_line, line_length);
+    cfg->nof_stored_chars_in_rx_buffer = (cli_size_t)line_length;
+    prv_rescan_rx_buffer();
+
+    cfg->capture_buffer = out_buffer;
+    cfg->capture_capacity = in_capacity;
+    cfg->nof_captured_chars = 0;
+
+    cfg->process_state = CLI_PROCESS_STATE_TOKENIZE;
+    while (CLI_PROCESS_STATE_IDLE != cfg->process_state)
+    {
+        (void)prv_process_step();
+    }
+    const int status = cfg->cmd_status;
+
+    out_buffer[cfg->nof_captured_chars] = '\0';
+    if (NULL != out_len)
+    {
+        *out_len = cfg->nof_captured_chars;
+    }
+    cfg->capture_buffer = NULL;
+
+    memcpy(cfg->rx_char_buffer, input_line, CLI_MAX_RX_BUFFER_SIZE);
+    cfg->nof_stored_chars_in_rx_buffer = nof_input_chars;
+    cfg->rx_tokens = input_tokens;
+    cfg->stream_binding = stream_binding;
+    cfg->stream_token_start = stream_token_start;
+    cfg->nof_streamed_args = nof_streamed_args;
+
+    return status;
+}
+
+bool cli_registry_build(cli_registry_t* const out_registry, const cli_binding_t* in_bindings,
+                        cli_size_t in_nof_bindings, cli_size_t* const in_index, cli_size_t in_index_size)
+{
+    { // Input Checks
+        ASSERT(out_registry);
+        ASSERT(in_bindings);
+        ASSERT(in_index);
+        ASSERT(in_index_size > in_nof_bindings);
+    }
+
+    if ((NULL == out_registry) || (NULL == in_bindings) || (NULL == in_index) || (in_index_size <= in_nof_bindings))
+    {
+        return false;
+    }
+
+    out_registry->bindings = in_bindings;
+    out_registry->index = in_index;
+    out_registry->nof_bindings = in_nof_bindings;
+    out_registry->index_size = in_index_size;
+    out_registry->is_frozen = false;
+    memset(in_index, 0, (size_t)in_index_size * sizeof(cli_size_t));
+
+    for (cli_size_t idx = 0; idx < in_nof_bindings; idx++)
+    {
+        const cli_binding_t* const binding = &in_bindings[idx];
+        const bool is_valid = (NULL != binding->cmd_fn) && ('\0' != binding->name[0])
+                              && (NULL != memchr(binding->name, '\0', CLI_MAX_CMD_NAME_LENGTH));
+        ASSERT(true == is_valid);
+        if (false == is_valid)
         {
-            cmd_status = CLI_FAIL_STATUS;
-            prv_write_cmd_unknown(argv[0]);
+            return false;
         }
-        else
+
+        // The index is filled in place - nothing else can see the registry before it is frozen
+        const cli_size_t slot_idx = prv_find_registry_slot(out_registry, binding->name);
+        ASSERT(0 == in_index[slot_idx]); // the name is used twice
+        if (0 != in_index[slot_idx])
         {
-            cmd_status = ptCmdBinding->cmd_fn(argc, argv, ptCmdBinding->context);
+            return false;
         }
-
-        prv_plot_lines(CLI_SECTION_SPACER, CLI_OUTPUT_WIDTH);
-        prv_write_string("Status -> ");
-        prv_write_string((cmd_status == CLI_OK_STATUS) ? CLI_OK_PROMPT : CLI_FAIL_PROMPT);
-        prv_write_char('\n');
+        in_index[slot_idx] = (cli_size_t)(idx + 1);
     }
 
-    // Reset the cli buffer and write the prompt again for a new user input
-    prv_reset_rx_buffer();
+    out_registry->is_frozen = true;
+    return true;
 }
 
-void cli_receive_and_process(char in_char)
+void cli_set_registry(const cli_registry_t* const in_registry)
 {
-    cli_receive(in_char);
-    cli_process();
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT((NULL == in_registry) || (true == in_registry->is_frozen));
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if ((NULL != in_registry) && (true != in_registry->is_frozen))
+    {
+        return;
+    }
+
+    // A command of the overlay would be hidden by the registry
+    for (cli_size_t idx = 0; (NULL != in_registry) && (idx < cfg->nof_stored_cmd_bindings); idx++)
+    {
+        const cli_size_t slot_idx = prv_find_registry_slot(in_registry, cfg->cmd_bindings_buffer[idx].name);
+        ASSERT(0 == in_registry->index[slot_idx]);
+        if (0 != in_registry->index[slot_idx])
+        {
+            return;
+        }
+    }
+
+    cfg->registry = in_registry;
+
+    // Cached binding pointers (aliases, jobs, the typed line) are looked up again
+    cfg->bindings_generation++;
 }
 
 void cli_register(const cli_binding_t* const in_cmd_binding)
@@ -243,30 +808,34 @@ void cli_register(const cli_binding_t* const in_cmd_binding)
         ASSERT(in_cmd_binding->help);
         ASSERT(in_cmd_binding->cmd_fn);
 
-        prv_verify_object_integrity(g_cli_cfg_reference);
+        prv_verify_api_integrity(g_cli_cfg_reference);
     }
 
     uint8_t does_binding_exist = false;
     uint8_t is_binding_stored = false;
 
     // Check whether the binding is already present - it must not be
-    for (uint8_t i = 0; i < g_cli_cfg_reference->nof_stored_cmd_bindings; i++)
-    {
-        const cli_binding_t* cmd_binding = &g_cli_cfg_reference->cmd_bindings_buffer[i];
-        if (0 == strncmp(cmd_binding->name, in_cmd_binding->name, CLI_MAX_CMD_NAME_LENGTH))
-        {
-            does_binding_exist = true;
-            break;
-        }
-    }
+    does_binding_exist = (NULL != prv_find_cmd(in_cmd_binding->name)) ? true : false;
     ASSERT(false == does_binding_exist);
 
-    if (g_cli_cfg_reference->nof_stored_cmd_bindings < CLI_MAX_NOF_CALLBACKS)
+    if ((false == does_binding_exist) && (g_cli_cfg_reference->nof_stored_cmd_bindings < CLI_MAX_NOF_CALLBACKS))
     {
         //  Deep Copy the binding into the buffer
-        uint8_t idx = g_cli_cfg_reference->nof_stored_cmd_bindings;
+        cli_size_t idx = g_cli_cfg_reference->nof_stored_cmd_bindings;
         memcpy(&g_cli_cfg_reference->cmd_bindings_buffer[idx], in_cmd_binding, sizeof(cli_binding_t));
         g_cli_cfg_reference->nof_stored_cmd_bindings++;
+        if (g_cli_cfg_reference->nof_stored_cmd_bindings > g_cli_cfg_reference->stats.max_nof_bindings)
+        {
+            g_cli_cfg_reference->stats.max_nof_bindings = g_cli_cfg_reference->nof_stored_cmd_bindings;
+        }
+
+        // Make the binding findable by its name
+        cli_size_t* const slot = prv_find_cmd_index_slot(in_cmd_binding->name);
+        ASSERT(0 == *slot);
+        *slot = (cli_size_t)(idx + 1);
+
+        // A command may now exist, which an alias could not resolve before
+        g_cli_cfg_reference->bindings_generation++;
 
         // Mark that the binding was stored
         is_binding_stored = true;
@@ -280,6 +849,7 @@ void cli_register(const cli_binding_t* const in_cmd_binding)
     return;
 }
 
+#if (0 != CLI_FEATURE_UNREGISTER)
 void cli_unregister(const char* const in_cmd_name)
 {
     {
@@ -290,7 +860,7 @@ void cli_unregister(const char* const in_cmd_name)
 
         ASSERT(g_cli_cfg_reference->nof_stored_cmd_bindings > 0);
 
-        prv_verify_object_integrity(g_cli_cfg_reference);
+        prv_verify_api_integrity(g_cli_cfg_reference);
     }
 
     if ((NULL == in_cmd_name) || (0 == strlen(in_cmd_name)) || (strlen(in_cmd_name) >= CLI_MAX_CMD_NAME_LENGTH)
@@ -299,23 +869,32 @@ void cli_unregister(const char* const in_cmd_name)
         return;
     }
 
-    uint8_t is_binding_found = false;
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_size_t* const slot = prv_find_cmd_index_slot(in_cmd_name);
+    uint8_t is_binding_found = (0 != *slot) ? true : false;
 
-    for (uint8_t i = 0; i < g_cli_cfg_reference->nof_stored_cmd_bindings; i++)
+    if (true == is_binding_found)
     {
-        cli_binding_t* cmd_binding = &g_cli_cfg_reference->cmd_bindings_buffer[i];
-        if (0 == strncmp(cmd_binding->name, in_cmd_name, CLI_MAX_CMD_NAME_LENGTH))
+        const cli_size_t idx = (cli_size_t)(*slot - 1);
+        const cli_size_t idx_last = (cli_size_t)(cfg->nof_stored_cmd_bindings - 1);
+
+        prv_remove_cmd_index_slot(slot);
+
+        if (idx != idx_last)
         {
-            is_binding_found = true;
-            // Shift all following bindings one position to the left
-            for (uint8_t j = i; j < g_cli_cfg_reference->nof_stored_cmd_bindings - 1; j++)
-            {
-                memcpy(&g_cli_cfg_reference->cmd_bindings_buffer[j], &g_cli_cfg_reference->cmd_bindings_buffer[j + 1],
-                       sizeof(cli_binding_t));
-            }
-            g_cli_cfg_reference->nof_stored_cmd_bindings--;
-            break;
+            // Move the last binding into the gap instead of shifting all following bindings
+            memcpy(&cfg->cmd_bindings_buffer[idx], &cfg->cmd_bindings_buffer[idx_last], sizeof(cli_binding_t));
+            cli_size_t* const moved_slot = prv_find_cmd_index_slot(cfg->cmd_bindings_buffer[idx].name);
+            ASSERT((cli_size_t)(idx_last + 1) == *moved_slot);
+            *moved_slot = (cli_size_t)(idx + 1);
         }
+        cfg->nof_stored_cmd_bindings--;
+
+        // Binding pointers cached by aliases may point to the moved or removed binding now
+        cfg->bindings_generation++;
+
+        // The rest of the typed line is collected in the rx buffer instead of streamed to a stale binding
+        cfg->stream_binding = NULL;
     }
     ASSERT(true == is_binding_found);
 
@@ -323,234 +902,3522 @@ void cli_unregister(const char* const in_cmd_name)
 
     return;
 }
+#endif
 
 void cli_print(const char* fmt, ...)
 {
+#if defined(CLI_ENABLE_EXECUTOR)
+    if (NULL != g_cli_worker_offload)
+    {
+        // An offloaded handler - the cfg belongs to the thread of cli_process, the output goes to the offload
+        va_list offload_args;
+        va_start(offload_args, fmt);
+        prv_print_to_offload(g_cli_worker_offload, fmt, offload_args);
+        va_end(offload_args);
+        return;
+    }
+#endif
+
     { // Input Checks
-        prv_verify_object_integrity(g_cli_cfg_reference);
+        prv_verify_api_integrity(g_cli_cfg_reference);
         ASSERT(fmt);
     }
 
-    char buffer[128]; // Temporary buffer for formatted string
+#if (0 != CLI_FEATURE_PRINT_FORMATTER)
+    char buffer[CLI_PRINT_BUFFER_SIZE]; // Temporary buffer for formatted string
     va_list args;
     va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    const int length = vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
 
+    if (length >= (int)sizeof(buffer))
+    {
+        g_cli_cfg_reference->stats.nof_truncated_prints++;
+    }
+
     prv_write_string(buffer);
+#else
+    // Without the formatter the format string is the text - nothing is cut
+    prv_write_string(fmt);
+#endif
     prv_write_char('\n');
 }
 
-void cli_deinit(cli_cfg_t* const inout_module_cfg)
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+void cli_set_output_mode(uint8_t in_mode)
 {
     { // Input Checks
-        prv_verify_object_integrity(inout_module_cfg);
-        ASSERT(inout_module_cfg == g_cli_cfg_reference); // only one instance allowed
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(in_mode <= CLI_OUTPUT_MODE_CBOR);
+        ASSERT(0 == g_cli_cfg_reference->out_depth);
     }
-    inout_module_cfg->is_initialized = false;
-    g_cli_cfg_reference = NULL;
 
-    // Clear the config structure
-    memset(inout_module_cfg, 0, sizeof(cli_cfg_t));
+    if ((in_mode > CLI_OUTPUT_MODE_CBOR) || (0 != g_cli_cfg_reference->out_depth))
+    {
+        return;
+    }
+    g_cli_cfg_reference->output_mode = in_mode;
+}
+
+uint8_t cli_get_output_mode(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    return g_cli_cfg_reference->output_mode;
+}
+
+void cli_out_begin_map(const char* const in_key)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    prv_out_open(in_key, false);
+}
+
+void cli_out_end_map(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    prv_out_close(false);
+}
+
+void cli_out_begin_array(const char* const in_key)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    prv_out_open(in_key, true);
+}
+
+void cli_out_end_array(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    prv_out_close(true);
+}
+
+void cli_out_kv_int(const char* const in_key, int32_t in_value)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_out_begin_item(in_key, false))
+    {
+        return;
+    }
+
+    // The magnitude of INT32_MIN does not fit into an int32_t - it is computed unsigned
+    const uint32_t magnitude = (in_value < 0) ? (0U - (uint32_t)in_value) : (uint32_t)in_value;
+    if (CLI_OUTPUT_MODE_CBOR == g_cli_cfg_reference->output_mode)
+    {
+        // Negative integers are encoded as -1 - n
+        prv_out_write_cbor_head((in_value < 0) ? 1U : 0U, (in_value < 0) ? (magnitude - 1U) : magnitude);
+    }
+    else
+    {
+        if (in_value < 0)
+        {
+            prv_put_char('-');
+        }
+        prv_write_uint(magnitude);
+    }
+    prv_out_end_item();
+}
+
+void cli_out_kv_uint(const char* const in_key, uint32_t in_value)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_out_begin_item(in_key, false))
+    {
+        return;
+    }
+
+    if (CLI_OUTPUT_MODE_CBOR == g_cli_cfg_reference->output_mode)
+    {
+        prv_out_write_cbor_head(0U, in_value);
+    }
+    else
+    {
+        prv_write_uint(in_value);
+    }
+    prv_out_end_item();
+}
+
+void cli_out_kv_hex(const char* const in_key, uint32_t in_value)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_out_begin_item(in_key, false))
+    {
+        return;
+    }
+
+    // JSON has no hex numbers - only people get to see the hex digits
+    switch (g_cli_cfg_reference->output_mode)
+    {
+        case CLI_OUTPUT_MODE_CBOR:
+        {
+            prv_out_write_cbor_head(0U, in_value);
+            break;
+        }
+        case CLI_OUTPUT_MODE_JSON:
+        {
+            prv_write_uint(in_value);
+            break;
+        }
+        default:
+        {
+            prv_out_write_hex(in_value);
+            break;
+        }
+    }
+    prv_out_end_item();
+}
+
+void cli_out_kv_bool(const char* const in_key, bool in_value)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_out_begin_item(in_key, false))
+    {
+        return;
+    }
+
+    if (CLI_OUTPUT_MODE_CBOR == g_cli_cfg_reference->output_mode)
+    {
+        prv_put_raw_byte((true == in_value) ? 0xF5U : 0xF4U); // simple values true / false
+    }
+    else
+    {
+        prv_write_const_string((true == in_value) ? "true" : "false");
+    }
+    prv_out_end_item();
+}
+
+void cli_out_kv_str(const char* const in_key, const char* const in_value)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(in_value);
+    }
+
+    if ((NULL == in_value) || (false == prv_out_begin_item(in_key, false)))
+    {
+        return;
+    }
+
+    switch (g_cli_cfg_reference->output_mode)
+    {
+        case CLI_OUTPUT_MODE_CBOR:
+        {
+            prv_out_write_cbor_string(in_value);
+            break;
+        }
+        case CLI_OUTPUT_MODE_JSON:
+        {
+            prv_out_write_json_string(in_value);
+            break;
+        }
+        default:
+        {
+            prv_write_string(in_value);
+            break;
+        }
+    }
+    prv_out_end_item();
+}
+#endif
+
+uint16_t cli_get_continuation_index(void)
+{
+#if defined(CLI_ENABLE_EXECUTOR)
+    if (NULL != g_cli_worker_offload)
+    {
+        return g_cli_worker_offload->nof_handler_calls;
+    }
+#endif
+
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+    return g_cli_cfg_reference->nof_handler_calls;
+}
+
+const cli_binding_t* cli_find_next_binding(const char* const in_prefix, cli_size_t* const inout_cursor)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(in_prefix);
+        ASSERT(inout_cursor);
+    }
+
+    const size_t prefix_length = strlen(in_prefix);
+
+    const cli_size_t nof_bindings = prv_get_nof_bindings();
+
+    while (*inout_cursor < nof_bindings)
+    {
+        const cli_binding_t* cmd_binding = prv_get_binding(*inout_cursor);
+        (*inout_cursor)++;
+
+        CLI_ADD_COST(nof_name_compares, 1);
+        if (0 == strncmp(cmd_binding->name, in_prefix, prefix_length))
+        {
+            return cmd_binding;
+        }
+    }
+    return NULL;
+}
+
+void cli_set_terminal_caps(uint8_t in_terminal_caps)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(0 == (in_terminal_caps & ~(CLI_TERM_CAP_ANSI | CLI_TERM_CAP_REP)));
+    }
+    g_cli_cfg_reference->terminal_caps = in_terminal_caps;
+}
+
+void cli_register_alias_commands(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_binding_t alias_cmd_binding = {"alias", prv_cmd_handler_alias, NULL, "Define an alias - alias [name [= cmd]]",
+                                       NULL, NULL};
+    cli_binding_t set_cmd_binding = {"set", prv_cmd_handler_set, NULL, "Define a $variable - set [name [value]]",
+                                     NULL, NULL};
+    cli_register(&alias_cmd_binding);
+    cli_register(&set_cmd_binding);
+}
+
+void cli_register_job_commands(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_binding_t watch_cmd_binding = {"watch", prv_cmd_handler_watch, NULL, "Repeat a command - watch ms cmd", NULL,
+                                       NULL};
+    cli_binding_t jobs_cmd_binding = {"jobs", prv_cmd_handler_jobs, NULL, "List the periodic commands", NULL, NULL};
+    cli_binding_t kill_cmd_binding = {"kill", prv_cmd_handler_kill, NULL, "Stop a periodic command - kill job", NULL,
+                                      NULL};
+    cli_register(&watch_cmd_binding);
+    cli_register(&jobs_cmd_binding);
+    cli_register(&kill_cmd_binding);
+}
+
+void cli_register_stats_command(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_binding_t stats_cmd_binding = {"stats", prv_cmd_handler_stats, NULL, "Buffer use and drops - stats [reset]",
+                                       NULL, NULL};
+    cli_register(&stats_cmd_binding);
+}
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+void cli_register_output_command(void)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_binding_t output_cmd_binding = {"output", prv_cmd_handler_output, NULL,
+                                        "Output of structured results - output [text|json|cbor]", NULL, NULL};
+    cli_register(&output_cmd_binding);
+}
+#endif
+
+void cli_start_transfer(const cli_transfer_t* const in_transfer)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+        ASSERT(in_transfer);
+        ASSERT(in_transfer->chunk_fn);
+        ASSERT(CLI_PROCESS_STATE_DISPATCH == g_cli_cfg_reference->process_state);
+    }
+
+    if ((NULL == in_transfer) || (NULL == in_transfer->chunk_fn)
+        || (CLI_PROCESS_STATE_DISPATCH != g_cli_cfg_reference->process_state))
+    {
+        return;
+    }
+
+    memcpy(&g_cli_cfg_reference->transfer, in_transfer, sizeof(cli_transfer_t));
+    g_cli_cfg_reference->transfer_state = CLI_TRANSFER_STATE_PENDING;
+}
+
+void cli_tick(uint32_t in_now_ms)
+{
+    { // Input Checks
+        prv_verify_api_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if (false == cfg->is_wheel_started)
+    {
+        cfg->last_tick_ms = in_now_ms;
+        cfg->is_wheel_started = true;
+        return;
+    }
+
+    // Only whole ticks are consumed - the remainder is carried over to the next call
+    uint32_t nof_elapsed_ticks = (uint32_t)(in_now_ms - cfg->last_tick_ms) / CLI_WHEEL_TICK_MS;
+    cfg->last_tick_ms += nof_elapsed_ticks * CLI_WHEEL_TICK_MS;
+
+    // After a long pause one turn of the wheel is caught up, the rest of the time is skipped
+    if (nof_elapsed_ticks > (CLI_WHEEL_SIZE * CLI_WHEEL_SIZE))
+    {
+        nof_elapsed_ticks = CLI_WHEEL_SIZE * CLI_WHEEL_SIZE;
+    }
+
+    for (uint32_t tick = 0; tick < nof_elapsed_ticks; tick++)
+    {
+        prv_advance_wheel();
+    }
+}
+
+void cli_log(const char* fmt, ...)
+{
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    { // Input Checks
+        // Only the parts of the config that are constant after cli_init may be looked at - the full integrity
+        // check would race with the thread that runs cli_receive / cli_process
+        ASSERT(cfg);
+        ASSERT(CLI_CANARY == cfg->start_canary_word);
+        ASSERT(CLI_CANARY == cfg->end_canary_word);
+        ASSERT(fmt);
+    }
+
+    // Bounded multi producer queue: claim a slot by advancing the enqueue position, fill it and publish it
+    // by advancing the slot's sequence number. The sequence tells whether the consumer has freed the slot.
+    uint32_t pos = __atomic_load_n(&cfg->log_enqueue_pos, __ATOMIC_RELAXED);
+    cli_log_slot_t* slot = NULL;
+    for (;;)
+    {
+        slot = &cfg->log_slots[pos % CLI_LOG_QUEUE_DEPTH];
+        const uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        const int32_t distance = (int32_t)(sequence - pos);
+
+        if (0 == distance)
+        {
+            if (__atomic_compare_exchange_n(&cfg->log_enqueue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+            {
+                break;
+            }
+            // another producer was faster - pos holds the new enqueue position
+        }
+        else if (distance < 0)
+        {
+            // Queue is full - the consumer has not freed this slot yet
+            __atomic_fetch_add(&cfg->nof_dropped_logs, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else
+        {
+            pos = __atomic_load_n(&cfg->log_enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+#if (0 != CLI_FEATURE_PRINT_FORMATTER)
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(slot->message, sizeof(slot->message), fmt, args);
+    va_end(args);
+#else
+    strncpy(slot->message, fmt, sizeof(slot->message) - 1);
+    slot->message[sizeof(slot->message) - 1] = '\0';
+#endif
+
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+}
+
+void cli_deinit(cli_cfg_t* const inout_module_cfg)
+{
+    { // Input Checks
+        prv_verify_api_integrity(inout_module_cfg);
+        ASSERT(inout_module_cfg == g_cli_cfg_reference); // only one instance allowed
+#if defined(CLI_ENABLE_EXECUTOR)
+        ASSERT(0 == inout_module_cfg->nof_offloads); // workers would write into the cleared cfg
+#endif
+    }
+    prv_flush_tx();
+
+    inout_module_cfg->is_initialized = false;
+    g_cli_cfg_reference = NULL;
+
+    // Clear the config structure
+    memset(inout_module_cfg, 0, sizeof(cli_cfg_t));
 }
 
 /* #############################################################################
  * # static function implementations
  * ###########################################################################*/
 
-static void prv_write_string(const char* in_string)
+static void prv_write_string(const char* in_string)
+{
+    {
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    for (const char* current_char = in_string; *current_char != '\0'; current_char++)
+    {
+        prv_write_char(*current_char);
+    }
+}
+
+static void prv_write_char(char in_char)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    if ('\n' == in_char) // User pressed Enter
+    {
+        prv_put_char('\r');
+        prv_put_char('\n');
+    }
+    else if ('\b' == in_char) // User pressed Backspace
+    {
+        prv_erase_chars(1);
+    }
+    else // Every other character
+    {
+        prv_put_char(in_char);
+    }
+}
+
+static void prv_put_char(char in_char)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    // The output of a pipeline handler goes through its filters first
+    if (true == g_cli_cfg_reference->is_output_filtered)
+    {
+        prv_filter_char(in_char);
+        return;
+    }
+    prv_emit_char(in_char);
+}
+
+static void prv_emit_char(char in_char)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if (NULL != cfg->capture_buffer)
+    {
+        // The caller of cli_execute gets plain "\n" line ends - the rest is dropped, when the buffer is full
+        if (('\r' != in_char) && (cfg->nof_captured_chars < (cfg->capture_capacity - 1)))
+        {
+            cfg->capture_buffer[cfg->nof_captured_chars] = in_char;
+            cfg->nof_captured_chars++;
+        }
+        return;
+    }
+
+    if (NULL == cfg->transport)
+    {
+        CLI_ADD_COST(nof_sink_calls, 1);
+        CLI_ADD_COST(nof_sink_bytes, 1);
+        cfg->put_char_fn(in_char);
+        return;
+    }
+
+    if (cfg->nof_stored_chars_in_tx_buffer >= CLI_TX_BUFFER_SIZE)
+    {
+        prv_flush_tx();
+    }
+
+    // Gather the character - consecutive characters end up in the same iovec
+    const cli_size_t idx = cfg->nof_stored_chars_in_tx_buffer;
+    cfg->tx_char_buffer[idx] = in_char;
+    cfg->nof_stored_chars_in_tx_buffer++;
+    prv_append_tx_iovec(&cfg->tx_char_buffer[idx], 1);
+}
+
+static void prv_write_const_string(const char* in_string)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_string);
+    }
+
+    if ((NULL == g_cli_cfg_reference->transport) || (true == g_cli_cfg_reference->is_output_filtered)
+        || (NULL != g_cli_cfg_reference->capture_buffer))
+    {
+        prv_write_string(in_string);
+        return;
+    }
+
+    // String literals outlive the flush - they are referenced in place instead of being copied.
+    // They must not contain '\n', as the CR / LF translation of prv_write_char is skipped.
+    prv_append_tx_iovec(in_string, strlen(in_string));
+}
+
+static void prv_append_tx_iovec(const char* in_base, size_t in_len)
+{
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if (cfg->nof_tx_iovecs > 0)
+    {
+        cli_iovec_t* const last_iovec = &cfg->tx_iovecs[cfg->nof_tx_iovecs - 1];
+        if (((const char*)last_iovec->base + last_iovec->len) == in_base)
+        {
+            last_iovec->len += in_len;
+            return;
+        }
+    }
+
+    if (cfg->nof_tx_iovecs >= CLI_MAX_NOF_TX_IOVECS)
+    {
+        // Keep the characters of the tx buffer where they are - only the iovecs need to be written out
+        const bool is_in_tx_buffer = (in_base >= cfg->tx_char_buffer) && (in_base < &cfg->tx_char_buffer[CLI_TX_BUFFER_SIZE]);
+        const cli_size_t offset = (true == is_in_tx_buffer) ? (cli_size_t)(in_base - cfg->tx_char_buffer) : 0;
+
+        prv_flush_tx();
+
+        if (true == is_in_tx_buffer)
+        {
+            // Move the character(s) to the start of the now empty tx buffer
+            memmove(cfg->tx_char_buffer, &cfg->tx_char_buffer[offset], in_len);
+            cfg->nof_stored_chars_in_tx_buffer = (cli_size_t)in_len;
+            in_base = cfg->tx_char_buffer;
+        }
+    }
+
+    cfg->tx_iovecs[cfg->nof_tx_iovecs].base = in_base;
+    cfg->tx_iovecs[cfg->nof_tx_iovecs].len = in_len;
+    cfg->nof_tx_iovecs++;
+}
+
+static void prv_flush_tx(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if ((NULL != cfg->transport) && (cfg->nof_tx_iovecs > 0))
+    {
+        // Everything that was gathered goes out with a single call
+        CLI_ADD_COST(nof_sink_calls, 1);
+        for (uint8_t i = 0; i < cfg->nof_tx_iovecs; i++)
+        {
+            CLI_ADD_COST(nof_sink_bytes, cfg->tx_iovecs[i].len);
+        }
+        (void)cfg->transport->writev(cfg->transport->context, cfg->tx_iovecs, cfg->nof_tx_iovecs);
+
+        if (NULL != cfg->transport->flush)
+        {
+            (void)cfg->transport->flush(cfg->transport->context);
+        }
+    }
+
+    cfg->nof_tx_iovecs = 0;
+    cfg->nof_stored_chars_in_tx_buffer = 0;
+}
+
+static void prv_pump_transport_input(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_transport_t* const transport = cfg->transport;
+
+    if (NULL == transport)
+    {
+        return;
+    }
+
+    // Transfer frames are not processed in steps - all chunks that arrived are taken at once
+    do
+    {
+        if (cfg->idx_next_transport_char >= cfg->nof_pending_transport_chars)
+        {
+            // All characters of the last chunk were consumed - fetch the next one
+            cfg->idx_next_transport_char = 0;
+            cfg->nof_pending_transport_chars = 0;
+
+            if ((NULL != transport->poll_ready) && (false == transport->poll_ready(transport->context)))
+            {
+                return;
+            }
+
+            int nof_read_chars =
+                transport->read(transport->context, cfg->transport_rx_buffer, CLI_TRANSPORT_RX_CHUNK_SIZE);
+            ASSERT(nof_read_chars <= CLI_TRANSPORT_RX_CHUNK_SIZE);
+            if (nof_read_chars <= 0)
+            {
+                return;
+            }
+            cfg->nof_pending_transport_chars = (uint8_t)nof_read_chars;
+        }
+
+        // Feed the characters up to the end of the next line - the rest stays for the next call
+        while ((cfg->idx_next_transport_char < cfg->nof_pending_transport_chars) && (false == prv_is_line_pending()))
+        {
+            prv_receive_char(cfg->transport_rx_buffer[cfg->idx_next_transport_char]);
+            cfg->idx_next_transport_char++;
+        }
+    } while (cfg->transfer_state >= CLI_TRANSFER_STATE_WAIT_FRAME);
+}
+
+static void prv_write_cli_prompt()
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+#if (0 != CLI_FEATURE_DECORATION)
+    prv_plot_lines(CLI_PROMPT_SPACER, CLI_OUTPUT_WIDTH);
+#if (0 != CLI_FEATURE_HELP)
+    prv_write_const_string("Embedded CLI - Type 'help' to list all commands");
+#else
+    prv_write_const_string("Embedded CLI");
+#endif
+    prv_write_char('\n');
+    prv_plot_lines(CLI_PROMPT_SPACER, CLI_OUTPUT_WIDTH);
+#endif
+    prv_write_const_string(CLI_PROMPT);
+}
+
+static void prv_write_cmd_unknown(const char* const in_cmd_name)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    prv_write_const_string("Unknown command: ");
+    prv_write_string(in_cmd_name);
+    prv_write_char('\n');
+#if (0 != CLI_FEATURE_HELP)
+    prv_write_const_string("Type 'help' to list all commands");
+    prv_write_char('\n');
+#endif
+}
+
+static void prv_reset_rx_buffer()
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    memset(g_cli_cfg_reference->rx_char_buffer, 0, CLI_MAX_RX_BUFFER_SIZE);
+    g_cli_cfg_reference->nof_stored_chars_in_rx_buffer = 0;
+    memset(&g_cli_cfg_reference->rx_tokens, 0, sizeof(g_cli_cfg_reference->rx_tokens));
+    g_cli_cfg_reference->stream_binding = NULL;
+    g_cli_cfg_reference->stream_token_start = 0;
+    g_cli_cfg_reference->nof_streamed_args = 0;
+}
+
+static bool prv_is_rx_buffer_full()
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    return (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer < CLI_MAX_RX_BUFFER_SIZE) ? false : true;
+}
+
+static char prv_get_last_recv_char_from_rx_buffer(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    return g_cli_cfg_reference->rx_char_buffer[g_cli_cfg_reference->nof_stored_chars_in_rx_buffer - 1];
+}
+
+static const cli_binding_t* prv_find_cmd(const char* const in_cmd_name)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_cmd_name);
+    }
+
+    // The shared registry first - most commands are there, the overlay holds the few of this instance
+    const cli_registry_t* const registry = g_cli_cfg_reference->registry;
+    if (NULL != registry)
+    {
+        const cli_size_t registry_slot = registry->index[prv_find_registry_slot(registry, in_cmd_name)];
+        if (0 != registry_slot)
+        {
+            return &registry->bindings[registry_slot - 1];
+        }
+    }
+
+    const cli_size_t* const slot = prv_find_cmd_index_slot(in_cmd_name);
+    if (0 == *slot)
+    {
+        return NULL;
+    }
+    return &g_cli_cfg_reference->cmd_bindings_buffer[*slot - 1];
+}
+
+static const cli_binding_t* prv_get_binding(cli_size_t in_idx)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_idx < prv_get_nof_bindings());
+    }
+
+    // The bindings of the registry come first, then the overlay
+    const cli_registry_t* const registry = g_cli_cfg_reference->registry;
+    const cli_size_t nof_shared_bindings = (NULL != registry) ? registry->nof_bindings : 0;
+    if (in_idx < nof_shared_bindings)
+    {
+        return &registry->bindings[in_idx];
+    }
+    return &g_cli_cfg_reference->cmd_bindings_buffer[in_idx - nof_shared_bindings];
+}
+
+static cli_size_t prv_get_nof_bindings(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    const cli_registry_t* const registry = g_cli_cfg_reference->registry;
+    const cli_size_t nof_shared_bindings = (NULL != registry) ? registry->nof_bindings : 0;
+    return (cli_size_t)(nof_shared_bindings + g_cli_cfg_reference->nof_stored_cmd_bindings);
+}
+
+static uint32_t prv_hash_name(const char* const in_name)
+{
+    // FNV-1a over the (at most CLI_MAX_CMD_NAME_LENGTH long) name
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; (i < CLI_MAX_CMD_NAME_LENGTH) && ('\0' != in_name[i]); i++)
+    {
+        hash ^= (uint8_t)in_name[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static cli_size_t prv_hash_cmd_name(const char* const in_cmd_name)
+{
+    return (cli_size_t)(prv_hash_name(in_cmd_name) % CLI_CMD_INDEX_SIZE);
+}
+
+static cli_size_t prv_find_registry_slot(const cli_registry_t* const in_registry, const char* const in_cmd_name)
+{
+    cli_size_t slot_idx = (cli_size_t)(prv_hash_name(in_cmd_name) % in_registry->index_size);
+
+    // Linear probing like the overlay index - reads only, so any number of instances can search at the same time
+    while (0 != in_registry->index[slot_idx])
+    {
+        const cli_binding_t* cmd_binding = &in_registry->bindings[in_registry->index[slot_idx] - 1];
+        CLI_ADD_COST(nof_name_compares, 1);
+        if (0 == strncmp(cmd_binding->name, in_cmd_name, CLI_MAX_CMD_NAME_LENGTH))
+        {
+            break;
+        }
+        slot_idx = (cli_size_t)((slot_idx + 1) % in_registry->index_size);
+    }
+    return slot_idx;
+}
+
+static cli_size_t* prv_find_cmd_index_slot(const char* const in_cmd_name)
+{
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_size_t slot_idx = prv_hash_cmd_name(in_cmd_name);
+
+    // Linear probing - the table is never full, so there is always an empty slot that ends the search
+    while (0 != cfg->cmd_index[slot_idx])
+    {
+        const cli_binding_t* cmd_binding = &cfg->cmd_bindings_buffer[cfg->cmd_index[slot_idx] - 1];
+        CLI_ADD_COST(nof_name_compares, 1);
+        if (0 == strncmp(cmd_binding->name, in_cmd_name, CLI_MAX_CMD_NAME_LENGTH))
+        {
+            break;
+        }
+        slot_idx = (cli_size_t)((slot_idx + 1) % CLI_CMD_INDEX_SIZE);
+    }
+    return &cfg->cmd_index[slot_idx];
+}
+
+#if (0 != CLI_FEATURE_UNREGISTER)
+static void prv_remove_cmd_index_slot(cli_size_t* const inout_slot)
+{
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_size_t gap_idx = (cli_size_t)(inout_slot - cfg->cmd_index);
+    cli_size_t slot_idx = gap_idx;
+
+    // Backward shift deletion: move entries of the probe chain into the gap, so that no tombstones are needed
+    cfg->cmd_index[gap_idx] = 0;
+    for (;;)
+    {
+        slot_idx = (cli_size_t)((slot_idx + 1) % CLI_CMD_INDEX_SIZE);
+        if (0 == cfg->cmd_index[slot_idx])
+        {
+            return;
+        }
+
+        // An entry may only move into the gap, if the gap lies between its home slot and its current slot
+        const cli_size_t home_idx = prv_hash_cmd_name(cfg->cmd_bindings_buffer[cfg->cmd_index[slot_idx] - 1].name);
+        const bool is_gap_in_chain = (gap_idx <= slot_idx) ? ((home_idx <= gap_idx) || (home_idx > slot_idx))
+                                                           : ((home_idx <= gap_idx) && (home_idx > slot_idx));
+        if (true == is_gap_in_chain)
+        {
+            cfg->cmd_index[gap_idx] = cfg->cmd_index[slot_idx];
+            cfg->cmd_index[slot_idx] = 0;
+            gap_idx = slot_idx;
+        }
+    }
+}
+#endif
+
+static void prv_clear_screen(void)
+{
+#if (0 != CLI_FEATURE_DECORATION)
+    // A dumb terminal would only print the escape sequence as garbage
+    if (false == prv_has_terminal_cap(CLI_TERM_CAP_ANSI))
+    {
+        return;
+    }
+
+    // ANSI escape code to clear screen and move cursor to home
+    cli_print(CLI_CSI "2J" CLI_CSI "H");
+#endif
+}
+
+static uint8_t prv_get_args_from_rx_tokens(char* array_of_arguments[], uint8_t max_arguments)
+{
+    { // Input Checks
+        ASSERT(array_of_arguments);
+        ASSERT(max_arguments > 0);
+
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    const cli_size_t nof_stored_tokens =
+        (tokens->nof_tokens < CLI_MAX_NOF_ARGUMENTS) ? tokens->nof_tokens : CLI_MAX_NOF_ARGUMENTS;
+    const uint8_t nof_arguments = (uint8_t)((nof_stored_tokens < max_arguments) ? nof_stored_tokens : max_arguments);
+    if (tokens->nof_tokens > nof_arguments)
+    {
+        cfg->stats.nof_cut_arg_lists++;
+    }
+
+    // The boundaries are known already - only the delimiters are replaced, arguments beyond max are dropped
+    for (uint8_t i = 0; i < nof_arguments; i++)
+    {
+        cli_size_t end = tokens->ends[i];
+        if ((true == tokens->is_token_open) && (i == (tokens->nof_tokens - 1)))
+        {
+            // A line that fills the whole buffer has no delimiter - its last character makes room for the '\0'
+            const cli_size_t nof_chars = cfg->nof_stored_chars_in_rx_buffer;
+            end = (nof_chars < CLI_MAX_RX_BUFFER_SIZE) ? nof_chars : (cli_size_t)(CLI_MAX_RX_BUFFER_SIZE - 1);
+        }
+        cfg->rx_char_buffer[end] = '\0';
+        array_of_arguments[i] = &cfg->rx_char_buffer[tokens->starts[i]];
+    }
+
+    return nof_arguments;
+}
+
+static bool prv_is_token_delimiter(char in_char)
+{
+    return ((' ' == in_char) || ('\n' == in_char)) ? true : false;
+}
+
+static bool prv_advance_rx_tokens(cli_rx_tokens_t* const inout_tokens, const char* const in_rx, cli_size_t in_idx)
+{
+    { // Input Checks
+        ASSERT(inout_tokens);
+        ASSERT(in_rx);
+    }
+
+    if (false == prv_is_token_delimiter(in_rx[in_idx]))
+    {
+        if (false == inout_tokens->is_token_open)
+        {
+            if (inout_tokens->nof_tokens < CLI_MAX_NOF_ARGUMENTS)
+            {
+                inout_tokens->starts[inout_tokens->nof_tokens] = in_idx;
+            }
+            inout_tokens->nof_tokens++;
+            inout_tokens->is_token_open = true;
+        }
+        return false;
+    }
+
+    if (false == inout_tokens->is_token_open)
+    {
+        return false;
+    }
+    inout_tokens->is_token_open = false;
+    if (inout_tokens->nof_tokens <= CLI_MAX_NOF_ARGUMENTS)
+    {
+        inout_tokens->ends[inout_tokens->nof_tokens - 1] = in_idx;
+    }
+
+    // true, when the command name is complete
+    return (1 == inout_tokens->nof_tokens) ? true : false;
+}
+
+static void prv_resolve_rx_cmd(cli_size_t in_delimiter_idx)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_delimiter_idx < g_cli_cfg_reference->nof_stored_chars_in_rx_buffer);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    const char delimiter = cfg->rx_char_buffer[in_delimiter_idx];
+
+    // Looked up now instead of when the line is processed
+    cfg->rx_char_buffer[in_delimiter_idx] = '\0';
+    tokens->cmd_binding = prv_find_cmd(&cfg->rx_char_buffer[tokens->starts[0]]);
+    cfg->rx_char_buffer[in_delimiter_idx] = delimiter;
+    tokens->cmd_generation = cfg->bindings_generation;
+    tokens->is_cmd_resolved = true;
+}
+
+static void prv_scan_rx_char(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > 0);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_size_t idx = (cli_size_t)(cfg->nof_stored_chars_in_rx_buffer - 1);
+
+    if (true == prv_advance_rx_tokens(&cfg->rx_tokens, cfg->rx_char_buffer, idx))
+    {
+        prv_resolve_rx_cmd(idx);
+    }
+}
+
+static void prv_unscan_rx_char(char in_deleted_char)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    const cli_size_t idx = cfg->nof_stored_chars_in_rx_buffer; // of the deleted character
+    const bool is_after_token = (idx > 0) && (false == prv_is_token_delimiter(cfg->rx_char_buffer[idx - 1]));
+
+    if (true == prv_is_token_delimiter(in_deleted_char))
+    {
+        if (true == is_after_token)
+        {
+            // The delimiter closed the token before it - that token is edited again
+            tokens->is_token_open = true;
+            tokens->is_cmd_resolved = (1 == tokens->nof_tokens) ? false : tokens->is_cmd_resolved;
+        }
+    }
+    else if (false == is_after_token)
+    {
+        // The only character of the last token is gone
+        tokens->nof_tokens--;
+        tokens->is_token_open = false;
+    }
+}
+
+static void prv_rescan_rx_buffer(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // The chars are scanned as if they were received one by one
+    memset(&cfg->rx_tokens, 0, sizeof(cfg->rx_tokens));
+    for (cli_size_t idx = 0; idx < cfg->nof_stored_chars_in_rx_buffer; idx++)
+    {
+        if (true == prv_advance_rx_tokens(&cfg->rx_tokens, cfg->rx_char_buffer, idx))
+        {
+            prv_resolve_rx_cmd(idx);
+        }
+    }
+}
+
+static void prv_receive_char(char in_char)
+{
+    prv_verify_object_integrity(g_cli_cfg_reference);
+
+    if (g_cli_cfg_reference->transfer_state >= CLI_TRANSFER_STATE_WAIT_FRAME)
+    {
+        // Transfer mode - no line editing and no echo
+        prv_receive_transfer_char(in_char);
+        return;
+    }
+
+    if (CLI_PROCESS_STATE_IDLE != g_cli_cfg_reference->process_state)
+    {
+        // The rx buffer holds the line that is currently processed - it must not be modified
+        prv_queue_typeahead_char(in_char);
+        return;
+    }
+
+    if (true == prv_is_rx_buffer_full())
+    {
+        // Buffer full - ignore the character
+        prv_write_string("Buffer is full\n");
+        g_cli_cfg_reference->stats.nof_rx_overflows++;
+
+        // Reset the buffer to avoid overflows
+        prv_reset_rx_buffer();
+
+        return;
+    }
+
+    if (true == prv_is_line_pending())
+    {
+        // A complete line waits for cli_process - further characters would be merged into it
+        prv_queue_typeahead_char(in_char);
+        return;
+    }
+
+    switch (in_char)
+    {
+        case 0x7F: // DEL
+        case '\b': // Backspace
+        {
+            // Streamed arguments are already delivered - they can not be taken back
+            const cli_size_t nof_locked_chars =
+                (g_cli_cfg_reference->nof_streamed_args > 0) ? g_cli_cfg_reference->stream_token_start : 0;
+            bool rx_buffer_has_chars = (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > nof_locked_chars);
+
+            // Only delete characters, when there are characters in the buffer.
+            if (true == rx_buffer_has_chars)
+            {
+                g_cli_cfg_reference->nof_stored_chars_in_rx_buffer--;
+                cli_size_t idx = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+                const char deleted_char = g_cli_cfg_reference->rx_char_buffer[idx];
+
+                // Remove the last character (the one that was deleted)
+                // Replace it with a null character
+                g_cli_cfg_reference->rx_char_buffer[idx] = '\0';
+                prv_unscan_rx_char(deleted_char);
+
+                if (idx < g_cli_cfg_reference->stream_token_start)
+                {
+                    // The command name is edited again - it is looked up with its next delimiter
+                    g_cli_cfg_reference->stream_binding = NULL;
+                    g_cli_cfg_reference->stream_token_start = 0;
+                }
+
+                // Remove character from cli
+                if (true == prv_is_output_decorated())
+                {
+                    prv_write_char('\b');
+                }
+            }
+            break;
+        }
+        case '\t': // Tab
+        {
+#if (0 != CLI_FEATURE_AUTOCOMPLETE)
+            // autocomplete the currently incomplete command (if possible)
+            if (true == prv_is_output_decorated())
+            {
+                prv_autocomplete_command();
+            }
+#endif
+            break;
+        }
+        case '\r': // Carriage Return
+        {
+            // Convert CR to LF to handle Enter key from terminal programs
+            in_char = '\n';
+            // Fall through to default case to process as normal character
+            __attribute__((fallthrough));
+        }
+        default:
+        {
+            // Add the character to the buffer
+            cli_size_t idx = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+            g_cli_cfg_reference->rx_char_buffer[idx] = in_char;
+            g_cli_cfg_reference->nof_stored_chars_in_rx_buffer++;
+            if (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > g_cli_cfg_reference->stats.max_nof_rx_chars)
+            {
+                g_cli_cfg_reference->stats.max_nof_rx_chars = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+            }
+
+            prv_verify_object_integrity(g_cli_cfg_reference);
+
+            // write the character back out to the console
+            const bool is_echoed = prv_is_output_decorated();
+            if (true == is_echoed)
+            {
+                prv_write_char(in_char);
+            }
+
+            prv_scan_rx_char();
+
+            if ((' ' == in_char) || ('\n' == in_char))
+            {
+                if (true == is_echoed)
+                {
+                    prv_write_cmd_feedback();
+                }
+                prv_stream_arg();
+            }
+
+            break;
+        }
+    }
+}
+
+static void prv_queue_typeahead_char(char in_char)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if (cfg->nof_typeahead_chars >= CLI_TYPEAHEAD_SIZE)
+    {
+        // The user typed far ahead - the lost key is reported right away, not when the line is done
+        cfg->stats.nof_lost_typeahead_chars++;
+        if (true == prv_is_output_decorated())
+        {
+            prv_put_char('\a');
+        }
+        return;
+    }
+    cfg->typeahead_chars[cfg->nof_typeahead_chars] = in_char;
+    cfg->nof_typeahead_chars++;
+}
+
+static void prv_replay_typeahead(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    char typeahead_chars[CLI_TYPEAHEAD_SIZE];
+    const uint8_t nof_typeahead_chars = cfg->nof_typeahead_chars;
+
+    // Received again in their order - the characters behind a completed line are queued again for the next one
+    memcpy(typeahead_chars, cfg->typeahead_chars, nof_typeahead_chars);
+    cfg->nof_typeahead_chars = 0;
+    for (uint8_t i = 0; i < nof_typeahead_chars; i++)
+    {
+        prv_receive_char(typeahead_chars[i]);
+    }
+}
+
+static void prv_stream_arg(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > 0);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    char* const rx = cfg->rx_char_buffer;
+    const cli_size_t delimiter_idx = (cli_size_t)(cfg->nof_stored_chars_in_rx_buffer - 1);
+    const char delimiter = rx[delimiter_idx];
+
+    if (NULL == cfg->stream_binding)
+    {
+        const cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+        if ((0 != cfg->stream_token_start) || (' ' != delimiter))
+        {
+            // Streaming was stopped in this line - or the line ends before it could start
+            return;
+        }
+
+        // The command name is complete, when the delimiter just closed the first token of the line
+        if ((1 != tokens->nof_tokens) || (true == tokens->is_token_open) || (delimiter_idx != tokens->ends[0]))
+        {
+            return;
+        }
+
+        // Aliases shadow commands - they get their arguments in argv
+        const cli_binding_t* const binding = tokens->cmd_binding;
+        rx[delimiter_idx] = '\0';
+        const bool is_streamed = (NULL != binding) && (NULL != binding->arg_fn)
+                                 && (NULL == prv_find_alias(&rx[tokens->starts[0]], false));
+        rx[delimiter_idx] = delimiter;
+        if (true == is_streamed)
+        {
+            cfg->stream_binding = binding;
+            cfg->stream_token_start = cfg->nof_stored_chars_in_rx_buffer;
+            cfg->nof_streamed_args = 0;
+            cfg->stream_status = CLI_OK_STATUS;
+        }
+        return;
+    }
+
+    const cli_size_t token_start = cfg->stream_token_start;
+    const cli_size_t token_length = (cli_size_t)(delimiter_idx - token_start);
+    char* const token = &rx[token_start];
+    rx[delimiter_idx] = '\0';
+
+    if (0 == strcmp(token, CLI_PIPELINE_SEPARATOR))
+    {
+        // The rest of the line stays in the rx buffer - the tokenizer splits it into the pipeline
+        rx[delimiter_idx] = delimiter;
+        cfg->stream_binding = NULL;
+        return;
+    }
+
+    if ((token_length > 0) && (CLI_OK_STATUS == cfg->stream_status))
+    {
+        const cli_binding_t* const binding = cfg->stream_binding;
+        cfg->nof_streamed_args++;
+        cfg->stream_status = binding->arg_fn(cfg->nof_streamed_args, prv_expand_variable(token), binding->context);
+    }
+
+    // The delivered argument is dropped - the next one reuses its space
+    if (token_length > 0)
+    {
+        cfg->rx_tokens.nof_tokens--;
+    }
+    memset(token, 0, (size_t)token_length + 1);
+    cfg->nof_stored_chars_in_rx_buffer = token_start;
+    if ('\n' == delimiter)
+    {
+        rx[token_start] = '\n';
+        cfg->nof_stored_chars_in_rx_buffer++;
+    }
+}
+
+static void prv_write_cmd_feedback(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > 0);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    char* const rx = cfg->rx_char_buffer;
+    const cli_size_t delimiter_idx = (cli_size_t)(cfg->nof_stored_chars_in_rx_buffer - 1);
+
+    // Only when the command name was just completed and more is typed - Enter reports unknown commands anyway
+    if ((' ' != rx[delimiter_idx]) || (1 != tokens->nof_tokens) || (true == tokens->is_token_open)
+        || (delimiter_idx != tokens->ends[0]) || (NULL != tokens->cmd_binding)
+        || (CLI_VARIABLE_PREFIX == rx[tokens->starts[0]]))
+    {
+        return;
+    }
+
+    rx[delimiter_idx] = '\0';
+    const bool is_alias = (NULL != prv_find_alias(&rx[tokens->starts[0]], false));
+    rx[delimiter_idx] = ' ';
+
+    if (false == is_alias)
+    {
+        // BEL is plain ASCII - every terminal lets the user hear about the typo before the line is finished
+        prv_write_char('\a');
+    }
+}
+
+static bool prv_is_line_pending(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    if (CLI_PROCESS_STATE_IDLE != g_cli_cfg_reference->process_state)
+    {
+        return true;
+    }
+
+    // A line is complete with the newline or when there is no more room for further characters
+    return ((g_cli_cfg_reference->nof_stored_chars_in_rx_buffer > 0)
+            && (('\n' == prv_get_last_recv_char_from_rx_buffer()) || (true == prv_is_rx_buffer_full())))
+               ? true
+               : false;
+}
+
+static bool prv_is_line_ready(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_is_line_pending())
+    {
+        return false;
+    }
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    // The output of the running handlers comes first - only another offloaded line may start before they are done
+    if ((g_cli_cfg_reference->nof_offloads > 0) && (false == prv_is_line_offloaded()))
+    {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void prv_write_cmd_footer(int in_status)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_is_output_decorated())
+    {
+        return;
+    }
+
+    prv_plot_lines(CLI_SECTION_SPACER, CLI_OUTPUT_WIDTH);
+    prv_write_const_string("Status -> ");
+#if (0 != CLI_FEATURE_COLOR)
+    if (true == prv_has_terminal_cap(CLI_TERM_CAP_ANSI))
+    {
+        prv_write_const_string((in_status == CLI_OK_STATUS) ? CLI_OK_PROMPT : CLI_FAIL_PROMPT);
+    }
+    else
+#endif
+    {
+        prv_write_const_string((in_status == CLI_OK_STATUS) ? CLI_OK_PROMPT_PLAIN : CLI_FAIL_PROMPT_PLAIN);
+    }
+    prv_write_char('\n');
+}
+
+static bool prv_process_step(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    switch (cfg->process_state)
+    {
+        case CLI_PROCESS_STATE_IDLE:
+        {
+            // Logs are only printed between commands - never into the output of a command
+            prv_drain_log_queue();
+
+#if defined(CLI_ENABLE_EXECUTOR)
+            // Handlers that ran on the executor are finished before the next line starts
+            prv_finish_offloads();
+#endif
+
+            if ((cfg->nof_typeahead_chars > 0) && (false == prv_is_line_pending()))
+            {
+                prv_replay_typeahead();
+            }
+            if (false == prv_is_line_pending())
+            {
+                prv_pump_transport_input();
+            }
+            if (false == prv_is_line_ready())
+            {
+                // Expired jobs run while the user does not enter a line - without header and footer
+                if (true == prv_start_ready_job())
+                {
+                    cfg->process_state = CLI_PROCESS_STATE_DISPATCH;
+                    break;
+                }
+
+                // Nothing to do
+                return false;
+            }
+            cfg->process_state = CLI_PROCESS_STATE_TOKENIZE;
+            break;
+        }
+        case CLI_PROCESS_STATE_TOKENIZE:
+        {
+            memset(cfg->args, 0, sizeof(cfg->args));
+            cfg->nof_args = prv_get_args_from_rx_tokens(cfg->args, CLI_MAX_NOF_ARGUMENTS);
+            cfg->cmd_status = CLI_FAIL_STATUS;
+            cfg->nof_handler_calls = 0;
+            cfg->cmd_binding = NULL;
+
+            bool is_cmd_loaded = false;
+            const cli_alias_t* const alias = (cfg->nof_args >= 1) ? prv_find_alias(cfg->args[0], false) : NULL;
+            if (NULL != alias)
+            {
+                // The alias tokens replace the typed line - the typed arguments go behind its last command
+                cfg->nof_extra_args = (uint8_t)(cfg->nof_args - 1);
+                memcpy(cfg->extra_args, &cfg->args[1], cfg->nof_extra_args * sizeof(cfg->args[0]));
+                cfg->active_alias = (uint8_t)((alias - cfg->aliases) + 1);
+                cfg->alias_cursor = (cli_size_t)(alias->offset + strlen(&cfg->alias_arena[alias->offset]) + 1);
+                cfg->nof_alias_tokens_left = alias->nof_tokens;
+                is_cmd_loaded = prv_load_next_alias_cmd();
+            }
+            else if (cfg->nof_args >= 1)
+            {
+                // An alias definition keeps its $variables and pipelines - they are handled when the alias runs
+                if (0 != strcmp(cfg->args[0], "alias"))
+                {
+                    for (uint8_t i = 0; i < cfg->nof_args; i++)
+                    {
+                        cfg->args[i] = prv_expand_variable(cfg->args[i]);
+                    }
+                    prv_split_pipeline();
+                }
+                else
+                {
+                    cfg->nof_filters = 0;
+                    cfg->invalid_filter = NULL;
+                }
+                // The binding was looked up when its name was typed - unless it is a $variable or has moved since
+                const cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+                const bool is_resolved = (true == tokens->is_cmd_resolved)
+                                         && (tokens->cmd_generation == cfg->bindings_generation)
+                                         && (cfg->args[0] == &cfg->rx_char_buffer[tokens->starts[0]]);
+                cfg->cmd_binding = (true == is_resolved) ? tokens->cmd_binding : prv_find_cmd(cfg->args[0]);
+                is_cmd_loaded = true;
+            }
+
+            // Empty lines are dropped without any output
+            cfg->process_state = (true == is_cmd_loaded) ? CLI_PROCESS_STATE_HEADER : CLI_PROCESS_STATE_DONE;
+            break;
+        }
+        case CLI_PROCESS_STATE_HEADER:
+        {
+#if defined(CLI_ENABLE_EXECUTOR)
+            if (true == prv_submit_offload())
+            {
+                // Header, output and footer follow when the handler is done - the user can type the next line
+                cfg->process_state = CLI_PROCESS_STATE_DONE;
+                break;
+            }
+#endif
+
+            // plot a line on the console - the caller of cli_execute gets the output of the handler only
+            if ((NULL == cfg->capture_buffer) && (true == prv_is_output_decorated()))
+            {
+                prv_plot_lines(CLI_SECTION_SPACER, CLI_OUTPUT_WIDTH);
+            }
+            cfg->process_state = CLI_PROCESS_STATE_DISPATCH;
+            break;
+        }
+        case CLI_PROCESS_STATE_DISPATCH:
+        {
+            // call the command handler (if available)
+            const cli_binding_t* ptCmdBinding = cfg->cmd_binding;
+            if (NULL != cfg->invalid_filter)
+            {
+                cfg->cmd_status = CLI_FAIL_STATUS;
+                prv_write_const_string("Invalid filter: ");
+                prv_write_string(cfg->invalid_filter);
+                prv_write_char('\n');
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+                if (CLI_OUTPUT_MODE_TEXT != cfg->output_mode)
+                {
+                    prv_write_const_string("Filters work on text output only - use: output text");
+                }
+                else
+#endif
+                {
+                    prv_write_const_string("Use: cmd | grep TEXT, cmd | head N, cmd | count");
+                }
+                prv_write_char('\n');
+            }
+            else if (NULL == ptCmdBinding)
+            {
+                cfg->cmd_status = CLI_FAIL_STATUS;
+                prv_write_cmd_unknown(cfg->args[0]);
+            }
+            else
+            {
+                cfg->is_output_filtered = (cfg->nof_filters > 0) ? true : false;
+                if (cfg->nof_args > cfg->stats.max_nof_args)
+                {
+                    cfg->stats.max_nof_args = cfg->nof_args;
+                }
+#if defined(CLI_ENABLE_STACK_PAINTING)
+                (void)prv_paint_stack(true);
+#endif
+                cfg->cmd_status = ptCmdBinding->cmd_fn(cfg->nof_args, cfg->args, ptCmdBinding->context);
+#if defined(CLI_ENABLE_STACK_PAINTING)
+                const uint32_t nof_stack_bytes = prv_paint_stack(false);
+                if (nof_stack_bytes > cfg->stats.max_dispatch_stack_bytes)
+                {
+                    cfg->stats.max_dispatch_stack_bytes = nof_stack_bytes;
+                }
+#endif
+                cfg->is_output_filtered = false;
+            }
+
+            if (CLI_PENDING_STATUS == cfg->cmd_status)
+            {
+                if (false == prv_is_filter_output_closed())
+                {
+                    // The handler has more to do - it is called again in the next step
+                    cfg->nof_handler_calls++;
+                    break;
+                }
+                // Nothing of the remaining output would get through the filters - like a closed pipe
+                cfg->cmd_status = CLI_OK_STATUS;
+            }
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+            if (cfg->out_depth > 0)
+            {
+                // Whatever the handler left open is closed - the answer of a command is always complete
+                cfg->is_output_filtered = (cfg->nof_filters > 0) ? true : false;
+                prv_out_close_all();
+                cfg->is_output_filtered = false;
+            }
+#endif
+
+            if ((cfg->nof_filters > 0) && (NULL == cfg->invalid_filter))
+            {
+                prv_finish_filters();
+            }
+            cfg->process_state = CLI_PROCESS_STATE_FOOTER;
+            break;
+        }
+        case CLI_PROCESS_STATE_FOOTER:
+        {
+            if (0 != cfg->active_job)
+            {
+                // The partial input of the user is still in the rx buffer - it is written again below the output
+                if ((CLI_OK_STATUS != cfg->cmd_status) && (true == prv_is_output_decorated()))
+                {
+                    prv_write_const_string("Status -> ");
+                    prv_write_const_string(CLI_FAIL_PROMPT_PLAIN);
+                    prv_write_char('\n');
+                }
+                prv_restore_input_line();
+                cfg->transfer_state = CLI_TRANSFER_STATE_OFF; // there is no line a transfer could follow
+                cfg->active_job = 0;
+                cfg->nof_args = 0;
+                cfg->process_state = CLI_PROCESS_STATE_IDLE;
+                break;
+            }
+
+            if (NULL == cfg->capture_buffer)
+            {
+                prv_write_cmd_footer(cfg->cmd_status);
+            }
+
+            // The commands of an alias run one after the other, each with its own header and footer
+            if ((0 != cfg->active_alias) && (true == prv_load_next_alias_cmd()))
+            {
+                cfg->cmd_status = CLI_FAIL_STATUS;
+                cfg->nof_handler_calls = 0;
+                cfg->process_state = CLI_PROCESS_STATE_HEADER;
+                break;
+            }
+            cfg->process_state = CLI_PROCESS_STATE_DONE;
+            break;
+        }
+        case CLI_PROCESS_STATE_DONE:
+        default:
+        {
+            ASSERT(CLI_PROCESS_STATE_DONE == cfg->process_state);
+
+            // Reset the cli buffer for a new user input
+            prv_reset_rx_buffer();
+            cfg->nof_args = 0;
+            cfg->active_alias = 0;
+            cfg->process_state = CLI_PROCESS_STATE_IDLE;
+
+            if (CLI_TRANSFER_STATE_PENDING == cfg->transfer_state)
+            {
+                // A line of cli_execute is not followed by any input a transfer could read
+                if ((CLI_OK_STATUS == cfg->cmd_status) && (NULL == cfg->capture_buffer))
+                {
+                    // The next input belongs to the transfer
+                    prv_begin_transfer();
+                    return true;
+                }
+                cfg->transfer_state = CLI_TRANSFER_STATE_OFF;
+            }
+
+            // The line is finished - further work is only left, if the last input chunk contained more lines
+            // or the user typed ahead
+            return ((cfg->idx_next_transport_char < cfg->nof_pending_transport_chars) || (cfg->nof_typeahead_chars > 0))
+                       ? true
+                       : false;
+        }
+    }
+
+    return true;
+}
+
+static void prv_drain_log_queue(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    bool is_input_line_erased = false;
+
+    // Single consumer - at most one queue length per call, so that busy producers cannot starve the input
+    for (uint32_t nof_messages = 0; nof_messages < CLI_LOG_QUEUE_DEPTH; nof_messages++)
+    {
+        const uint32_t pos = cfg->log_dequeue_pos;
+        cli_log_slot_t* const slot = &cfg->log_slots[pos % CLI_LOG_QUEUE_DEPTH];
+
+        if ((int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - (pos + 1)) < 0)
+        {
+            // The slot has not been published yet - the queue is empty
+            break;
+        }
+
+        prv_write_log_message(slot->message, &is_input_line_erased);
+
+        // Hand the slot back to the producers for the next round
+        __atomic_store_n(&slot->sequence, pos + CLI_LOG_QUEUE_DEPTH, __ATOMIC_RELEASE);
+        cfg->log_dequeue_pos = pos + 1;
+    }
+
+    const uint32_t nof_dropped_logs = __atomic_exchange_n(&cfg->nof_dropped_logs, 0, __ATOMIC_RELAXED);
+    if (nof_dropped_logs > 0)
+    {
+        cfg->stats.nof_dropped_logs += nof_dropped_logs;
+        prv_write_log_message("", &is_input_line_erased);
+        prv_write_uint(nof_dropped_logs);
+        prv_write_const_string(" log messages dropped");
+        prv_write_char('\n');
+    }
+
+    if (true == is_input_line_erased)
+    {
+        prv_restore_input_line();
+    }
+}
+
+static void prv_erase_input_line(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_is_output_decorated())
+    {
+        // The input was not echoed - there is nothing to erase
+        return;
+    }
+
+    if (true == prv_has_terminal_cap(CLI_TERM_CAP_ANSI))
+    {
+        // Input that wrapped past the terminal width covers several rows - go up to the row of the prompt first.
+        // The cursor stays in the last column, when the line ends exactly there, so that row does not count.
+        const uint32_t nof_line_chars = (uint32_t)(sizeof(CLI_PROMPT) - 1)
+                                        + (uint32_t)g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+        const uint32_t nof_wrapped_rows = (nof_line_chars - 1U) / CLI_TERMINAL_WIDTH;
+        if (nof_wrapped_rows > 0)
+        {
+            prv_write_const_string(CLI_CSI);
+            prv_write_uint(nof_wrapped_rows);
+            prv_put_char('A');
+            prv_put_char('\r');
+            prv_write_const_string(CLI_CSI "J"); // erase to the end of the screen - all rows of the line
+        }
+        else
+        {
+            prv_put_char('\r');
+            prv_write_const_string(CLI_CSI "K");
+        }
+    }
+    else
+    {
+        prv_write_char('\n');
+    }
+}
+
+static void prv_restore_input_line(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    if (false == prv_is_output_decorated())
+    {
+        return;
+    }
+
+    // Write again what the user was typing
+    prv_write_const_string(CLI_PROMPT);
+    for (cli_size_t i = 0; i < g_cli_cfg_reference->nof_stored_chars_in_rx_buffer; i++)
+    {
+        prv_write_char(g_cli_cfg_reference->rx_char_buffer[i]);
+    }
+}
+
+static void prv_write_log_message(const char* const in_message, bool* const inout_is_input_line_erased)
+{
+    if (false == *inout_is_input_line_erased)
+    {
+        // Get rid of the current input line - it is written again after the log messages
+        prv_erase_input_line();
+        *inout_is_input_line_erased = true;
+    }
+
+    if ('\0' == in_message[0])
+    {
+        return;
+    }
+    prv_write_string(in_message);
+    prv_write_char('\n');
+}
+
+#if (0 != CLI_FEATURE_HELP)
+static int prv_cmd_handler_help(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const char* prefix = "";
+    bool is_compact = false;
+
+    // help [-c] [prefix]
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], CLI_HELP_COMPACT_FLAG))
+        {
+            is_compact = true;
+        }
+        else
+        {
+            prefix = argv[i];
+        }
+    }
+
+    if (0 == cli_get_continuation_index())
+    {
+        cfg->help_cursor = 0;
+        cfg->nof_listed_bindings = 0;
+    }
+
+    // List a few commands per call - the rest follows in the next processing step
+    for (uint8_t nof_entries = 0; nof_entries < CLI_NOF_HELP_ENTRIES_PER_CALL; nof_entries++)
+    {
+        const cli_binding_t* ptCmdBinding = cli_find_next_binding(prefix, &cfg->help_cursor);
+        if (NULL == ptCmdBinding)
+        {
+            break;
+        }
+
+        if (true == is_compact)
+        {
+            // one line per command
+            prv_write_string(ptCmdBinding->name);
+            prv_write_string(" - ");
+        }
+        else
+        {
+            prv_write_string("* ");
+            prv_write_string(ptCmdBinding->name);
+            prv_write_string(": \n");
+            prv_write_repeated_char(' ', CLI_HELP_INDENT);
+        }
+        prv_write_string(ptCmdBinding->help);
+        prv_write_char('\n');
+        cfg->nof_listed_bindings++;
+    }
+
+    if (cfg->help_cursor < prv_get_nof_bindings())
+    {
+        return CLI_PENDING_STATUS;
+    }
+
+    if (0 == cfg->nof_listed_bindings)
+    {
+        prv_write_const_string("No command starts with: ");
+        prv_write_string(prefix);
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    (void)context;
+
+    return CLI_OK_STATUS;
+}
+#endif
+
+static int prv_cmd_handler_alias(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    (void)context;
+
+    if (0 != g_cli_cfg_reference->active_alias)
+    {
+        // The running alias reads its tokens from the arena - it must not be rearranged now
+        prv_write_const_string("Aliases can not be changed by an alias");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    if (1 == argc)
+    {
+        prv_write_aliases(false);
+        return CLI_OK_STATUS;
+    }
+
+    cli_alias_t* const alias = prv_find_alias(argv[1], false);
+    if (2 == argc)
+    {
+        if (NULL == alias)
+        {
+            prv_write_const_string("Unknown alias: ");
+            prv_write_string(argv[1]);
+            prv_write_char('\n');
+            return CLI_FAIL_STATUS;
+        }
+        prv_remove_alias(alias);
+        return CLI_OK_STATUS;
+    }
+
+    const bool is_append = (0 == strcmp(argv[2], CLI_ALIAS_APPEND_TOKEN)) ? true : false;
+    if ((argc < 4) || ((false == is_append) && (0 != strcmp(argv[2], CLI_ALIAS_DEFINE_TOKEN))))
+    {
+        prv_write_const_string("Usage: alias name = command line, alias name += command line");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    if ((strlen(argv[1]) >= CLI_MAX_CMD_NAME_LENGTH) || (NULL != prv_find_cmd(argv[1])))
+    {
+        prv_write_const_string("Invalid alias name: ");
+        prv_write_string(argv[1]);
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    bool is_stored = false;
+    if ((true == is_append) && (NULL != alias))
+    {
+        is_stored = prv_append_to_alias(alias, &argv[3], argc - 3);
+    }
+    else
+    {
+        if (NULL != alias)
+        {
+            prv_remove_alias(alias);
+        }
+        is_stored = prv_add_alias(argv[1], &argv[3], argc - 3, false);
+    }
+
+    if (false == is_stored)
+    {
+        prv_write_const_string("No space left for aliases and variables");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+    return CLI_OK_STATUS;
+}
+
+static int prv_cmd_handler_set(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    (void)context;
+
+    if (0 != g_cli_cfg_reference->active_alias)
+    {
+        // $variables of the running alias point into the arena - it must not be rearranged now
+        prv_write_const_string("Variables can not be changed by an alias");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    if (1 == argc)
+    {
+        prv_write_aliases(true);
+        return CLI_OK_STATUS;
+    }
+
+    if (argc > 3)
+    {
+        prv_write_const_string("Usage: set name value");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    // A $variable value points into the arena, which is compacted by the removal below - it is copied first
+    char value[CLI_MAX_RX_BUFFER_SIZE];
+    char* value_tokens[1] = {value};
+    if (3 == argc)
+    {
+        const size_t value_length = strlen(argv[2]);
+        ASSERT(value_length < sizeof(value));
+        if (value_length >= sizeof(value))
+        {
+            return CLI_FAIL_STATUS;
+        }
+        memcpy(value, argv[2], value_length + 1);
+    }
+
+    cli_alias_t* const variable = prv_find_alias(argv[1], true);
+    if (NULL != variable)
+    {
+        prv_remove_alias(variable);
+    }
+    else if (2 == argc)
+    {
+        prv_write_const_string("Unknown variable: ");
+        prv_write_string(argv[1]);
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    if ((3 == argc) && (false == prv_add_alias(argv[1], value_tokens, 1, true)))
+    {
+        prv_write_const_string("No space left for aliases and variables");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+    return CLI_OK_STATUS;
+}
+
+static cli_alias_t* prv_find_alias(const char* const in_name, bool in_is_variable)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_name);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    for (uint8_t i = 0; i < cfg->nof_aliases; i++)
+    {
+        cli_alias_t* const alias = &cfg->aliases[i];
+        if (alias->is_variable != in_is_variable)
+        {
+            continue;
+        }
+        CLI_ADD_COST(nof_name_compares, 1);
+        if (0 == strcmp(&cfg->alias_arena[alias->offset], in_name))
+        {
+            return alias;
+        }
+    }
+    return NULL;
+}
+
+static bool prv_add_alias(const char* const in_name, char* in_tokens[], int in_nof_tokens, bool in_is_variable)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_name);
+        ASSERT(in_tokens);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const size_t name_length = strlen(in_name) + 1;
+
+    if ((cfg->nof_aliases >= CLI_MAX_NOF_ALIASES)
+        || (name_length > (size_t)(CLI_ALIAS_ARENA_SIZE - cfg->nof_used_arena_chars)))
+    {
+        return false;
+    }
+
+    cli_alias_t* const alias = &cfg->aliases[cfg->nof_aliases];
+    alias->offset = cfg->nof_used_arena_chars;
+    alias->length = (cli_size_t)name_length;
+    alias->nof_tokens = 0;
+    alias->is_variable = in_is_variable;
+    memcpy(&cfg->alias_arena[alias->offset], in_name, name_length);
+    cfg->nof_used_arena_chars = (cli_size_t)(cfg->nof_used_arena_chars + name_length);
+    cfg->nof_aliases++;
+
+    if (false == prv_append_to_alias(alias, in_tokens, in_nof_tokens))
+    {
+        prv_remove_alias(alias);
+        return false;
+    }
+    return true;
+}
+
+static bool prv_append_to_alias(cli_alias_t* const inout_alias, char* in_tokens[], int in_nof_tokens)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(inout_alias);
+        ASSERT(in_tokens);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const bool is_last_entry =
+        ((inout_alias->offset + inout_alias->length) == cfg->nof_used_arena_chars) ? true : false;
+
+    size_t nof_needed_chars = 0;
+    for (int i = 0; i < in_nof_tokens; i++)
+    {
+        nof_needed_chars += strlen(in_tokens[i]) + 1;
+    }
+    if (false == is_last_entry)
+    {
+        // The entry only grows at the end of the arena - it is copied there first
+        nof_needed_chars += inout_alias->length;
+    }
+
+    if ((nof_needed_chars > (size_t)(CLI_ALIAS_ARENA_SIZE - cfg->nof_used_arena_chars))
+        || ((inout_alias->nof_tokens + in_nof_tokens) > UINT8_MAX))
+    {
+        return false;
+    }
+
+    if (false == is_last_entry)
+    {
+        const cli_size_t old_offset = inout_alias->offset;
+        memcpy(&cfg->alias_arena[cfg->nof_used_arena_chars], &cfg->alias_arena[old_offset], inout_alias->length);
+        inout_alias->offset = cfg->nof_used_arena_chars;
+        cfg->nof_used_arena_chars = (cli_size_t)(cfg->nof_used_arena_chars + inout_alias->length);
+        prv_release_arena_chars(old_offset, inout_alias->length);
+    }
+
+    for (int i = 0; i < in_nof_tokens; i++)
+    {
+        const size_t token_length = strlen(in_tokens[i]) + 1;
+        memcpy(&cfg->alias_arena[cfg->nof_used_arena_chars], in_tokens[i], token_length);
+        cfg->nof_used_arena_chars = (cli_size_t)(cfg->nof_used_arena_chars + token_length);
+        inout_alias->length = (cli_size_t)(inout_alias->length + token_length);
+    }
+    inout_alias->nof_tokens = (uint8_t)(inout_alias->nof_tokens + in_nof_tokens);
+
+    // Resolve the first command again on the next execution
+    inout_alias->cmd_binding = NULL;
+    inout_alias->binding_generation = (uint16_t)(cfg->bindings_generation - 1);
+    return true;
+}
+
+static void prv_remove_alias(cli_alias_t* const inout_alias)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(inout_alias);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    prv_release_arena_chars(inout_alias->offset, inout_alias->length);
+
+    // Move the last entry into the gap - the order of the entries does not matter
+    cfg->nof_aliases--;
+    if (inout_alias != &cfg->aliases[cfg->nof_aliases])
+    {
+        memcpy(inout_alias, &cfg->aliases[cfg->nof_aliases], sizeof(cli_alias_t));
+    }
+}
+
+static void prv_release_arena_chars(cli_size_t in_offset, cli_size_t in_length)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT((in_offset + in_length) <= g_cli_cfg_reference->nof_used_arena_chars);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // Compact the arena - all entries behind the released chars move to the front
+    memmove(&cfg->alias_arena[in_offset], &cfg->alias_arena[in_offset + in_length],
+            (size_t)(cfg->nof_used_arena_chars - (in_offset + in_length)));
+    cfg->nof_used_arena_chars = (cli_size_t)(cfg->nof_used_arena_chars - in_length);
+
+    for (uint8_t i = 0; i < cfg->nof_aliases; i++)
+    {
+        if (cfg->aliases[i].offset > in_offset)
+        {
+            cfg->aliases[i].offset = (cli_size_t)(cfg->aliases[i].offset - in_length);
+        }
+    }
+}
+
+static void prv_write_aliases(bool in_is_variable)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    for (uint8_t i = 0; i < cfg->nof_aliases; i++)
+    {
+        const cli_alias_t* const alias = &cfg->aliases[i];
+        if (alias->is_variable != in_is_variable)
+        {
+            continue;
+        }
+
+        // name = token token ...
+        cli_size_t offset = alias->offset;
+        prv_write_string(&cfg->alias_arena[offset]);
+        prv_write_string(" =");
+        for (uint8_t token = 0; token < alias->nof_tokens; token++)
+        {
+            offset = (cli_size_t)(offset + strlen(&cfg->alias_arena[offset]) + 1);
+            prv_write_char(' ');
+            prv_write_string(&cfg->alias_arena[offset]);
+        }
+        prv_write_char('\n');
+    }
+}
+
+static bool prv_load_next_alias_cmd(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(0 != g_cli_cfg_reference->active_alias);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_alias_t* const alias = &cfg->aliases[cfg->active_alias - 1];
+    const cli_size_t first_token_offset = (cli_size_t)(alias->offset + strlen(&cfg->alias_arena[alias->offset]) + 1);
+    const bool is_first_cmd = (cfg->alias_cursor == first_token_offset) ? true : false;
+
+    // The arguments point straight into the arena - the tokens were split when the alias was defined
+    memset(cfg->args, 0, sizeof(cfg->args));
+    cfg->nof_args = 0;
+    while (cfg->nof_alias_tokens_left > 0)
+    {
+        char* const token = &cfg->alias_arena[cfg->alias_cursor];
+        cfg->alias_cursor = (cli_size_t)(cfg->alias_cursor + strlen(token) + 1);
+        cfg->nof_alias_tokens_left--;
+
+        if (0 == strcmp(token, CLI_ALIAS_CMD_SEPARATOR))
+        {
+            if (cfg->nof_args > 0)
+            {
+                break;
+            }
+            continue; // empty command
+        }
+        if (cfg->nof_args < CLI_MAX_NOF_ARGUMENTS)
+        {
+            cfg->args[cfg->nof_args++] = prv_expand_variable(token);
+        }
+    }
+
+    if (0 == cfg->nof_alias_tokens_left)
+    {
+        for (uint8_t i = 0; (i < cfg->nof_extra_args) && (cfg->nof_args < CLI_MAX_NOF_ARGUMENTS); i++)
+        {
+            cfg->args[cfg->nof_args++] = cfg->extra_args[i];
+        }
+        cfg->nof_extra_args = 0;
+    }
+
+    if (0 == cfg->nof_args)
+    {
+        return false;
+    }
+    prv_split_pipeline();
+
+    // The first command is looked up once and then taken from the cache, until bindings are added or moved.
+    // A command name given as $variable may change with every execution.
+    const bool is_cacheable =
+        ((true == is_first_cmd) && (CLI_VARIABLE_PREFIX != cfg->alias_arena[first_token_offset])) ? true : false;
+    if ((true == is_cacheable) && (alias->binding_generation == cfg->bindings_generation))
+    {
+        cfg->cmd_binding = alias->cmd_binding;
+    }
+    else
+    {
+        cfg->cmd_binding = prv_find_cmd(cfg->args[0]);
+        if (true == is_cacheable)
+        {
+            alias->cmd_binding = cfg->cmd_binding;
+            alias->binding_generation = cfg->bindings_generation;
+        }
+    }
+    return true;
+}
+
+static char* prv_expand_variable(char* const in_arg)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_arg);
+    }
+
+    if (CLI_VARIABLE_PREFIX != in_arg[0])
+    {
+        return in_arg;
+    }
+
+    // Unknown variables are passed on as they are
+    const cli_alias_t* const variable = prv_find_alias(&in_arg[1], true);
+    if ((NULL == variable) || (0 == variable->nof_tokens))
+    {
+        return in_arg;
+    }
+    char* const name = &g_cli_cfg_reference->alias_arena[variable->offset];
+    return &name[strlen(name) + 1];
+}
+
+static int prv_cmd_handler_watch(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    (void)context;
+
+    char* end = NULL;
+    const unsigned long period_ms = (argc >= 3) ? strtoul(argv[1], &end, 10) : 0;
+    if ((argc < 3) || ('\0' != *end) || (0 == period_ms))
+    {
+        prv_write_const_string("Usage: watch ms command line");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    const cli_binding_t* const binding = prv_find_cmd(argv[2]);
+    if (NULL == binding)
+    {
+        prv_write_cmd_unknown(argv[2]);
+        return CLI_FAIL_STATUS;
+    }
+
+    uint8_t job_idx = 0;
+    while ((job_idx < CLI_MAX_NOF_JOBS) && (true == cfg->jobs[job_idx].is_used))
+    {
+        job_idx++;
+    }
+    if (job_idx >= CLI_MAX_NOF_JOBS)
+    {
+        prv_write_const_string("No free job - stop one with kill");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    // Keep the command line split into tokens - running the job needs no parsing
+    cli_job_t* const job = &cfg->jobs[job_idx];
+    size_t nof_line_chars = 0;
+    job->nof_args = 0;
+    for (int i = 2; (i < argc) && (job->nof_args < CLI_MAX_NOF_ARGUMENTS); i++)
+    {
+        const size_t token_length = strlen(argv[i]) + 1;
+        if ((nof_line_chars + token_length) > CLI_JOB_LINE_SIZE)
+        {
+            prv_write_const_string("Command line is too long for a job");
+            prv_write_char('\n');
+            return CLI_FAIL_STATUS;
+        }
+        memcpy(&job->line[nof_line_chars], argv[i], token_length);
+        job->arg_offsets[job->nof_args] = (uint8_t)nof_line_chars;
+        job->nof_args++;
+        nof_line_chars += token_length;
+    }
+
+    job->cmd_binding = binding;
+    job->binding_generation = cfg->bindings_generation;
+    job->period_ticks = (period_ms < CLI_WHEEL_TICK_MS) ? 1U : (uint32_t)(period_ms / CLI_WHEEL_TICK_MS);
+    job->expiry_tick = cfg->current_tick + job->period_ticks;
+    job->is_ready = false;
+    job->is_used = true;
+    prv_insert_job(job_idx);
+
+    prv_write_const_string("Job ");
+    prv_write_uint(job_idx);
+    prv_write_const_string(" started");
+    prv_write_char('\n');
+    return CLI_OK_STATUS;
+}
+
+static int prv_cmd_handler_jobs(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    const cli_cfg_t* const cfg = g_cli_cfg_reference;
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    // N: every MS ms: command line
+    for (uint8_t job_idx = 0; job_idx < CLI_MAX_NOF_JOBS; job_idx++)
+    {
+        const cli_job_t* const job = &cfg->jobs[job_idx];
+        if (false == job->is_used)
+        {
+            continue;
+        }
+        prv_write_uint(job_idx);
+        prv_write_const_string(": every ");
+        prv_write_uint(job->period_ticks * CLI_WHEEL_TICK_MS);
+        prv_write_const_string(" ms:");
+        for (uint8_t arg = 0; arg < job->nof_args; arg++)
+        {
+            prv_write_char(' ');
+            prv_write_string(&job->line[job->arg_offsets[arg]]);
+        }
+        prv_write_char('\n');
+    }
+    return CLI_OK_STATUS;
+}
+
+static int prv_cmd_handler_kill(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    (void)context;
+
+    char* end = NULL;
+    const unsigned long job_idx = (2 == argc) ? strtoul(argv[1], &end, 10) : CLI_MAX_NOF_JOBS;
+    if ((2 != argc) || ('\0' != *end) || (job_idx >= CLI_MAX_NOF_JOBS) || (false == cfg->jobs[job_idx].is_used))
+    {
+        prv_write_const_string("Usage: kill job - see jobs for the job numbers");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    // A job may kill itself - its line stays untouched until the slot is used again
+    prv_unlink_job((uint8_t)job_idx);
+    cfg->jobs[job_idx].is_used = false;
+    cfg->jobs[job_idx].is_ready = false;
+    return CLI_OK_STATUS;
+}
+
+static int prv_cmd_handler_stats(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    (void)context;
+
+    if ((2 == argc) && (0 == strcmp(argv[1], "reset")))
+    {
+        cli_reset_stats();
+        return CLI_OK_STATUS;
+    }
+    if (1 != argc)
+    {
+        prv_write_const_string("Usage: stats [reset]");
+        prv_write_char('\n');
+        return CLI_FAIL_STATUS;
+    }
+
+    cli_stats_t stats;
+    cli_get_stats(&stats);
+
+    // High-water marks next to their limit, then the drop counts
+    prv_write_stat("rx chars      ", stats.max_nof_rx_chars, CLI_MAX_RX_BUFFER_SIZE);
+    prv_write_stat("bindings      ", stats.max_nof_bindings, CLI_MAX_NOF_CALLBACKS);
+    prv_write_stat("args          ", stats.max_nof_args, CLI_MAX_NOF_ARGUMENTS);
+#if defined(CLI_ENABLE_STACK_PAINTING)
+    prv_write_stat("stack bytes   ", stats.max_dispatch_stack_bytes, CLI_STACK_PAINT_SIZE);
+#endif
+    prv_write_stat("rx overflows  ", stats.nof_rx_overflows, 0);
+    prv_write_stat("lost keys     ", stats.nof_lost_typeahead_chars, 0);
+    prv_write_stat("cut arg lists ", stats.nof_cut_arg_lists, 0);
+    prv_write_stat("cut prints    ", stats.nof_truncated_prints, 0);
+    prv_write_stat("dropped logs  ", stats.nof_dropped_logs, 0);
+    return CLI_OK_STATUS;
+}
+
+static void prv_write_stat(const char* const in_name, uint32_t in_value, uint32_t in_limit)
+{
+    { // Input Checks
+        ASSERT(in_name);
+    }
+
+    // NAME VALUE [of LIMIT] - counts have no limit
+    prv_write_const_string(in_name);
+    prv_write_uint(in_value);
+    if (in_limit > 0)
+    {
+        prv_write_const_string(" of ");
+        prv_write_uint(in_limit);
+    }
+    prv_write_char('\n');
+}
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+static int prv_cmd_handler_output(int argc, char* argv[], void* context)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    (void)context;
+
+    static const char* const mode_names[] = {"text", "json", "cbor"}; // by CLI_OUTPUT_MODE_*
+
+    if (1 == argc)
+    {
+        // Answered in the current mode - a host tool gets the mode it can parse
+        cli_out_kv_str(NULL, mode_names[g_cli_cfg_reference->output_mode]);
+        return CLI_OK_STATUS;
+    }
+    for (uint8_t mode = 0; (2 == argc) && (mode < CLI_GET_ARRAY_SIZE(mode_names)); mode++)
+    {
+        if (0 == strcmp(argv[1], mode_names[mode]))
+        {
+            cli_set_output_mode(mode);
+            return CLI_OK_STATUS;
+        }
+    }
+    prv_write_const_string("Usage: output [text|json|cbor]");
+    prv_write_char('\n');
+    return CLI_FAIL_STATUS;
+}
+
+static bool prv_out_begin_item(const char* const in_key, bool in_is_container)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+#if defined(CLI_ENABLE_EXECUTOR)
+        ASSERT(NULL == g_cli_worker_offload); // the cfg belongs to the thread of cli_process
+#endif
+    }
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    if (NULL != g_cli_worker_offload)
+    {
+        return false;
+    }
+#endif
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const uint8_t level_bit = (cfg->out_depth > 0) ? (uint8_t)(1U << (cfg->out_depth - 1U)) : 0U;
+    const bool is_in_map = (cfg->out_depth > 0) && (0U == (cfg->out_array_levels & level_bit));
+
+    // Items of a map have a key, array items and top level values do not
+    ASSERT(is_in_map == (NULL != in_key));
+    if (is_in_map != (NULL != in_key))
+    {
+        return false;
+    }
+
+    switch (cfg->output_mode)
+    {
+        case CLI_OUTPUT_MODE_CBOR:
+        {
+            if (true == is_in_map)
+            {
+                prv_out_write_cbor_string(in_key);
+            }
+            break;
+        }
+        case CLI_OUTPUT_MODE_JSON:
+        {
+            if (0U != (cfg->out_filled_levels & level_bit))
+            {
+                prv_put_char(',');
+            }
+            if (true == is_in_map)
+            {
+                prv_out_write_json_string(in_key);
+                prv_put_char(':');
+            }
+            break;
+        }
+        default:
+        {
+            // "key:" or "-", indented by two spaces per level - top level values stand alone
+            for (uint8_t i = 1; i < cfg->out_depth; i++)
+            {
+                prv_write_const_string("  ");
+            }
+            if (true == is_in_map)
+            {
+                prv_write_string(in_key);
+                prv_put_char(':');
+            }
+            else if (cfg->out_depth > 0)
+            {
+                prv_put_char('-');
+            }
+            if ((false == in_is_container) && (cfg->out_depth > 0))
+            {
+                prv_put_char(' ');
+            }
+            break;
+        }
+    }
+    cfg->out_filled_levels |= level_bit;
+    return true;
+}
+
+static void prv_out_end_item(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    // Text has a line per value, JSON a line per top level value - CBOR items delimit themselves
+    const uint8_t mode = g_cli_cfg_reference->output_mode;
+    if ((CLI_OUTPUT_MODE_TEXT == mode) || ((CLI_OUTPUT_MODE_JSON == mode) && (0 == g_cli_cfg_reference->out_depth)))
+    {
+        prv_write_char('\n');
+    }
+}
+
+static void prv_out_open(const char* const in_key, bool in_is_array)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(g_cli_cfg_reference->out_depth < CLI_OUT_MAX_DEPTH);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if ((cfg->out_depth >= CLI_OUT_MAX_DEPTH) || (false == prv_out_begin_item(in_key, true)))
+    {
+        return;
+    }
+
+    switch (cfg->output_mode)
+    {
+        case CLI_OUTPUT_MODE_CBOR:
+        {
+            prv_put_raw_byte((true == in_is_array) ? 0x9FU : 0xBFU); // indefinite length - no count up front
+            break;
+        }
+        case CLI_OUTPUT_MODE_JSON:
+        {
+            prv_put_char((true == in_is_array) ? '[' : '{');
+            break;
+        }
+        default:
+        {
+            // The "key:" / "-" line of a nested map or array - its items follow on their own lines
+            if (cfg->out_depth > 0)
+            {
+                prv_write_char('\n');
+            }
+            break;
+        }
+    }
+
+    const uint8_t level_bit = (uint8_t)(1U << cfg->out_depth);
+    if (true == in_is_array)
+    {
+        cfg->out_array_levels |= level_bit;
+    }
+    else
+    {
+        cfg->out_array_levels &= (uint8_t)~level_bit;
+    }
+    cfg->out_filled_levels &= (uint8_t)~level_bit;
+    cfg->out_depth++;
+}
+
+static void prv_out_close(bool in_is_array)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+#if defined(CLI_ENABLE_EXECUTOR)
+        ASSERT(NULL == g_cli_worker_offload);
+#endif
+    }
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    if (NULL != g_cli_worker_offload)
+    {
+        return;
+    }
+#endif
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const uint8_t level_bit = (cfg->out_depth > 0) ? (uint8_t)(1U << (cfg->out_depth - 1U)) : 0U;
+    const bool is_array = (0U != (cfg->out_array_levels & level_bit));
+
+    // Only the innermost open map or array can be closed
+    ASSERT((cfg->out_depth > 0) && (in_is_array == is_array));
+    if ((0 == cfg->out_depth) || (in_is_array != is_array))
+    {
+        return;
+    }
+
+    cfg->out_depth--;
+    switch (cfg->output_mode)
+    {
+        case CLI_OUTPUT_MODE_CBOR:
+        {
+            prv_put_raw_byte(0xFFU); // break
+            break;
+        }
+        case CLI_OUTPUT_MODE_JSON:
+        {
+            prv_put_char((true == is_array) ? ']' : '}');
+            if (0 == cfg->out_depth)
+            {
+                prv_write_char('\n');
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+static void prv_out_close_all(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    while (cfg->out_depth > 0)
+    {
+        const uint8_t level_bit = (uint8_t)(1U << (cfg->out_depth - 1U));
+        prv_out_close(0U != (cfg->out_array_levels & level_bit));
+    }
+}
+
+static void prv_out_write_hex(uint32_t in_value)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    static const char hex_digits[] = "0123456789ABCDEF";
+
+    prv_write_const_string("0x");
+    for (int8_t shift = 28; shift >= 0; shift -= 4)
+    {
+        prv_put_char(hex_digits[(in_value >> shift) & 0x0FU]);
+    }
+}
+
+static void prv_out_write_json_string(const char* const in_string)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_string);
+    }
+
+    static const char hex_digits[] = "0123456789abcdef";
+
+    // Quotes, backslashes and control characters are escaped - everything else (UTF-8 too) goes as it is
+    prv_put_char('"');
+    for (const char* current_char = in_string; '\0' != *current_char; current_char++)
+    {
+        const uint8_t byte = (uint8_t)*current_char;
+        if (('"' == *current_char) || ('\\' == *current_char))
+        {
+            prv_put_char('\\');
+            prv_put_char(*current_char);
+        }
+        else if (byte < 0x20U)
+        {
+            prv_write_const_string("\\u00");
+            prv_put_char(hex_digits[byte >> 4]);
+            prv_put_char(hex_digits[byte & 0x0FU]);
+        }
+        else
+        {
+            prv_put_char(*current_char);
+        }
+    }
+    prv_put_char('"');
+}
+
+static void prv_out_write_cbor_head(uint8_t in_major_type, uint32_t in_value)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_major_type <= 7U);
+    }
+
+    // The major type in the upper 3 bits - small values fit into the lower 5, larger ones follow big endian
+    const uint8_t major_bits = (uint8_t)(in_major_type << 5);
+    uint8_t nof_value_bytes = 0;
+
+    if (in_value < 24U)
+    {
+        prv_put_raw_byte((uint8_t)(major_bits | in_value));
+    }
+    else if (in_value <= 0xFFU)
+    {
+        prv_put_raw_byte((uint8_t)(major_bits | 24U));
+        nof_value_bytes = 1;
+    }
+    else if (in_value <= 0xFFFFU)
+    {
+        prv_put_raw_byte((uint8_t)(major_bits | 25U));
+        nof_value_bytes = 2;
+    }
+    else
+    {
+        prv_put_raw_byte((uint8_t)(major_bits | 26U));
+        nof_value_bytes = 4;
+    }
+
+    while (nof_value_bytes > 0)
+    {
+        nof_value_bytes--;
+        prv_put_raw_byte((uint8_t)(in_value >> (8U * nof_value_bytes)));
+    }
+}
+
+static void prv_out_write_cbor_string(const char* const in_string)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_string);
+    }
+
+    // A text string (major type 3) - the length is known up front, so it is not split into chunks
+    prv_out_write_cbor_head(3U, (uint32_t)strlen(in_string));
+    for (const char* current_char = in_string; '\0' != *current_char; current_char++)
+    {
+        prv_put_raw_byte((uint8_t)*current_char);
+    }
+}
+
+static void prv_put_raw_byte(uint8_t in_byte)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // prv_emit_char drops the '\r' of the line ends for cli_execute - binary output has to keep every byte
+    if ((NULL != cfg->capture_buffer) && (false == cfg->is_output_filtered))
+    {
+        if (cfg->nof_captured_chars < (cfg->capture_capacity - 1))
+        {
+            cfg->capture_buffer[cfg->nof_captured_chars] = (char)in_byte;
+            cfg->nof_captured_chars++;
+        }
+        return;
+    }
+    prv_put_char((char)in_byte);
+}
+#endif
+
+static void prv_insert_job(uint8_t in_job_idx)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_job_idx < CLI_MAX_NOF_JOBS);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_job_t* const job = &cfg->jobs[in_job_idx];
+    const uint32_t nof_ticks_to_go = job->expiry_tick - cfg->current_tick;
+    uint32_t slot = 0;
+
+    if (nof_ticks_to_go < CLI_WHEEL_SIZE)
+    {
+        // Level 0 - one slot per tick
+        slot = job->expiry_tick & (CLI_WHEEL_SIZE - 1);
+    }
+    else if (nof_ticks_to_go < (CLI_WHEEL_SIZE * CLI_WHEEL_SIZE))
+    {
+        // Level 1 - one slot per CLI_WHEEL_SIZE ticks, moved to level 0 when its turn has come
+        slot = CLI_WHEEL_SIZE + ((job->expiry_tick / CLI_WHEEL_SIZE) & (CLI_WHEEL_SIZE - 1));
+    }
+    else
+    {
+        // Beyond the wheel - park it in the last level 1 slot, it is sorted in again from there
+        slot = CLI_WHEEL_SIZE + (((cfg->current_tick / CLI_WHEEL_SIZE) - 1) & (CLI_WHEEL_SIZE - 1));
+    }
+
+    job->wheel_slot = (uint8_t)slot;
+    job->prev = CLI_NO_JOB;
+    job->next = cfg->wheel[slot];
+    if (CLI_NO_JOB != job->next)
+    {
+        cfg->jobs[job->next].prev = in_job_idx;
+    }
+    cfg->wheel[slot] = in_job_idx;
+}
+
+static void prv_unlink_job(uint8_t in_job_idx)
 {
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_job_idx < CLI_MAX_NOF_JOBS);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_job_t* const job = &cfg->jobs[in_job_idx];
+
+    if (CLI_NO_JOB != job->prev)
+    {
+        cfg->jobs[job->prev].next = job->next;
+    }
+    else
+    {
+        cfg->wheel[job->wheel_slot] = job->next;
+    }
+    if (CLI_NO_JOB != job->next)
     {
+        cfg->jobs[job->next].prev = job->prev;
+    }
+    job->prev = CLI_NO_JOB;
+    job->next = CLI_NO_JOB;
+}
+
+static void prv_advance_wheel(void)
+{
+    { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    for (const char* current_char = in_string; *current_char != '\0'; current_char++)
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cfg->current_tick++;
+
+    // Every CLI_WHEEL_SIZE ticks the next level 1 slot is spread over level 0
+    if (0 == (cfg->current_tick & (CLI_WHEEL_SIZE - 1)))
     {
-        prv_write_char(*current_char);
+        const uint32_t level_1_slot = CLI_WHEEL_SIZE + ((cfg->current_tick / CLI_WHEEL_SIZE) & (CLI_WHEEL_SIZE - 1));
+        uint8_t job_idx = cfg->wheel[level_1_slot];
+        cfg->wheel[level_1_slot] = CLI_NO_JOB;
+        while (CLI_NO_JOB != job_idx)
+        {
+            const uint8_t next_job_idx = cfg->jobs[job_idx].next;
+            prv_insert_job(job_idx);
+            job_idx = next_job_idx;
+        }
+    }
+
+    // All jobs in the current level 0 slot are due
+    const uint32_t level_0_slot = cfg->current_tick & (CLI_WHEEL_SIZE - 1);
+    uint8_t job_idx = cfg->wheel[level_0_slot];
+    cfg->wheel[level_0_slot] = CLI_NO_JOB;
+    while (CLI_NO_JOB != job_idx)
+    {
+        cli_job_t* const job = &cfg->jobs[job_idx];
+        const uint8_t next_job_idx = job->next;
+
+        // A job that did not run yet is not queued twice - it just keeps its rate
+        job->is_ready = true;
+        job->expiry_tick += job->period_ticks;
+        prv_insert_job(job_idx);
+        job_idx = next_job_idx;
     }
 }
 
-static void prv_write_char(char in_char)
+static bool prv_start_ready_job(void)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    if ('\n' == in_char) // User pressed Enter
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    for (uint8_t job_idx = 0; job_idx < CLI_MAX_NOF_JOBS; job_idx++)
     {
-        prv_put_char('\r');
-        prv_put_char('\n');
+        cli_job_t* const job = &cfg->jobs[job_idx];
+        if ((false == job->is_used) || (false == job->is_ready))
+        {
+            continue;
+        }
+
+        job->is_ready = false;
+        prv_load_job_args(job);
+        cfg->active_job = (uint8_t)(job_idx + 1);
+        cfg->cmd_status = CLI_FAIL_STATUS;
+        cfg->nof_handler_calls = 0;
+        cfg->nof_filters = 0;
+        cfg->invalid_filter = NULL;
+
+        // The job output goes where the user types - the input line is written again afterwards
+        prv_erase_input_line();
+        return true;
     }
-    else if ('\b' == in_char) // User pressed Backspace
+    return false;
+}
+
+static void prv_load_job_args(cli_job_t* const inout_job)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(inout_job);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // The tokens of the job line are used in place
+    memset(cfg->args, 0, sizeof(cfg->args));
+    for (uint8_t arg = 0; arg < inout_job->nof_args; arg++)
     {
-        prv_put_char('\b');
-        prv_put_char(' ');
-        prv_put_char('\b');
+        cfg->args[arg] = &inout_job->line[inout_job->arg_offsets[arg]];
     }
-    else // Every other character
+    cfg->nof_args = inout_job->nof_args;
+
+    // The binding was resolved when the job was started - it is only looked up again when bindings changed
+    if (inout_job->binding_generation != cfg->bindings_generation)
     {
-        prv_put_char(in_char);
+        inout_job->cmd_binding = prv_find_cmd(cfg->args[0]);
+        inout_job->binding_generation = cfg->bindings_generation;
     }
+    cfg->cmd_binding = inout_job->cmd_binding;
 }
 
-static void prv_put_char(char in_char)
+static void prv_begin_transfer(void)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    g_cli_cfg_reference->put_char_fn(in_char);
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    cfg->transfer_offset = cfg->transfer.start_offset;
+    cfg->transfer_seq = 0;
+    cfg->nof_frame_bytes = 0;
+    cfg->is_frame_broken = false;
+    cfg->nof_base64_chars = 0;
+    cfg->base64_bits = 0;
+    cfg->transfer_state = CLI_TRANSFER_STATE_WAIT_FRAME;
+
+    // READY <start offset> <max chunk size>
+    prv_write_const_string("READY ");
+    prv_write_uint(cfg->transfer_offset);
+    prv_put_char(' ');
+    prv_write_uint(CLI_TRANSFER_CHUNK_SIZE);
+    prv_write_char('\n');
 }
 
-static void prv_write_cli_prompt()
+static void prv_receive_transfer_char(char in_char)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    prv_plot_lines(CLI_PROMPT_SPACER, CLI_OUTPUT_WIDTH);
-    prv_write_string("Embedded CLI - Type 'help' to list all commands\n");
-    prv_plot_lines(CLI_PROMPT_SPACER, CLI_OUTPUT_WIDTH);
-    prv_write_string(CLI_PROMPT);
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const uint8_t byte = (uint8_t)in_char;
+
+    if (true == cfg->transfer.is_base64)
+    {
+        prv_receive_base64_char(in_char);
+        return;
+    }
+
+    if (CLI_TRANSFER_STATE_WAIT_FRAME == cfg->transfer_state)
+    {
+        // Everything between frames is ignored - line noise or the echo of a terminal program
+        if (CLI_TRANSFER_STX == byte)
+        {
+            cfg->nof_frame_bytes = 0;
+            cfg->is_frame_broken = false;
+            cfg->transfer_state = CLI_TRANSFER_STATE_IN_FRAME;
+        }
+        else if (CLI_TRANSFER_CAN == byte)
+        {
+            prv_end_transfer(CLI_FAIL_STATUS);
+        }
+        return;
+    }
+
+    prv_add_frame_byte(byte);
+
+    // A broken length can not be trusted to find the end of the frame - wait for the next STX instead
+    const bool is_frame_complete =
+        (cfg->nof_frame_bytes >= CLI_TRANSFER_HEADER_SIZE)
+        && (cfg->nof_frame_bytes == (CLI_TRANSFER_HEADER_SIZE + cfg->frame[2] + CLI_TRANSFER_CRC_SIZE));
+    if ((true == is_frame_complete) || (true == cfg->is_frame_broken))
+    {
+        cfg->transfer_state = CLI_TRANSFER_STATE_WAIT_FRAME;
+        prv_check_frame();
+    }
 }
 
-static void prv_write_cmd_unknown(const char* const in_cmd_name)
+static void prv_receive_base64_char(char in_char)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    prv_write_string("Unknown command: ");
-    prv_write_string(in_cmd_name);
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    uint32_t value = 0;
+
+    if ((char)CLI_TRANSFER_CAN == in_char)
+    {
+        prv_end_transfer(CLI_FAIL_STATUS);
+        return;
+    }
+
+    if ('\n' == in_char)
+    {
+        // The rest of a quadruple shortened by padding: 2 chars -> 1 byte, 3 chars -> 2 bytes
+        if (cfg->nof_base64_chars >= 2)
+        {
+            const uint32_t bits = cfg->base64_bits << (6U * (4U - cfg->nof_base64_chars));
+            prv_add_frame_byte((uint8_t)(bits >> 16));
+            if (3 == cfg->nof_base64_chars)
+            {
+                prv_add_frame_byte((uint8_t)(bits >> 8));
+            }
+        }
+        else if (1 == cfg->nof_base64_chars)
+        {
+            cfg->is_frame_broken = true;
+        }
+
+        prv_check_frame();
+        cfg->nof_frame_bytes = 0;
+        cfg->is_frame_broken = false;
+        cfg->nof_base64_chars = 0;
+        cfg->base64_bits = 0;
+        return;
+    }
+
+    if ((in_char >= 'A') && (in_char <= 'Z'))
+    {
+        value = (uint32_t)(in_char - 'A');
+    }
+    else if ((in_char >= 'a') && (in_char <= 'z'))
+    {
+        value = (uint32_t)(in_char - 'a') + 26U;
+    }
+    else if ((in_char >= '0') && (in_char <= '9'))
+    {
+        value = (uint32_t)(in_char - '0') + 52U;
+    }
+    else if ('+' == in_char)
+    {
+        value = 62U;
+    }
+    else if ('/' == in_char)
+    {
+        value = 63U;
+    }
+    else
+    {
+        // '=' padding, CR and blanks carry no data
+        if (('=' != in_char) && ('\r' != in_char) && (' ' != in_char))
+        {
+            cfg->is_frame_broken = true;
+        }
+        return;
+    }
+
+    cfg->base64_bits = (cfg->base64_bits << 6) | value;
+    cfg->nof_base64_chars++;
+    if (4 == cfg->nof_base64_chars)
+    {
+        prv_add_frame_byte((uint8_t)(cfg->base64_bits >> 16));
+        prv_add_frame_byte((uint8_t)(cfg->base64_bits >> 8));
+        prv_add_frame_byte((uint8_t)cfg->base64_bits);
+        cfg->nof_base64_chars = 0;
+        cfg->base64_bits = 0;
+    }
+}
+
+static void prv_add_frame_byte(uint8_t in_byte)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if (cfg->nof_frame_bytes >= sizeof(cfg->frame))
+    {
+        cfg->is_frame_broken = true;
+        return;
+    }
+    cfg->frame[cfg->nof_frame_bytes] = in_byte;
+    cfg->nof_frame_bytes++;
+
+    if ((CLI_TRANSFER_HEADER_SIZE == cfg->nof_frame_bytes) && (cfg->frame[2] > CLI_TRANSFER_CHUNK_SIZE))
+    {
+        cfg->is_frame_broken = true;
+    }
+}
+
+static void prv_check_frame(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const uint8_t nof_bytes = cfg->nof_frame_bytes;
+
+    if ((0 == nof_bytes) && (false == cfg->is_frame_broken))
+    {
+        return; // empty line
+    }
+
+    const uint8_t payload_length = cfg->frame[2];
+    const bool is_frame_valid =
+        (false == cfg->is_frame_broken) && (nof_bytes >= (CLI_TRANSFER_HEADER_SIZE + CLI_TRANSFER_CRC_SIZE))
+        && (nof_bytes == (CLI_TRANSFER_HEADER_SIZE + payload_length + CLI_TRANSFER_CRC_SIZE))
+        && (prv_crc16(cfg->frame, (size_t)(nof_bytes - CLI_TRANSFER_CRC_SIZE))
+            == (uint16_t)(cfg->frame[nof_bytes - 2] | (cfg->frame[nof_bytes - 1] << 8)));
+    if (false == is_frame_valid)
+    {
+        prv_write_transfer_reply("NAK ", cfg->transfer_seq);
+        return;
+    }
+
+    const uint16_t seq = (uint16_t)(cfg->frame[0] | (cfg->frame[1] << 8));
+    if ((uint16_t)(seq + 1) == cfg->transfer_seq)
+    {
+        // Our ACK got lost - the payload was already delivered
+        prv_write_transfer_reply("ACK ", seq);
+        return;
+    }
+    if (seq != cfg->transfer_seq)
+    {
+        prv_write_transfer_reply("NAK ", cfg->transfer_seq);
+        return;
+    }
+
+    if (0 == payload_length)
+    {
+        prv_write_transfer_reply("ACK ", seq);
+        prv_end_transfer(CLI_OK_STATUS);
+        return;
+    }
+
+    const int status = cfg->transfer.chunk_fn(cfg->transfer_offset, &cfg->frame[CLI_TRANSFER_HEADER_SIZE],
+                                              payload_length, cfg->transfer.context);
+    if (CLI_OK_STATUS != status)
+    {
+        prv_end_transfer(status);
+        return;
+    }
+    cfg->transfer_offset += payload_length;
+    cfg->transfer_seq++;
+    prv_write_transfer_reply("ACK ", seq);
+}
+
+static void prv_end_transfer(int in_status)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    cfg->transfer_state = CLI_TRANSFER_STATE_OFF;
+    if (CLI_OK_STATUS == in_status)
+    {
+        prv_write_transfer_reply("DONE ", cfg->transfer_offset);
+    }
+    else
+    {
+        prv_write_const_string("ABORT");
+        prv_write_char('\n');
+    }
+
+    if (NULL != cfg->transfer.done_fn)
+    {
+        cfg->transfer.done_fn(in_status, cfg->transfer_offset, cfg->transfer.context);
+    }
+}
+
+static void prv_write_transfer_reply(const char* const in_reply, uint32_t in_value)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    prv_write_const_string(in_reply);
+    prv_write_uint(in_value);
     prv_write_char('\n');
-    prv_write_string("Type 'help' to list all commands\n");
 }
 
-static void prv_reset_rx_buffer()
+STATIC uint16_t prv_crc16(const uint8_t* in_data, size_t in_len)
+{
+    // CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF - bitwise, to keep the flash footprint small
+    uint16_t crc = 0xFFFFU;
+    for (size_t i = 0; i < in_len; i++)
+    {
+        crc ^= (uint16_t)(in_data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (0 != (crc & 0x8000U)) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void prv_split_pipeline(void)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    memset(g_cli_cfg_reference->rx_char_buffer, 0, CLI_MAX_RX_BUFFER_SIZE);
-    g_cli_cfg_reference->nof_stored_chars_in_rx_buffer = 0;
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const uint8_t nof_tokens = cfg->nof_args;
+    cli_filter_t* filter = NULL;
+
+    cfg->nof_filters = 0;
+    cfg->invalid_filter = NULL;
+    cfg->nof_chars_in_filter_line = 0;
+
+    // cmd args | name [arg] | name [arg] - the command keeps the tokens in front of the first separator
+    for (uint8_t i = 0; i < nof_tokens; i++)
+    {
+        char* const token = cfg->args[i];
+
+        if (0 == strcmp(token, CLI_PIPELINE_SEPARATOR))
+        {
+            if (NULL == filter)
+            {
+                cfg->nof_args = i;
+            }
+            if ((cfg->nof_filters >= CLI_MAX_NOF_FILTERS) || ((i + 1) == nof_tokens))
+            {
+                cfg->invalid_filter = token;
+                break;
+            }
+
+            filter = &cfg->filters[cfg->nof_filters];
+            cfg->nof_filters++;
+            i++;
+
+            filter->arg = NULL;
+            filter->max_lines = 0;
+            filter->nof_lines = 0;
+            if (0 == strcmp(cfg->args[i], "grep"))
+            {
+                filter->kind = CLI_FILTER_GREP;
+            }
+            else if (0 == strcmp(cfg->args[i], "head"))
+            {
+                filter->kind = CLI_FILTER_HEAD;
+            }
+            else if (0 == strcmp(cfg->args[i], "count"))
+            {
+                filter->kind = CLI_FILTER_COUNT;
+            }
+            else
+            {
+                cfg->invalid_filter = cfg->args[i];
+                break;
+            }
+        }
+        else if (NULL != filter)
+        {
+            if ((NULL != filter->arg) || (CLI_FILTER_COUNT == filter->kind))
+            {
+                cfg->invalid_filter = token;
+                break;
+            }
+            filter->arg = token;
+            filter->max_lines = (uint32_t)strtoul(token, NULL, 10);
+        }
+    }
+
+    // Check the mandatory arguments
+    for (uint8_t i = 0; (NULL == cfg->invalid_filter) && (i < cfg->nof_filters); i++)
+    {
+        if ((CLI_FILTER_COUNT != cfg->filters[i].kind) && (NULL == cfg->filters[i].arg))
+        {
+            cfg->invalid_filter = (CLI_FILTER_GREP == cfg->filters[i].kind) ? "grep" : "head";
+        }
+    }
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+    // The filters split text lines and add CR LF - JSON and CBOR would come out broken
+    if ((NULL == cfg->invalid_filter) && (cfg->nof_filters > 0) && (CLI_OUTPUT_MODE_TEXT != cfg->output_mode))
+    {
+        cfg->invalid_filter = CLI_PIPELINE_SEPARATOR;
+    }
+#endif
 }
 
-static bool prv_is_rx_buffer_full()
+static void prv_filter_char(char in_char)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
-    return (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer < CLI_MAX_RX_BUFFER_SIZE) ? false : true;
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    if ('\r' == in_char)
+    {
+        return; // the line ends are written again by prv_filter_line
+    }
+
+    if (('\n' == in_char) || (cfg->nof_chars_in_filter_line >= CLI_FILTER_LINE_SIZE))
+    {
+        cfg->filter_line[cfg->nof_chars_in_filter_line] = '\0';
+        prv_filter_line(0, cfg->filter_line, cfg->nof_chars_in_filter_line);
+        cfg->nof_chars_in_filter_line = 0;
+
+        if ('\n' == in_char)
+        {
+            return;
+        }
+    }
+
+    cfg->filter_line[cfg->nof_chars_in_filter_line] = in_char;
+    cfg->nof_chars_in_filter_line++;
 }
 
-static char prv_get_last_recv_char_from_rx_buffer(void)
+static void prv_filter_line(uint8_t in_first_filter, const char* const in_line, cli_size_t in_length)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_line);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // All filters work on the same line - it is only written out when it passes all of them
+    for (uint8_t i = in_first_filter; i < cfg->nof_filters; i++)
+    {
+        cli_filter_t* const filter = &cfg->filters[i];
+        switch (filter->kind)
+        {
+            case CLI_FILTER_GREP:
+            {
+                if (NULL == strstr(in_line, filter->arg))
+                {
+                    return;
+                }
+                break;
+            }
+            case CLI_FILTER_HEAD:
+            {
+                if (filter->nof_lines >= filter->max_lines)
+                {
+                    return;
+                }
+                filter->nof_lines++;
+                break;
+            }
+            case CLI_FILTER_COUNT:
+            default:
+            {
+                filter->nof_lines++;
+                return;
+            }
+        }
+    }
+
+    for (cli_size_t i = 0; i < in_length; i++)
+    {
+        prv_emit_char(in_line[i]);
     }
-    return g_cli_cfg_reference->rx_char_buffer[g_cli_cfg_reference->nof_stored_chars_in_rx_buffer - 1];
+    prv_emit_char('\r');
+    prv_emit_char('\n');
 }
 
-static const cli_binding_t* prv_find_cmd(const char* const in_cmd_name)
+static void prv_finish_filters(void)
 {
     { // Input Checks
         prv_verify_object_integrity(g_cli_cfg_reference);
-        ASSERT(in_cmd_name);
-        ASSERT(g_cli_cfg_reference->nof_stored_cmd_bindings > 0);
     }
 
-    for (uint8_t idx = 0; idx < g_cli_cfg_reference->nof_stored_cmd_bindings; ++idx)
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+
+    // An unterminated last line
+    if (cfg->nof_chars_in_filter_line > 0)
     {
-        const cli_binding_t* cmd_binding = &g_cli_cfg_reference->cmd_bindings_buffer[idx];
-        if (0 == strncmp(cmd_binding->name, in_cmd_name, CLI_MAX_CMD_NAME_LENGTH))
+        cfg->filter_line[cfg->nof_chars_in_filter_line] = '\0';
+        prv_filter_line(0, cfg->filter_line, cfg->nof_chars_in_filter_line);
+        cfg->nof_chars_in_filter_line = 0;
+    }
+
+    // The result of a count is a line for the filters behind it
+    for (uint8_t i = 0; i < cfg->nof_filters; i++)
+    {
+        if (CLI_FILTER_COUNT == cfg->filters[i].kind)
         {
-            return cmd_binding;
+            char count[11];
+            const uint8_t length = prv_format_uint((uint32_t)cfg->filters[i].nof_lines, count);
+            prv_filter_line((uint8_t)(i + 1), count, (cli_size_t)length);
         }
     }
-    return NULL;
-}
-
-static void prv_clear_screen(void)
-{
-    // ANSI escape code to clear screen and move cursor to home
-    cli_print("\033[2J\033[H");
 }
 
-static uint8_t prv_get_args_from_rx_buffer(char* array_of_arguments[], uint8_t max_arguments)
+static bool prv_is_filter_output_closed(void)
 {
     { // Input Checks
-        ASSERT(array_of_arguments);
-        ASSERT(max_arguments > 0);
-
         prv_verify_object_integrity(g_cli_cfg_reference);
     }
 
-    uint8_t nof_identified_arguments = 0;
-    char* next_argument = NULL;
+    const cli_cfg_t* const cfg = g_cli_cfg_reference;
 
-    // Process the Buffer - tokenize arguments separated by spaces or newlines
-    for (uint8_t i = 0; i < g_cli_cfg_reference->nof_stored_chars_in_rx_buffer; i++)
+    // A used up head lets nothing pass anymore - unless a count in front of it still needs all lines
+    for (uint8_t i = 0; i < cfg->nof_filters; i++)
     {
-        ASSERT(nof_identified_arguments <= max_arguments);
-
-        char* const current_char = &g_cli_cfg_reference->rx_char_buffer[i];
-        const bool is_delimiter_char = (' ' == *current_char || '\n' == *current_char);
-        const bool is_last_char = (i == (g_cli_cfg_reference->nof_stored_chars_in_rx_buffer - 1));
-
-        if (is_delimiter_char)
+        if (CLI_FILTER_COUNT == cfg->filters[i].kind)
         {
-            // Found delimiter - terminate current argument if any
-            *current_char = '\0';
-            if (next_argument != NULL)
-            {
-                array_of_arguments[nof_identified_arguments] = next_argument;
-                nof_identified_arguments++;
-                next_argument = NULL;
-            }
+            return false;
         }
-        else
+        if ((CLI_FILTER_HEAD == cfg->filters[i].kind) && (cfg->filters[i].nof_lines >= cfg->filters[i].max_lines))
         {
-            // Non-delimiter character
-            if (next_argument == NULL)
-            {
-                // Start of new argument
-                next_argument = current_char;
-            }
-
-            // Handle last character if it's not a delimiter
-            if (is_last_char && next_argument != NULL)
-            {
-                array_of_arguments[nof_identified_arguments] = next_argument;
-                nof_identified_arguments++;
-                next_argument = NULL;
-            }
+            return true;
         }
     }
-
-    return nof_identified_arguments;
+    return false;
 }
 
-static int prv_cmd_handler_help(int argc, char* argv[], void* context)
+#if defined(CLI_ENABLE_STACK_PAINTING)
+static __attribute__((noinline)) uint32_t prv_paint_stack(bool in_is_painting)
 {
-    { // Input Checks
-        prv_verify_object_integrity(g_cli_cfg_reference);
-    }
+    // Painting and checking use the frame of this function, so both see the same area - right below the frame of
+    // the caller, where the handler that is called in between puts its frames. The stack grows downwards.
+    // Reading it back is the point - the area is only accessed through a pointer the compiler cannot see through.
+    uint8_t area[CLI_STACK_PAINT_SIZE];
+    volatile uint8_t* volatile bytes = area;
 
-    // Create a list of all registered commands
-    for (uint8_t i = 0; i < g_cli_cfg_reference->nof_stored_cmd_bindings; ++i)
+    if (true == in_is_painting)
     {
-        const cli_binding_t* ptCmdBinding = &g_cli_cfg_reference->cmd_bindings_buffer[i];
-        prv_write_string("* ");
-        prv_write_string(ptCmdBinding->name);
-        prv_write_string(": \n              ");
-        prv_write_string(ptCmdBinding->help);
-        prv_write_char('\n');
+        for (uint32_t i = 0; i < CLI_STACK_PAINT_SIZE; i++)
+        {
+            bytes[i] = CLI_STACK_PAINT_PATTERN;
+        }
+        return 0;
     }
 
-    (void)argc;
-    (void)argv;
-    (void)context;
+    // The pattern left at the low end was never reached
+    uint32_t nof_untouched_bytes = 0;
+    while ((nof_untouched_bytes < CLI_STACK_PAINT_SIZE) && (CLI_STACK_PAINT_PATTERN == bytes[nof_untouched_bytes]))
+    {
+        nof_untouched_bytes++;
+    }
+    return CLI_STACK_PAINT_SIZE - nof_untouched_bytes;
+}
+#endif
 
-    return CLI_OK_STATUS;
+static void prv_verify_api_integrity(const cli_cfg_t* const in_ptCfg)
+{
+    // CLI_INTEGRITY_TIER 1 and 2 - the public functions
+#if (CLI_INTEGRITY_TIER >= 1)
+    prv_check_object_integrity(in_ptCfg);
+#else
+    (void)in_ptCfg;
+#endif
 }
 
 static void prv_verify_object_integrity(const cli_cfg_t* const in_ptCfg)
 {
+    // CLI_INTEGRITY_TIER 2 - every function, an empty call is removed by the compiler otherwise
+#if (CLI_INTEGRITY_TIER >= 2)
+    prv_check_object_integrity(in_ptCfg);
+#else
+    (void)in_ptCfg;
+#endif
+}
+
+#if (CLI_INTEGRITY_TIER > 0)
+static void prv_check_object_integrity(const cli_cfg_t* const in_ptCfg)
+{
+    CLI_ADD_COST(nof_integrity_checks, 1);
     ASSERT(in_ptCfg);
     ASSERT(in_ptCfg->rx_char_buffer);
     ASSERT(in_ptCfg->put_char_fn);
@@ -560,20 +4427,130 @@ static void prv_verify_object_integrity(const cli_cfg_t* const in_ptCfg)
     ASSERT(CLI_CANARY == in_ptCfg->end_canary_word);
     ASSERT(in_ptCfg->nof_stored_chars_in_rx_buffer <= CLI_MAX_RX_BUFFER_SIZE);
 }
+#endif
 
 static void prv_plot_lines(char in_char, int length)
 {
     ASSERT(length < 100);
 
-    for (int counter = 0; counter < length; ++counter)
+#if (0 != CLI_FEATURE_DECORATION)
+    prv_write_repeated_char(in_char, length);
+    prv_write_char('\n');
+#else
+    (void)in_char;
+#endif
+}
+
+static bool prv_is_output_decorated(void)
+{
+    // Called for every received character - the callers have checked the object already
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+    // A program reads JSON and CBOR - the echo, rulers and status lines would only break its parser
+    return (CLI_OUTPUT_MODE_TEXT == g_cli_cfg_reference->output_mode) ? true : false;
+#else
+    return true;
+#endif
+}
+
+static bool prv_has_terminal_cap(uint8_t in_terminal_cap)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+    return (0 != (g_cli_cfg_reference->terminal_caps & in_terminal_cap)) ? true : false;
+}
+
+static void prv_write_uint(uint32_t in_value)
+{
+    char digits[11] = {0};
+    const uint8_t nof_digits = prv_format_uint(in_value, digits);
+
+    for (uint8_t i = 0; i < nof_digits; i++)
     {
-        prv_write_char(in_char);
+        prv_put_char(digits[i]);
     }
-    prv_write_char('\n');
 }
 
+static uint8_t prv_format_uint(uint32_t in_value, char* const out_digits)
+{
+    { // Input Checks
+        ASSERT(out_digits);
+    }
+
+    char reversed[10] = {0}; // 4294967295 has 10 digits
+    uint8_t nof_digits = 0;
+
+    do
+    {
+        reversed[nof_digits] = (char)('0' + (in_value % 10U));
+        nof_digits++;
+        in_value /= 10U;
+    } while (in_value > 0U);
+
+    // out_digits must hold 11 chars - the digits and the '\0'
+    for (uint8_t i = 0; i < nof_digits; i++)
+    {
+        out_digits[i] = reversed[nof_digits - 1 - i];
+    }
+    out_digits[nof_digits] = '\0';
+    return nof_digits;
+}
+
+#if (0 != CLI_FEATURE_DECORATION) || (0 != CLI_FEATURE_HELP) // rulers and the help indent
+static void prv_write_repeated_char(char in_char, int in_count)
+{
+    { // Input Checks
+        ASSERT(in_count >= 0);
+        ASSERT(('\n' != in_char) && ('\b' != in_char));
+    }
+
+    // Filters and cli_execute get the plain characters - an escape sequence would end up in their lines
+    if ((true == prv_has_terminal_cap(CLI_TERM_CAP_REP)) && (in_count >= CLI_MIN_REP_LENGTH)
+        && (false == g_cli_cfg_reference->is_output_filtered) && (NULL == g_cli_cfg_reference->capture_buffer))
+    {
+        // Print the character once and let the terminal repeat it: "c ESC [ n b"
+        prv_put_char(in_char);
+        prv_write_string(CLI_CSI);
+        prv_write_uint((uint32_t)(in_count - 1));
+        prv_put_char('b');
+        return;
+    }
+
+    for (int counter = 0; counter < in_count; ++counter)
+    {
+        prv_put_char(in_char);
+    }
+}
+#endif
+
+static void prv_erase_chars(cli_size_t in_nof_chars)
+{
+    if (0 == in_nof_chars)
+    {
+        return;
+    }
+
+    // "\b \b" costs 3 bytes per character, "ESC [ n D ESC [ K" a constant 6 to 8 bytes
+    if ((true == prv_has_terminal_cap(CLI_TERM_CAP_ANSI)) && (in_nof_chars > 2))
+    {
+        prv_write_string(CLI_CSI);
+        prv_write_uint(in_nof_chars);
+        prv_write_string("D" CLI_CSI "K");
+        return;
+    }
+
+    for (cli_size_t i = 0; i < in_nof_chars; i++)
+    {
+        prv_put_char('\b');
+        prv_put_char(' ');
+        prv_put_char('\b');
+    }
+}
+
+#if (0 != CLI_FEATURE_AUTOCOMPLETE)
 STATIC void prv_find_matching_strings(const char* in_partial_string, const char* const in_string_array[],
-                                      uint8_t in_nof_strings, const char* out_matches_array[], uint8_t* out_nof_matches)
+                                      cli_size_t in_nof_strings, const char* out_matches_array[],
+                                      cli_size_t* out_nof_matches)
 {
     { // Input checks
         ASSERT(in_partial_string);
@@ -582,8 +4559,8 @@ STATIC void prv_find_matching_strings(const char* in_partial_string, const char*
         ASSERT(out_matches_array);
         ASSERT(out_nof_matches);
     }
-    uint8_t in_string_idx = 0;
-    uint8_t out_matches_idx = 0;
+    cli_size_t in_string_idx = 0;
+    cli_size_t out_matches_idx = 0;
 
     for (in_string_idx = 0; in_string_idx < in_nof_strings; ++in_string_idx)
     {
@@ -603,7 +4580,7 @@ STATIC void prv_find_matching_strings(const char* in_partial_string, const char*
     ASSERT(*out_nof_matches <= in_nof_strings);
 }
 
-static bool prv_is_char_in_string(char character, const char* in_string, uint8_t string_length)
+static bool prv_is_char_in_string(char character, const char* in_string, cli_size_t string_length)
 {
     { // Input Checks
         ASSERT(in_string);
@@ -614,7 +4591,7 @@ static bool prv_is_char_in_string(char character, const char* in_string, uint8_t
 
     // Check that there is no ' ' character in the rx buffer - no autocompletes on arguments; only commands
     // 'cmd' + ' ' + 'args[]'
-    for (uint8_t i = 0; i < string_length; i++)
+    for (cli_size_t i = 0; i < string_length; i++)
     {
         if (character == in_string[i])
         {
@@ -639,43 +4616,391 @@ static void prv_autocomplete_command(void)
                                                g_cli_cfg_reference->nof_stored_chars_in_rx_buffer);
     if (false == is_command_string)
     {
+        prv_autocomplete_argument();
         return;
     }
 
-    // Create a copy of the command names and place them in an array
-    const char* command_names[CLI_MAX_NOF_CALLBACKS] = {0};
-    for (uint8_t i = 0; i < g_cli_cfg_reference->nof_stored_cmd_bindings; i++)
+    // Go through the command names in chunks - the stack usage stays the same for any table size
+    const char* first_match = NULL;
+    cli_size_t nof_matches = 0;
+
+    const cli_size_t nof_bindings = prv_get_nof_bindings();
+
+    for (cli_size_t chunk_start = 0; (chunk_start < nof_bindings) && (nof_matches < 2);
+         chunk_start += CLI_AUTOCOMPLETE_CHUNK_SIZE)
     {
-        command_names[i] = g_cli_cfg_reference->cmd_bindings_buffer[i].name;
-    }
+        const char* command_names[CLI_AUTOCOMPLETE_CHUNK_SIZE] = {0};
+        const char* matches[CLI_AUTOCOMPLETE_CHUNK_SIZE] = {0};
+        cli_size_t nof_chunk_matches = 0;
+        cli_size_t nof_chunk_names = 0;
 
-    const char* matches[CLI_MAX_NOF_CALLBACKS] = {0};
-    uint8_t nof_matches = 0;
+        while ((nof_chunk_names < CLI_AUTOCOMPLETE_CHUNK_SIZE)
+               && ((chunk_start + nof_chunk_names) < nof_bindings))
+        {
+            command_names[nof_chunk_names] = prv_get_binding((cli_size_t)(chunk_start + nof_chunk_names))->name;
+            nof_chunk_names++;
+        }
+
+        prv_find_matching_strings(g_cli_cfg_reference->rx_char_buffer, command_names, nof_chunk_names, matches,
+                                  &nof_chunk_matches);
+        if ((NULL == first_match) && (nof_chunk_matches > 0))
+        {
+            first_match = matches[0];
+        }
+        nof_matches = (cli_size_t)(nof_matches + nof_chunk_matches);
+    }
 
-    prv_find_matching_strings(g_cli_cfg_reference->rx_char_buffer, command_names,
-                              g_cli_cfg_reference->nof_stored_cmd_bindings, matches, &nof_matches);
     if (nof_matches == 1)
     {
-        ASSERT(strlen(matches[0]) > 0);
+        ASSERT(strlen(first_match) > 0);
 
         // Only one match - autocomplete the command
         // If there are more matches, then the user needs to provide more letters for specification
+        cli_size_t nof_typed_chars = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+        bool is_typed_prefix = (0 == strncmp(first_match, g_cli_cfg_reference->rx_char_buffer, nof_typed_chars));
+
+        // The match is found anywhere in the command name. Only when the typed input is its prefix the
+        // console already shows the beginning of the command - otherwise the typed input needs to be erased
+        cli_size_t nof_kept_chars = (true == is_typed_prefix) ? nof_typed_chars : 0;
+        prv_erase_chars((cli_size_t)(nof_typed_chars - nof_kept_chars));
+
+        // Replace the content of the rx buffer with the match
+        memset(g_cli_cfg_reference->rx_char_buffer, 0, CLI_MAX_RX_BUFFER_SIZE);
+        strncpy(g_cli_cfg_reference->rx_char_buffer, first_match, CLI_MAX_RX_BUFFER_SIZE - 1);
+        g_cli_cfg_reference->nof_stored_chars_in_rx_buffer = (cli_size_t)strlen(first_match);
+        prv_rescan_rx_buffer();
+
+        // Write only the part of the autocompleted command that is not yet on the console
+        prv_write_string(&g_cli_cfg_reference->rx_char_buffer[nof_kept_chars]);
+    }
+}
+
+static void prv_autocomplete_argument(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    char* const rx = cfg->rx_char_buffer;
+    const cli_size_t nof_typed_chars = cfg->nof_stored_chars_in_rx_buffer;
+
+    // The command name must be complete - and there must be room for at least one more character
+    if ((0 == tokens->nof_tokens) || ((1 == tokens->nof_tokens) && (true == tokens->is_token_open))
+        || (tokens->nof_tokens > CLI_MAX_NOF_ARGUMENTS) || ((nof_typed_chars + 1) >= CLI_MAX_RX_BUFFER_SIZE))
+    {
+        return;
+    }
+    if ((false == tokens->is_cmd_resolved) || (tokens->cmd_generation != cfg->bindings_generation))
+    {
+        prv_resolve_rx_cmd(tokens->ends[0]);
+    }
+
+    const cli_binding_t* const binding = tokens->cmd_binding;
+    if ((NULL == binding) || (NULL == binding->complete_fn))
+    {
+        return;
+    }
 
-        // Calculate how many characters we need to delete (current input)
-        uint8_t chars_to_delete = g_cli_cfg_reference->nof_stored_chars_in_rx_buffer;
+    // Streamed arguments are gone from the rx buffer - they still count
+    const cli_size_t nof_typed_args = (cli_size_t)(tokens->nof_tokens - 1);
+    const int arg_idx = (int)(cfg->nof_streamed_args + nof_typed_args + ((true == tokens->is_token_open) ? 0 : 1));
+    const cli_size_t prefix_start = (true == tokens->is_token_open) ? tokens->starts[nof_typed_args] : nof_typed_chars;
+    const char* const prefix = &rx[prefix_start];
+    const size_t prefix_length = (size_t)(nof_typed_chars - prefix_start);
 
-        // Delete the current input from the display and the rx buffer
-        for (uint8_t i = 0; i < chars_to_delete; i++)
+    // The free part of the rx buffer holds the common part of the matches behind the prefix - no extra stack
+    // is needed, and anything longer would not fit into the line anyway. One char is kept for the delimiter.
+    rx[nof_typed_chars] = '\0';
+    char* const common = &rx[nof_typed_chars + 1];
+    const size_t max_common_length = (size_t)(CLI_MAX_RX_BUFFER_SIZE - nof_typed_chars - 2);
+    size_t common_length = 0;
+    bool is_common_complete = false; // the common part is a whole candidate
+    uint16_t nof_matches = 0;
+
+    for (uint16_t idx = 0; idx < UINT16_MAX; idx++)
+    {
+        const char* const candidate = binding->complete_fn(arg_idx, prefix, idx, binding->context);
+        if (NULL == candidate)
+        {
+            break;
+        }
+        if (0 != strncmp(candidate, prefix, prefix_length))
         {
-            g_cli_cfg_reference->rx_char_buffer[i] = '\0';
-            prv_write_char('\b');
+            continue;
         }
 
-        // Replace the content of the rx buffer with the match
-        strncpy(g_cli_cfg_reference->rx_char_buffer, matches[0], CLI_MAX_RX_BUFFER_SIZE);
-        g_cli_cfg_reference->nof_stored_chars_in_rx_buffer = strlen(matches[0]);
+        const char* const suffix = &candidate[prefix_length];
+        if (0 == nof_matches)
+        {
+            // A candidate with a space would become several arguments - only the part before it is used
+            const size_t suffix_length = strcspn(suffix, " \n");
+            common_length = (suffix_length < max_common_length) ? suffix_length : max_common_length;
+            memcpy(common, suffix, common_length);
+            is_common_complete = (common_length == suffix_length);
+        }
+        else
+        {
+            size_t nof_equal_chars = 0;
+            while ((nof_equal_chars < common_length) && (common[nof_equal_chars] == suffix[nof_equal_chars]))
+            {
+                nof_equal_chars++;
+            }
+            is_common_complete = (nof_equal_chars == common_length) && ('\0' == suffix[nof_equal_chars])
+                                 && (true == is_common_complete);
+            common_length = nof_equal_chars;
+        }
+        nof_matches++;
+    }
+
+    if ((nof_matches > 1) && (0 == common_length))
+    {
+        memset(common, 0, max_common_length + 1);
+        prv_list_completions(binding, arg_idx, prefix);
+        return;
+    }
+
+    // The common part is typed for the user - a single match is finished with its delimiter
+    for (size_t i = 0; i < common_length; i++)
+    {
+        prv_receive_char(rx[nof_typed_chars + 1 + i]);
+    }
+    memset(&rx[cfg->nof_stored_chars_in_rx_buffer], 0,
+           (size_t)(CLI_MAX_RX_BUFFER_SIZE - cfg->nof_stored_chars_in_rx_buffer));
+    if ((1 == nof_matches) && (true == is_common_complete))
+    {
+        prv_receive_char(' ');
+    }
+}
+
+static void prv_list_completions(const cli_binding_t* const in_binding, int in_arg_idx, const char* const in_prefix)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+        ASSERT(in_binding);
+        ASSERT(in_binding->complete_fn);
+        ASSERT(in_prefix);
+    }
+
+    const size_t prefix_length = strlen(in_prefix);
+    cli_size_t line_length = 0;
+
+    // The matches are printed above the input line, which is written again below them
+    prv_erase_input_line();
+    for (uint16_t idx = 0; idx < UINT16_MAX; idx++)
+    {
+        const char* const candidate = in_binding->complete_fn(in_arg_idx, in_prefix, idx, in_binding->context);
+        if (NULL == candidate)
+        {
+            break;
+        }
+        if (0 != strncmp(candidate, in_prefix, prefix_length))
+        {
+            continue;
+        }
+
+        const cli_size_t candidate_length = (cli_size_t)strlen(candidate);
+        if ((line_length > 0) && ((line_length + 2 + candidate_length) > CLI_OUTPUT_WIDTH))
+        {
+            prv_write_char('\n');
+            line_length = 0;
+        }
+        if (line_length > 0)
+        {
+            prv_write_const_string("  ");
+            line_length = (cli_size_t)(line_length + 2);
+        }
+        prv_write_string(candidate);
+        line_length = (cli_size_t)(line_length + candidate_length);
+    }
+    prv_write_char('\n');
+    prv_restore_input_line();
+}
+#endif
+
+#if defined(CLI_ENABLE_EXECUTOR)
+static bool prv_is_line_offloaded(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    cli_rx_tokens_t* const tokens = &cfg->rx_tokens;
+    const char* const rx = cfg->rx_char_buffer;
+
+    // Looked at before the line is tokenized - the same rules as in prv_submit_offload, as far as they are known
+    if ((NULL == cfg->executor) || (cfg->nof_offloads >= CLI_MAX_NOF_OFFLOADS) || (0 == tokens->nof_tokens)
+        || (true == tokens->is_token_open) || (tokens->nof_tokens > CLI_MAX_NOF_ARGUMENTS)
+        || (CLI_VARIABLE_PREFIX == rx[tokens->starts[0]]))
+    {
+        return false;
+    }
+    if ((false == tokens->is_cmd_resolved) || (tokens->cmd_generation != cfg->bindings_generation))
+    {
+        prv_resolve_rx_cmd(tokens->ends[0]);
+    }
+    const cli_executor_t* const executor = cfg->executor;
+    if ((NULL == tokens->cmd_binding) || (false == executor->is_offloaded(executor->context, tokens->cmd_binding)))
+    {
+        return false;
+    }
+
+    // Pipelines run inline
+    for (cli_size_t i = 1; i < tokens->nof_tokens; i++)
+    {
+        if ((tokens->ends[i] == (tokens->starts[i] + 1)) && (CLI_PIPELINE_SEPARATOR[0] == rx[tokens->starts[i]]))
+        {
+            return false;
+        }
+    }
+
+    // Aliases shadow commands
+    char name[CLI_MAX_CMD_NAME_LENGTH];
+    const cli_size_t name_length = (cli_size_t)(tokens->ends[0] - tokens->starts[0]);
+    if (name_length >= CLI_MAX_CMD_NAME_LENGTH)
+    {
+        return false;
+    }
+    memcpy(name, &rx[tokens->starts[0]], name_length);
+    name[name_length] = '\0';
+    return (NULL == prv_find_alias(name, false)) ? true : false;
+}
+
+static bool prv_submit_offload(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    const cli_executor_t* const executor = cfg->executor;
+    const cli_binding_t* const binding = cfg->cmd_binding;
+
+    if ((NULL == executor) || (NULL == binding) || (cfg->nof_offloads >= CLI_MAX_NOF_OFFLOADS)
+        || (0 != cfg->active_alias) || (0 != cfg->active_job) || (NULL != cfg->capture_buffer)
+        || (0 != cfg->nof_filters) || (NULL != cfg->invalid_filter)
+        || (false == executor->is_offloaded(executor->context, binding)))
+    {
+        return false;
+    }
+
+    const uint8_t offload_idx = (uint8_t)((cfg->oldest_offload + cfg->nof_offloads) % CLI_MAX_NOF_OFFLOADS);
+    cli_offload_t* const offload = &cfg->offloads[offload_idx];
+    ASSERT(CLI_OFFLOAD_STATE_FREE == offload->state);
+
+    // The arguments are copied - the rx buffer takes the next line while the handler runs
+    size_t nof_used_chars = 0;
+    for (uint8_t i = 0; i < cfg->nof_args; i++)
+    {
+        const size_t arg_size = strlen(cfg->args[i]) + 1;
+        if ((nof_used_chars + arg_size) > sizeof(offload->line))
+        {
+            // $variables made the line longer than the rx buffer - it runs inline
+            return false;
+        }
+        memcpy(&offload->line[nof_used_chars], cfg->args[i], arg_size);
+        offload->args[i] = &offload->line[nof_used_chars];
+        nof_used_chars += arg_size;
+    }
+    offload->nof_args = cfg->nof_args;
+    offload->cmd_fn = binding->cmd_fn;
+    offload->context = binding->context;
+    offload->status = CLI_FAIL_STATUS;
+    offload->nof_handler_calls = 0;
+    offload->nof_output_chars = 0;
+    offload->output[0] = '\0';
+    offload->is_output_truncated = false;
+    offload->state = CLI_OFFLOAD_STATE_RUNNING;
+
+    if (false == executor->submit(executor->context, offload))
+    {
+        offload->state = CLI_OFFLOAD_STATE_FREE;
+        return false;
+    }
+    cfg->nof_offloads++;
+    return true;
+}
+
+static void prv_finish_offloads(void)
+{
+    { // Input Checks
+        prv_verify_object_integrity(g_cli_cfg_reference);
+    }
+
+    cli_cfg_t* const cfg = g_cli_cfg_reference;
+    bool is_input_line_erased = false;
+
+    // In the order of submission - a done offload waits for the ones before it
+    while (cfg->nof_offloads > 0)
+    {
+        cli_offload_t* const offload = &cfg->offloads[cfg->oldest_offload];
+        if (CLI_OFFLOAD_STATE_DONE != __atomic_load_n(&offload->state, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        if (false == is_input_line_erased)
+        {
+            prv_erase_input_line();
+            is_input_line_erased = true;
+        }
+        if (true == prv_is_output_decorated())
+        {
+            prv_plot_lines(CLI_SECTION_SPACER, CLI_OUTPUT_WIDTH);
+        }
+        prv_write_string(offload->output);
+        if (true == offload->is_output_truncated)
+        {
+            cfg->stats.nof_truncated_prints++;
+            prv_write_const_string("Output truncated");
+            prv_write_char('\n');
+        }
+        prv_write_cmd_footer(offload->status);
 
-        // Write the autocompleted command to the console
-        prv_write_string(g_cli_cfg_reference->rx_char_buffer);
+        offload->state = CLI_OFFLOAD_STATE_FREE;
+        cfg->oldest_offload = (uint8_t)((cfg->oldest_offload + 1) % CLI_MAX_NOF_OFFLOADS);
+        cfg->nof_offloads--;
+    }
+
+    if (true == is_input_line_erased)
+    {
+        prv_restore_input_line();
+    }
+}
+
+static void prv_print_to_offload(cli_offload_t* const inout_offload, const char* const fmt, va_list args)
+{
+    { // Input Checks
+        ASSERT(inout_offload);
+        ASSERT(fmt);
+    }
+
+    // Whole lines only - a line that does not fit is dropped together with all after it
+    const size_t capacity = (size_t)(CLI_OFFLOAD_OUTPUT_SIZE - inout_offload->nof_output_chars);
+    char* const line = &inout_offload->output[inout_offload->nof_output_chars];
+#if (0 != CLI_FEATURE_PRINT_FORMATTER)
+    const int length = (true == inout_offload->is_output_truncated) ? -1 : vsnprintf(line, capacity, fmt, args);
+#else
+    (void)args;
+    const size_t fmt_length = strlen(fmt);
+    const bool is_fitting = (false == inout_offload->is_output_truncated) && (fmt_length < capacity);
+    const int length = (true == is_fitting) ? (int)fmt_length : -1;
+    if (true == is_fitting)
+    {
+        memcpy(line, fmt, fmt_length);
+    }
+#endif
+
+    if ((length < 0) || (((size_t)length + 2) > capacity))
+    {
+        line[0] = '\0';
+        inout_offload->is_output_truncated = true;
+        return;
     }
+    line[length] = '\n';
+    line[length + 1] = '\0';
+    inout_offload->nof_output_chars = (cli_size_t)(inout_offload->nof_output_chars + length + 1);
 }
+#endif
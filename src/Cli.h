@@ -30,44 +30,418 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include "cli_config.h"
+
 #define CLI_OK_STATUS                (0)
 #define CLI_FAIL_STATUS              (-1)
+#define CLI_PENDING_STATUS           (0x7FFF) /* call me again in the next step - far away from usual error codes */
+
+/* The limits below can be overridden from the build system (e.g. -DCLI_MAX_NOF_CALLBACKS=1000) */
+#if !defined(CLI_MAX_NOF_CALLBACKS)
+#define CLI_MAX_NOF_CALLBACKS (10)
+#endif
+
+/* Type of all counters and indices into the binding table and the rx buffer - a custom type needs its max too */
+#if !defined(CLI_SIZE_TYPE)
+#define CLI_SIZE_TYPE     uint16_t
+#define CLI_SIZE_TYPE_MAX UINT16_MAX
+#endif
+
+/* Open addressing hash table over the command names - keep it at least twice as large as the binding table */
+#if !defined(CLI_CMD_INDEX_SIZE)
+#define CLI_CMD_INDEX_SIZE ((2 * CLI_MAX_NOF_CALLBACKS) + 1)
+#endif
 
-#define CLI_MAX_NOF_CALLBACKS        (10)
 #define CLI_MAX_CMD_NAME_LENGTH      (32)
 #define CLI_MAX_HELPER_STRING_LENGTH (64)
 
-#define CLI_MAX_RX_BUFFER_SIZE       (128)
+#if !defined(CLI_MAX_RX_BUFFER_SIZE)
+#define CLI_MAX_RX_BUFFER_SIZE (128)
+#endif
+
+/* Characters received while a line waits for cli_process or runs - they are taken as input when it is done */
+#if !defined(CLI_TYPEAHEAD_SIZE)
+#define CLI_TYPEAHEAD_SIZE (16)
+#endif
+
+#define CLI_MAX_NOF_ARGUMENTS        (16)
+
+/* Columns of the terminal - input that wraps past them is erased row by row, when log lines are printed above it */
+#if !defined(CLI_TERMINAL_WIDTH)
+#define CLI_TERMINAL_WIDTH (80)
+#endif
+
+/* Aliases and variables share one table and one arena, which holds their names and pre-tokenized values */
+#if !defined(CLI_MAX_NOF_ALIASES)
+#define CLI_MAX_NOF_ALIASES (8)
+#endif
+
+#if !defined(CLI_ALIAS_ARENA_SIZE)
+#define CLI_ALIAS_ARENA_SIZE (512)
+#endif
+
+#define CLI_TX_BUFFER_SIZE           (128) /* output is gathered here, when a transport is used */
+#define CLI_MAX_NOF_TX_IOVECS        (8)
+#define CLI_TRANSPORT_RX_CHUNK_SIZE  (32)
+
+#define CLI_MAX_NOF_FILTERS          (3)  /* cmd | filter | filter ... */
+#define CLI_FILTER_LINE_SIZE         (80) /* longer output lines are split for the filters */
+
+/* Periodic jobs ("watch") - a two level timer wheel with CLI_WHEEL_SIZE slots per level */
+#if !defined(CLI_MAX_NOF_JOBS)
+#define CLI_MAX_NOF_JOBS (4)
+#endif
+#define CLI_JOB_LINE_SIZE            (48) /* command line of a job, including the '\0' of each token */
+#define CLI_WHEEL_TICK_MS            (10) /* resolution of the job periods */
+#define CLI_WHEEL_SIZE               (64) /* must be a power of two - covers 64 * 64 ticks */
+
+#define CLI_TRANSFER_CHUNK_SIZE      (64) /* max payload bytes per transfer frame */
+
+#define CLI_LOG_QUEUE_DEPTH          (8) /* must be a power of two */
+#define CLI_LOG_MESSAGE_SIZE         (64)
+
+#define CLI_PRINT_BUFFER_SIZE        (128) /* a cli_print line is cut after CLI_PRINT_BUFFER_SIZE - 1 chars */
+
+/* Stack painting (CLI_ENABLE_STACK_PAINTING) - the area below cli_process that is checked around each handler */
+#if !defined(CLI_STACK_PAINT_SIZE)
+#define CLI_STACK_PAINT_SIZE (1024)
+#endif
+
+#define CLI_TERM_CAP_NONE            (0x00U) /* dumb terminal - printable characters, '\b' and CR/LF only */
+#define CLI_TERM_CAP_ANSI            (0x01U) /* CSI cursor movement, erase to end of line and SGR colors */
+#define CLI_TERM_CAP_REP             (0x02U) /* CSI Ps b - repeat the preceding graphic character (ECMA-48) */
+
+#define CLI_WORK_LINE_READY          (0x01U) /* a complete line waits for cli_process - or is processed in steps */
+#define CLI_WORK_OUTPUT_PENDING      (0x02U) /* queued log lines or gathered output wait for cli_process */
+#define CLI_WORK_INPUT_PENDING       (0x04U) /* the transport or the type-ahead has input cli_process has not read */
+#define CLI_WORK_JOB_DUE             (0x08U) /* a job expired and runs with the next cli_process call */
+#define CLI_WORK_JOB_SCHEDULED       (0x10U) /* a job waits for its next period - cli_tick is due at the deadline */
+#define CLI_WORK_OFFLOAD_RUNNING     (0x20U) /* a handler runs on the executor - its output follows when it is done */
+
+/* Executor for command handlers (CLI_ENABLE_EXECUTOR) - needs thread local storage and atomics */
+#if !defined(CLI_MAX_NOF_OFFLOADS)
+#define CLI_MAX_NOF_OFFLOADS (2)
+#endif
+#define CLI_OFFLOAD_OUTPUT_SIZE      (256) /* output of an offloaded handler, the rest is dropped */
+
+/* Structured output (cli_out_*) - how maps, arrays and values are written */
+#define CLI_OUTPUT_MODE_TEXT         (0U) /* "key: value" lines, indented by nesting - for people */
+#define CLI_OUTPUT_MODE_JSON         (1U) /* compact JSON, one line per top level value */
+#define CLI_OUTPUT_MODE_CBOR         (2U) /* CBOR (RFC 8949) with indefinite length maps and arrays */
+#define CLI_OUT_MAX_DEPTH            (8)  /* nesting of maps and arrays */
 
 #define CLI_GET_ARRAY_SIZE(arr)      (sizeof(arr) / sizeof(arr[0]))
 
+    typedef CLI_SIZE_TYPE cli_size_t;
+
     typedef int (*cli_cmd_fn)(int argc, char* argv[], void* context);
 
+    /**
+     * Streaming argument delivery - called with each argument of a typed line as soon as it is complete, so
+     * the argument list of a line can be longer than the rx buffer. in_arg_idx starts at 1 with every line
+     * (handlers reset their state there) and in_arg is only valid during the call. Returning anything but
+     * CLI_OK_STATUS drops the remaining arguments of the line. The cmd_fn is called with argv[0] only, when
+     * the line ends. Lines that are not typed (aliases, jobs) pass all arguments in argv as usual.
+     */
+    typedef int (*cli_arg_fn)(int in_arg_idx, const char* in_arg, void* context);
+
+    /**
+     * Argument completion - called on Tab while argument in_arg_idx (1 for the first one) of the line is typed.
+     * Returns candidate in_idx (0, 1, ...) for that argument, NULL when there are no more. The candidates are
+     * asked for one by one, so the application needs no list of them - e.g. it can walk a directory - and each
+     * one only has to stay valid until the next call. Candidates that do not start with in_prefix are skipped.
+     * The cli inserts the longest common prefix of the matches, or lists them when there is nothing to insert.
+     */
+    typedef const char* (*cli_complete_fn)(int in_arg_idx, const char* in_prefix, uint16_t in_idx, void* context);
+
     typedef int (*cli_put_char_fn)(char c);
 
+    typedef uint32_t (*cli_clock_fn)(void); // free running microsecond counter - wrap arounds are fine
+
+    typedef void (*cli_line_fn)(void* context); // a line was completed by cli_receive - called in its context
+
+    typedef struct
+    {
+        const void* base;
+        size_t len;
+    } cli_iovec_t;
+
+    /**
+     * Byte stream the cli reads its input from and writes its output to - instead of cli_receive and the
+     * put_char_fn. All functions get the context pointer and must not block, except writev, which has to
+     * consume all bytes (or drop them) before it returns. flush and poll_ready are optional (NULL).
+     */
+    typedef struct
+    {
+        int (*read)(void* context, char* out_data, size_t in_capacity); // returns the nof bytes read, 0 if none
+        int (*writev)(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+        int (*flush)(void* context);
+        bool (*poll_ready)(void* context); // true, when read would return data
+        void* context;
+    } cli_transport_t;
+
     typedef struct
     {
         const char name[CLI_MAX_CMD_NAME_LENGTH];
         cli_cmd_fn cmd_fn;
         void* context;
         const char help[CLI_MAX_HELPER_STRING_LENGTH];
+        cli_arg_fn arg_fn;           // optional - streaming argument delivery, see cli_arg_fn
+        cli_complete_fn complete_fn; // optional - Tab completion of the arguments, see cli_complete_fn
     } cli_binding_t;
 
+/* Index entries a registry needs for its bindings - twice as many keep the probe chains short */
+#define CLI_REGISTRY_INDEX_SIZE(nof_bindings) ((2 * (nof_bindings)) + 1)
+
+    /**
+     * Command bindings shared by cli instances - built and frozen once (cli_registry_build), then only read. The
+     * bindings are not copied into the instances: each one keeps only a small overlay of CLI_MAX_NOF_CALLBACKS
+     * bindings for its own commands (cli_register, the built-in commands). Only one cli instance runs at a time
+     * for now (see cli_init) - the instances that use a registry are initialized one after the other.
+     */
+    typedef struct
+    {
+        const cli_binding_t* bindings; // the application's table - not copied, so it can live in flash
+        const cli_size_t* index;       // open addressing hash over the names - binding idx + 1 per slot, 0 if empty
+        cli_size_t nof_bindings;
+        cli_size_t index_size;
+        uint8_t is_frozen;
+    } cli_registry_t;
+
+    typedef struct
+    {
+        cli_size_t offset; // into the arena: the name and then each token, all '\0' terminated
+        cli_size_t length; // nof arena chars used by this entry
+        uint8_t nof_tokens;
+        uint8_t is_variable;
+        uint16_t binding_generation;     // cmd_binding is valid as long as this matches the cfg's generation
+        const cli_binding_t* cmd_binding; // resolved binding of the first command of an alias
+    } cli_alias_t;
+
+    /**
+     * Gets the payload of each transfer frame in order - in_offset counts from the start of the whole transfer.
+     * Returning anything else than CLI_OK_STATUS aborts the transfer.
+     */
+    typedef int (*cli_chunk_fn)(uint32_t in_offset, const uint8_t* in_data, size_t in_len, void* context);
+
+    /** Called once, when a transfer ends - with CLI_OK_STATUS or the status that aborted it. */
+    typedef void (*cli_transfer_done_fn)(int in_status, uint32_t in_nof_bytes, void* context);
+
+    typedef struct
+    {
+        cli_chunk_fn chunk_fn;
+        cli_transfer_done_fn done_fn; // optional
+        void* context;
+        uint32_t start_offset; // resume an interrupted transfer - the sender skips the bytes before this offset
+        uint8_t is_base64;     // one base64 encoded frame per line instead of raw binary frames
+    } cli_transfer_t;
+
+    typedef struct
+    {
+        uint8_t kind;
+        const char* arg; // grep pattern - points into the rx buffer or the alias arena
+        uint32_t max_lines;
+        uint32_t nof_lines; // lines that reached this filter
+    } cli_filter_t;
+
+    typedef struct
+    {
+        uint32_t period_ticks;
+        uint32_t expiry_tick;
+        const cli_binding_t* cmd_binding; // valid as long as binding_generation matches the cfg's generation
+        uint16_t binding_generation;
+        uint8_t is_used;
+        uint8_t is_ready; // expired, runs with the next cli_process call
+        uint8_t prev;     // neighbours in the wheel slot list - CLI_MAX_NOF_JOBS marks the end
+        uint8_t next;
+        uint8_t wheel_slot;
+        uint8_t nof_args;
+        uint8_t arg_offsets[CLI_MAX_NOF_ARGUMENTS]; // into line
+        char line[CLI_JOB_LINE_SIZE];
+    } cli_job_t;
+
+    typedef struct
+    {
+        uint32_t sequence; // written by cli_log (producers) and cli_process (consumer) with atomics only
+        char message[CLI_LOG_MESSAGE_SIZE];
+    } cli_log_slot_t;
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    /** A command line that runs on the executor - the cli does not touch it between submit and done */
+    typedef struct
+    {
+        uint8_t state; // CLI_OFFLOAD_STATE_* - changes to done with atomics only
+        uint8_t nof_args;
+        uint8_t is_output_truncated;
+        int status;
+        uint16_t nof_handler_calls;
+        cli_cmd_fn cmd_fn; // copied, the binding may be unregistered while the handler runs
+        void* context;
+        char* args[CLI_MAX_NOF_ARGUMENTS]; // point into line
+        char line[CLI_MAX_RX_BUFFER_SIZE];
+        cli_size_t nof_output_chars;
+        char output[CLI_OFFLOAD_OUTPUT_SIZE];
+    } cli_offload_t;
+
+    /**
+     * Runs command handlers somewhere else than in cli_process - e.g. on the thread pool of a host build.
+     * is_offloaded picks the bindings that go there. submit hands an offload over, which a worker then passes
+     * to cli_run_offload. It returns false, when it can not take it - the handler runs inline then.
+     */
+    typedef struct
+    {
+        bool (*is_offloaded)(void* context, const cli_binding_t* in_binding);
+        bool (*submit)(void* context, cli_offload_t* inout_offload);
+        void* context;
+    } cli_executor_t;
+#endif
+
+    /** Token boundaries of the typed line - advanced with every received character, so Enter only terminates them */
+    typedef struct
+    {
+        cli_size_t starts[CLI_MAX_NOF_ARGUMENTS];
+        cli_size_t ends[CLI_MAX_NOF_ARGUMENTS]; // rx buffer idx of the delimiter that closed the token
+        cli_size_t nof_tokens;                  // tokens beyond CLI_MAX_NOF_ARGUMENTS are counted only
+        uint8_t is_token_open;                  // the last token has no delimiter yet
+        uint8_t is_cmd_resolved;                // the first token is closed and cmd_binding was looked up
+        uint16_t cmd_generation;                // bindings_generation at the lookup
+        const cli_binding_t* cmd_binding;       // NULL for unknown commands
+    } cli_rx_tokens_t;
+
+    /** Work the cli did - counted with CLI_ENABLE_COST_COUNTERS only, for count based performance tests. */
+    typedef struct
+    {
+        uint32_t nof_sink_calls; // put_char_fn and transport writev calls
+        uint32_t nof_sink_bytes;
+        uint32_t nof_integrity_checks;
+        uint32_t nof_name_compares; // of command, alias and variable names
+    } cli_cost_counters_t;
+
+    /** High-water marks and drop counts since cli_init or cli_reset_stats - to size the buffers from real use. */
+    typedef struct
+    {
+        cli_size_t max_nof_rx_chars;       // of CLI_MAX_RX_BUFFER_SIZE
+        cli_size_t max_nof_bindings;       // of CLI_MAX_NOF_CALLBACKS
+        uint8_t max_nof_args;              // largest argc a handler was called with, of CLI_MAX_NOF_ARGUMENTS
+        uint32_t nof_rx_overflows;         // lines dropped with "Buffer is full"
+        uint32_t nof_lost_typeahead_chars; // received while a line was processed and CLI_TYPEAHEAD_SIZE was used up
+        uint32_t nof_cut_arg_lists;        // lines with more than CLI_MAX_NOF_ARGUMENTS arguments
+        uint32_t nof_truncated_prints;     // cli_print lines cut to CLI_PRINT_BUFFER_SIZE, offload outputs cut
+        uint32_t nof_dropped_logs;         // cli_log lines that did not fit into the queue
+        uint32_t max_dispatch_stack_bytes; // with CLI_ENABLE_STACK_PAINTING only, of CLI_STACK_PAINT_SIZE
+    } cli_stats_t;
+
     typedef struct
     {
         uint32_t start_canary_word;
         cli_put_char_fn put_char_fn;
+        cli_clock_fn clock_fn;
+        cli_line_fn line_fn;
+        void* line_context;
+        const cli_transport_t* transport;
         uint8_t is_initialized;
+        uint8_t terminal_caps;
 
-        uint8_t nof_stored_chars_in_rx_buffer;
+        cli_size_t nof_stored_chars_in_rx_buffer;
         char rx_char_buffer[CLI_MAX_RX_BUFFER_SIZE];
+        cli_rx_tokens_t rx_tokens;
+        char typeahead_chars[CLI_TYPEAHEAD_SIZE];
+        uint8_t nof_typeahead_chars;
+        const cli_binding_t* stream_binding; // receives the arguments of the typed line, NULL if none
+        cli_size_t stream_token_start;       // rx buffer idx of the argument that is received next
+        uint16_t nof_streamed_args;
+        int stream_status;
+
+        uint8_t process_state;
+        uint8_t nof_args;
+        char* args[CLI_MAX_NOF_ARGUMENTS];
+        int cmd_status;
+        uint16_t nof_handler_calls;
+        const cli_binding_t* cmd_binding; // resolved while tokenizing, NULL for unknown commands
+        uint8_t active_alias;             // alias idx + 1 while an alias is executed, 0 otherwise
+        uint8_t nof_alias_tokens_left;
+        cli_size_t alias_cursor; // arena offset of the next alias token
+        uint8_t nof_extra_args;
+        char* extra_args[CLI_MAX_NOF_ARGUMENTS]; // arguments typed after the alias name
+
+        uint8_t nof_filters;
+        uint8_t is_output_filtered;       // set while the handler of a pipeline runs
+        const char* invalid_filter;       // reported instead of running the command
+        cli_filter_t filters[CLI_MAX_NOF_FILTERS];
+        cli_size_t nof_chars_in_filter_line;
+        char filter_line[CLI_FILTER_LINE_SIZE + 1];
+
+        uint8_t active_job; // job idx + 1 while a job is executed, 0 otherwise
+
+        char* capture_buffer; // the output of cli_execute goes here instead of to the terminal, NULL otherwise
+        size_t capture_capacity;
+        size_t nof_captured_chars;
+
+        uint8_t transfer_state;
+        cli_transfer_t transfer;
+        uint32_t transfer_offset;
+        uint16_t transfer_seq; // of the next expected frame
+        uint8_t nof_frame_bytes;
+        uint8_t is_frame_broken;
+        uint8_t nof_base64_chars; // of the current quadruple
+        uint32_t base64_bits;
+        uint8_t frame[CLI_TRANSFER_CHUNK_SIZE + 5]; // seq (2), length (1), payload, crc (2)
+#if (0 != CLI_FEATURE_HELP)
+        cli_size_t help_cursor;
+        cli_size_t nof_listed_bindings;
+#endif
+
+        cli_size_t nof_stored_chars_in_tx_buffer;
+        uint8_t nof_tx_iovecs;
+        char tx_char_buffer[CLI_TX_BUFFER_SIZE];
+        cli_iovec_t tx_iovecs[CLI_MAX_NOF_TX_IOVECS];
+
+        uint8_t nof_pending_transport_chars;
+        uint8_t idx_next_transport_char;
+        char transport_rx_buffer[CLI_TRANSPORT_RX_CHUNK_SIZE];
         uint32_t mid_canary_word;
 
-        uint8_t nof_stored_cmd_bindings;
-        cli_binding_t cmd_bindings_buffer[CLI_MAX_NOF_CALLBACKS];
+        const cli_registry_t* registry; // shared bindings - looked up before the overlay below, NULL if none
+        cli_size_t nof_stored_cmd_bindings;
+        cli_binding_t cmd_bindings_buffer[CLI_MAX_NOF_CALLBACKS]; // the overlay - bindings of this instance only
+        cli_size_t cmd_index[CLI_CMD_INDEX_SIZE]; // binding idx + 1 per hash slot, 0 marks an empty slot
+        uint16_t bindings_generation;             // changes whenever bindings are added or moved
+
+        uint8_t nof_aliases;
+        cli_alias_t aliases[CLI_MAX_NOF_ALIASES];
+        cli_size_t nof_used_arena_chars;
+        char alias_arena[CLI_ALIAS_ARENA_SIZE];
+
+        cli_job_t jobs[CLI_MAX_NOF_JOBS];
+        uint8_t wheel[2 * CLI_WHEEL_SIZE]; // first job per slot, level 0 slots first
+        uint8_t is_wheel_started;
+        uint32_t current_tick;
+        uint32_t last_tick_ms;
+
+        cli_log_slot_t log_slots[CLI_LOG_QUEUE_DEPTH];
+        uint32_t log_enqueue_pos;
+        uint32_t log_dequeue_pos;
+        uint32_t nof_dropped_logs;
+
+        cli_stats_t stats;
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+        uint8_t output_mode;       // CLI_OUTPUT_MODE_*
+        uint8_t out_depth;         // nof open maps and arrays
+        uint8_t out_array_levels;  // bit (depth - 1) is set, when that level is an array - a map otherwise
+        uint8_t out_filled_levels; // bit (depth - 1) is set, when that level has an item - JSON needs a ','
+#endif
+
+#if defined(CLI_ENABLE_EXECUTOR)
+        const cli_executor_t* executor;
+        uint8_t oldest_offload; // offloads are finished in the order they were submitted
+        uint8_t nof_offloads;
+        cli_offload_t offloads[CLI_MAX_NOF_OFFLOADS];
+#endif
         uint32_t end_canary_word;
     } cli_cfg_t;
 
@@ -75,16 +449,235 @@ extern "C"
 
     void cli_register(const cli_binding_t* const in_binding);
 
+#if (0 != CLI_FEATURE_UNREGISTER)
     void cli_unregister(const char* const in_cmd_name);
+#endif
+
+    /**
+     * Builds a shared registry over in_bindings: checks them, fills in_index (at least in_nof_bindings + 1 entries,
+     * CLI_REGISTRY_INDEX_SIZE is a good size) and freezes the registry. The bindings and the index are referenced,
+     * not copied - they have to outlive the registry. Needs no cli instance, so it can run once at startup.
+     * Returns false, when a binding is invalid or a name is used twice - the registry stays unusable then.
+     */
+    bool cli_registry_build(cli_registry_t* const out_registry, const cli_binding_t* in_bindings,
+                            cli_size_t in_nof_bindings, cli_size_t* const in_index, cli_size_t in_index_size);
+
+    /**
+     * Gives the cli instance the commands of a built registry (NULL takes them away again). Commands are looked up
+     * in the registry first and then in the overlay of the instance, help and Tab completion list both. A name must
+     * not be in both - cli_register refuses names of the registry. Registry commands can not be unregistered.
+     */
+    void cli_set_registry(const cli_registry_t* const in_registry);
 
     void cli_receive(char in_char);
 
     void cli_process(void);
 
+    /**
+     * Processes a received line in small steps (tokenize, header, dispatch, footer) and returns as soon as
+     * in_max_us microseconds - measured with the clock from cli_set_clock - are used up. At least one step is
+     * done per call. A command handler itself is never interrupted. Without a clock one step is done per call.
+     * Up to CLI_TYPEAHEAD_SIZE characters received while a line is processed are kept and received again when it is
+     * done - further ones are counted in nof_lost_typeahead_chars of cli_stats_t.
+     * Returns true when there is work left for the next call.
+     */
+    bool cli_process_budget(uint32_t in_max_us);
+
+    void cli_set_clock(cli_clock_fn in_clock_fn);
+
+    /**
+     * Tells what cli_process would do right now, without doing it - so the main loop can sleep until there is
+     * work. Returns a mask of CLI_WORK_* bits, 0 when the cli is idle. With CLI_WORK_JOB_SCHEDULED set,
+     * out_next_deadline_ms (optional) receives the time - on the cli_tick clock - at which the next job expires.
+     * Transport input is only seen with a poll_ready function, otherwise the main loop has to wait for it itself.
+     */
+    uint8_t cli_poll(uint32_t* const out_next_deadline_ms);
+
+    /**
+     * Calls in_line_fn whenever cli_receive completes a line - e.g. to wake up the main loop from an interrupt.
+     * NULL removes the callback. Lines read from a transport are not reported, cli_process reads them itself.
+     */
+    void cli_set_line_callback(cli_line_fn in_line_fn, void* in_context);
+
+#if defined(CLI_ENABLE_EXECUTOR)
+    /**
+     * Hands the handlers of the bindings the executor picks over to it (NULL runs all handlers inline again).
+     * The line is copied, so the user can type the next one while the handler runs. Its output is gathered in
+     * the offload and printed by cli_process, in the order the lines were entered, followed by the status. The
+     * next line waits while handlers are running, unless it is offloaded as well. Lines of aliases and jobs,
+     * pipelines and cli_execute always run inline. No offload may be running when the executor is changed.
+     */
+    void cli_set_executor(const cli_executor_t* in_executor);
+
+    /**
+     * Runs the handler of an offload until it is done - to be called by the executor on a worker thread. Within
+     * the handler only cli_print (it goes to the offload), cli_get_continuation_index and cli_log may be used.
+     */
+    void cli_run_offload(cli_offload_t* const inout_offload);
+#endif
+
+    /**
+     * Routes all input and output through the given transport (NULL switches back to cli_receive and the
+     * put_char_fn). Input is pulled by cli_process, output is gathered and written with one writev call per
+     * cli_receive / cli_process call (or whenever the tx buffer runs full). The transport must stay valid.
+     */
+    void cli_set_transport(const cli_transport_t* in_transport);
+
     void cli_receive_and_process(char in_char);
 
+#if defined(CLI_ENABLE_COST_COUNTERS)
+    void cli_get_cost_counters(cli_cost_counters_t* const out_counters);
+
+    void cli_reset_cost_counters(void);
+#endif
+
+    /**
+     * Copies the high-water marks and drop counts - see cli_stats_t. With CLI_ENABLE_STACK_PAINTING the stack
+     * below cli_process is painted before each command handler and checked after it, so the deepest stack use
+     * of a handler (and the functions it calls) is known as well - up to CLI_STACK_PAINT_SIZE bytes.
+     */
+    void cli_get_stats(cli_stats_t* const out_stats);
+
+    /** Starts the high-water marks again from the current use and clears the drop counts. */
+    void cli_reset_stats(void);
+
+    /**
+     * Runs a command line right away and returns its status - for RPC bridges and tests. The line is tokenized
+     * and dispatched like a typed one (aliases, $variables and pipelines included), but nothing is echoed and
+     * there are no rulers, status line or prompt. All output of the handler goes to out_buffer instead of the
+     * terminal, with "\n" line ends, and is '\0' terminated - output beyond in_capacity - 1 chars is dropped.
+     * A pending handler is called until it is done. The partial input of the user is kept. Must not be called
+     * from a command handler. out_len (optional) receives the nof captured chars.
+     */
+    int cli_execute(const char* const in_line, char* const out_buffer, size_t in_capacity, size_t* const out_len);
+
+    /**
+     * Prints a line of command output. For a command entered as "cmd | filter | ..." the output lines go through
+     * the filters before they reach the terminal - nothing is buffered beyond the current line:
+     *   grep TEXT - keeps the lines containing TEXT
+     *   head N    - keeps the first N lines, a pending handler is not called again once they are printed
+     *   count     - prints the number of lines instead of the lines
+     */
     void cli_print(const char* const fmt, ...);
 
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+    /**
+     * Selects how the cli_out_* functions write (CLI_OUTPUT_MODE_*) - e.g. JSON for host tools, text for people.
+     * Applies to the following commands, the mode can not change while a handler writes a value.
+     */
+    void cli_set_output_mode(uint8_t in_mode);
+
+    uint8_t cli_get_output_mode(void);
+
+    /**
+     * Structured command output - written straight to the terminal (or transport, filters, cli_execute buffer)
+     * in the current output mode, so a result of any size needs no more RAM than the open nesting levels:
+     *   cli_out_begin_map(NULL);  cli_out_kv_hex("ctrl", 0x80U);  cli_out_kv_bool("busy", false);  cli_out_end_map();
+     * gives the lines "ctrl: 0x00000080" and "busy: false" as text, {"ctrl":128,"busy":false} as JSON.
+     * in_key names the value inside a map and must be NULL for array items and top level values. Maps and arrays
+     * nest up to CLI_OUT_MAX_DEPTH levels. Whatever a handler leaves open is closed when its command is done.
+     * Only for the thread of cli_process - not for offloaded handlers.
+     */
+    void cli_out_begin_map(const char* const in_key);
+
+    void cli_out_end_map(void);
+
+    void cli_out_begin_array(const char* const in_key);
+
+    void cli_out_end_array(void);
+
+    void cli_out_kv_int(const char* const in_key, int32_t in_value);
+
+    void cli_out_kv_uint(const char* const in_key, uint32_t in_value);
+
+    /** An unsigned value that reads better in hex - 0x%08X as text, a plain number in JSON and CBOR. */
+    void cli_out_kv_hex(const char* const in_key, uint32_t in_value);
+
+    void cli_out_kv_bool(const char* const in_key, bool in_value);
+
+    void cli_out_kv_str(const char* const in_key, const char* const in_value);
+#endif
+
+    /**
+     * Queues a log line - safe to call from any thread at any time between cli_init and cli_deinit. The line is
+     * formatted right away with vsnprintf, which most embedded libcs do not allow in interrupts - interrupts may
+     * call cli_log only with CLI_FEATURE_PRINT_FORMATTER=0, then the format string is copied as it is.
+     * The line is truncated to CLI_LOG_MESSAGE_SIZE and printed by the next cli_process
+     * call: the current input line is erased, the queued log lines are printed, then the prompt and the partial
+     * input are restored. When the queue is full the line is dropped and counted.
+     */
+    void cli_log(const char* const fmt, ...);
+
+    /**
+     * A handler that returns CLI_PENDING_STATUS is called again with the same arguments in the next
+     * processing step - this way long outputs are spread over several cli_process_budget calls.
+     * Returns how often the handler was already called for the current line (0 on the first call).
+     */
+    uint16_t cli_get_continuation_index(void);
+
+    /**
+     * Iterates over all registered bindings whose name starts with in_prefix ("" matches all).
+     * in_cursor must be 0 for the first call. Returns NULL when there are no more matching bindings.
+     */
+    const cli_binding_t* cli_find_next_binding(const char* const in_prefix, cli_size_t* const inout_cursor);
+
+    void cli_set_terminal_caps(uint8_t in_terminal_caps);
+
+    /**
+     * Registers the commands for aliases and variables (they take two binding slots):
+     *   alias                      - list all aliases
+     *   alias NAME = command line  - define an alias, commands in the line are separated by a ';' token
+     *   alias NAME += command line - append to an alias, this way aliases get longer than an input line
+     *   alias NAME                 - delete an alias
+     *   set / set NAME value / set NAME - list, define and delete variables
+     * An alias runs as if its command line was typed, with any arguments typed after its name appended.
+     * $NAME arguments are replaced with the variable value - inside an alias when the alias is executed.
+     * Pipelines in an alias definition are kept - they are split off when the alias runs.
+     */
+    void cli_register_alias_commands(void);
+
+    /**
+     * Registers the commands for periodic jobs (they take three binding slots):
+     *   watch MS command line - runs the command every MS milliseconds, until it is killed
+     *   jobs                  - lists the jobs with their numbers
+     *   kill N                - stops job N
+     * The command line is split and its binding looked up once, when the job is started.
+     */
+    void cli_register_job_commands(void);
+
+    /**
+     * Registers the "stats" command (it takes one binding slot), which prints cli_get_stats next to the
+     * configured limits - "stats reset" calls cli_reset_stats.
+     */
+    void cli_register_stats_command(void);
+
+#if (0 != CLI_FEATURE_STRUCTURED_OUTPUT)
+    /**
+     * Registers the "output" command (it takes one binding slot) - "output text|json|cbor" switches the output
+     * mode of the cli_out_* functions, "output" prints the current one.
+     */
+    void cli_register_output_command(void);
+#endif
+
+    /**
+     * Switches the input into transfer mode, once the line of the calling command handler is finished and its
+     * status is CLI_OK_STATUS. Only to be called from a command handler. The cli announces the mode with
+     * "READY <start offset> <max chunk size>" and from then on reads frames instead of lines:
+     *   seq (uint16 LE) | length (uint8, 0 ends the transfer) | payload | CRC-16/CCITT-FALSE (LE) of all before
+     * Raw frames start with STX (0x02), base64 frames are one line each. CAN (0x18) aborts the transfer.
+     * Every frame is answered with "ACK <seq>", or "NAK <expected seq>" - then the sender repeats from there.
+     * A repeated frame that was already received is acknowledged again, but not delivered twice.
+     * The transfer ends with "DONE <nof bytes>" or "ABORT", then the cli is back in line mode.
+     */
+    void cli_start_transfer(const cli_transfer_t* const in_transfer);
+
+    /**
+     * Advances the job scheduler to in_now_ms (a free running millisecond counter - wrap arounds are fine).
+     * Call it regularly from the same context as cli_process - expired jobs run with the next cli_process call,
+     * between the lines the user enters. The cost per elapsed tick does not depend on the number of jobs.
+     */
+    void cli_tick(uint32_t in_now_ms);
+
     void cli_deinit(cli_cfg_t* const inout_module_cfg);
 
 #ifdef __cplusplus
@@ -0,0 +1,303 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(CLI_HPP)
+#define CLI_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Cli.h"
+
+/**
+ * Typed commands for C++17 - the argv parsing, the arity check and the usage signature are generated at compile
+ * time from the signature of a plain function, no heap, RTTI or exceptions:
+ *
+ *   void set_pwm(uint8_t ch, float duty);
+ *   constexpr cli_binding_t bindings[] = {cli::command<&set_pwm>("pwm", "Set a PWM duty")};
+ *   cli_register(&bindings[0]); // help: "Set a PWM duty - pwm u8 float"
+ *
+ * Supported argument types: integers (range checked, decimal, 0x hex or 0 octal), float, double, bool
+ * (1/0/true/false/on/off) and const char*. The function returns void (CLI_OK_STATUS), bool (true is
+ * CLI_OK_STATUS) or int (the status itself). Wrong arguments are answered with the usage line instead of a call.
+ */
+namespace cli
+{
+namespace detail
+{
+template <typename T, typename Enable = void>
+struct arg; // no specialization - the argument type is not supported
+
+template <typename T>
+struct arg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    static constexpr const char* name()
+    {
+        constexpr bool is_signed = std::is_signed_v<T>;
+        switch (sizeof(T))
+        {
+            case 1: return is_signed ? "i8" : "u8";
+            case 2: return is_signed ? "i16" : "u16";
+            case 4: return is_signed ? "i32" : "u32";
+            default: return is_signed ? "i64" : "u64";
+        }
+    }
+
+    static bool parse(const char* in_str, T& out_value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        if constexpr (std::is_signed_v<T>)
+        {
+            const long long value = std::strtoll(in_str, &end, 0);
+            if ((value < std::numeric_limits<T>::min()) || (value > std::numeric_limits<T>::max()))
+            {
+                return false;
+            }
+            out_value = static_cast<T>(value);
+        }
+        else
+        {
+            // strtoull accepts "-1" as its wrapped around value
+            if ('-' == in_str[0])
+            {
+                return false;
+            }
+            const unsigned long long value = std::strtoull(in_str, &end, 0);
+            if (value > std::numeric_limits<T>::max())
+            {
+                return false;
+            }
+            out_value = static_cast<T>(value);
+        }
+        return (end != in_str) && ('\0' == *end) && (0 == errno);
+    }
+};
+
+template <typename T>
+struct arg<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static constexpr const char* name() { return std::is_same_v<T, float> ? "float" : "double"; }
+
+    static bool parse(const char* in_str, T& out_value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        out_value = static_cast<T>(std::strtod(in_str, &end));
+        return (end != in_str) && ('\0' == *end) && (0 == errno);
+    }
+};
+
+template <>
+struct arg<bool>
+{
+    static constexpr const char* name() { return "bool"; }
+
+    static bool parse(const char* in_str, bool& out_value)
+    {
+        static constexpr const char* const true_words[] = {"1", "true", "on"};
+        static constexpr const char* const false_words[] = {"0", "false", "off"};
+        for (std::size_t i = 0; i < CLI_GET_ARRAY_SIZE(true_words); i++)
+        {
+            if (is_equal(in_str, true_words[i]) || is_equal(in_str, false_words[i]))
+            {
+                out_value = is_equal(in_str, true_words[i]);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool is_equal(const char* in_a, const char* in_b)
+    {
+        while ((*in_a != '\0') && (*in_a == *in_b))
+        {
+            in_a++;
+            in_b++;
+        }
+        return *in_a == *in_b;
+    }
+};
+
+template <>
+struct arg<const char*>
+{
+    static constexpr const char* name() { return "str"; }
+
+    static bool parse(const char* in_str, const char*& out_value)
+    {
+        out_value = in_str;
+        return true;
+    }
+};
+
+constexpr std::size_t length(const char* in_str)
+{
+    std::size_t len = 0;
+    while ('\0' != in_str[len])
+    {
+        len++;
+    }
+    return len;
+}
+
+/** Fixed size, '\0' padded text that is built at compile time. */
+template <std::size_t N>
+struct text
+{
+    char chars[N];
+    std::size_t len;
+
+    constexpr void append(const char* in_str)
+    {
+        for (std::size_t i = 0; ('\0' != in_str[i]) && (len < (N - 1)); i++)
+        {
+            chars[len++] = in_str[i];
+        }
+    }
+};
+
+template <typename Fn>
+struct traits; // no specialization - only plain function pointers are supported
+
+template <typename R, typename... Args>
+struct traits<R (*)(Args...)>
+{
+    using result = R;
+    using values = std::tuple<std::decay_t<Args>...>;
+    static constexpr std::size_t arity = sizeof...(Args);
+
+    /** " u8 float" - the argument types as shown by the usage line and the help. */
+    static constexpr std::size_t signature_length = (0 + ... + (1 + length(arg<std::decay_t<Args>>::name())));
+
+    static constexpr text<signature_length + 1> signature()
+    {
+        text<signature_length + 1> sig{};
+        ((sig.append(" "), sig.append(arg<std::decay_t<Args>>::name())), ...);
+        return sig;
+    }
+};
+
+template <auto Fn>
+struct command_info : traits<decltype(Fn)>
+{
+    static constexpr auto usage = traits<decltype(Fn)>::signature();
+};
+
+template <typename T>
+bool parse_arg(char* argv[], int in_idx, T& out_value)
+{
+    if (arg<T>::parse(argv[in_idx], out_value))
+    {
+        return true;
+    }
+    cli_print("Invalid argument %d: %s is no %s", in_idx, argv[in_idx], arg<T>::name());
+    return false;
+}
+
+template <auto Fn, std::size_t... I>
+int call(char* argv[], std::index_sequence<I...>)
+{
+    using info = command_info<Fn>;
+    typename info::values values{};
+
+    // The arguments are converted from left to right, up to the first invalid one
+    if (!(true && ... && parse_arg(argv, static_cast<int>(I + 1), std::get<I>(values))))
+    {
+        cli_print("Usage: %s%s", argv[0], info::usage.chars);
+        return CLI_FAIL_STATUS;
+    }
+
+    if constexpr (std::is_void_v<typename info::result>)
+    {
+        Fn(std::get<I>(values)...);
+        return CLI_OK_STATUS;
+    }
+    else if constexpr (std::is_same_v<typename info::result, bool>)
+    {
+        return Fn(std::get<I>(values)...) ? CLI_OK_STATUS : CLI_FAIL_STATUS;
+    }
+    else
+    {
+        static_assert(std::is_same_v<typename info::result, int>, "commands return void, bool or an int status");
+        return Fn(std::get<I>(values)...);
+    }
+}
+
+/** The cli_cmd_fn of a typed command. */
+template <auto Fn>
+int trampoline(int argc, char* argv[], void* context)
+{
+    using info = command_info<Fn>;
+    (void)context;
+
+    if (argc != static_cast<int>(info::arity + 1))
+    {
+        cli_print("Usage: %s%s", argv[0], info::usage.chars);
+        return CLI_FAIL_STATUS;
+    }
+    return call<Fn>(argv, std::make_index_sequence<info::arity>{});
+}
+
+template <auto Fn, std::size_t... N, std::size_t... H>
+constexpr cli_binding_t make_binding(const text<CLI_MAX_CMD_NAME_LENGTH>& in_name,
+                                     const text<CLI_MAX_HELPER_STRING_LENGTH>& in_help, std::index_sequence<N...>,
+                                     std::index_sequence<H...>)
+{
+    return cli_binding_t{{in_name.chars[N]...}, &trampoline<Fn>, nullptr, {in_help.chars[H]...}, nullptr, nullptr};
+}
+} // namespace detail
+
+/**
+ * Builds the binding of a typed command - usually in a constexpr table. The help text gets the usage
+ * appended: "<in_help> - <in_name> <argument types>", cut to CLI_MAX_HELPER_STRING_LENGTH.
+ */
+template <auto Fn, std::size_t NameSize, std::size_t HelpSize>
+constexpr cli_binding_t command(const char (&in_name)[NameSize], const char (&in_help)[HelpSize])
+{
+    static_assert(NameSize <= CLI_MAX_CMD_NAME_LENGTH, "command name is too long");
+    static_assert(std::is_pointer_v<decltype(Fn)> && std::is_function_v<std::remove_pointer_t<decltype(Fn)>>,
+                  "commands are plain functions");
+
+    detail::text<CLI_MAX_CMD_NAME_LENGTH> name{};
+    name.append(in_name);
+
+    detail::text<CLI_MAX_HELPER_STRING_LENGTH> help{};
+    help.append(in_help);
+    help.append(" - ");
+    help.append(in_name);
+    help.append(detail::command_info<Fn>::usage.chars);
+
+    return detail::make_binding<Fn>(name, help, std::make_index_sequence<CLI_MAX_CMD_NAME_LENGTH>{},
+                                    std::make_index_sequence<CLI_MAX_HELPER_STRING_LENGTH>{});
+}
+} // namespace cli
+
+#endif // CLI_HPP
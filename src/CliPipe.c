@@ -0,0 +1,150 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CliPipe.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "custom_assert.h"
+
+/* #############################################################################
+ * # static function prototypes
+ * ###########################################################################*/
+
+static size_t prv_ring_write(cli_pipe_ring_t* const inout_ring, const char* in_data, size_t in_len);
+static size_t prv_ring_read(cli_pipe_ring_t* const inout_ring, char* out_data, size_t in_capacity);
+static size_t prv_ring_fill_level(const cli_pipe_ring_t* const in_ring);
+
+static int prv_transport_read(void* context, char* out_data, size_t in_capacity);
+static int prv_transport_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov);
+static bool prv_transport_poll_ready(void* context);
+
+/* #############################################################################
+ * # global function implementations
+ * ###########################################################################*/
+
+void cli_pipe_init(cli_pipe_t* const inout_pipe, cli_transport_t* const out_transport)
+{
+    { // Input Checks
+        ASSERT(inout_pipe);
+        ASSERT(out_transport);
+    }
+
+    memset(inout_pipe, 0, sizeof(cli_pipe_t));
+
+    out_transport->read = prv_transport_read;
+    out_transport->writev = prv_transport_writev;
+    out_transport->flush = NULL;
+    out_transport->poll_ready = prv_transport_poll_ready;
+    out_transport->context = inout_pipe;
+}
+
+size_t cli_pipe_write_input(cli_pipe_t* const inout_pipe, const char* const in_data, size_t in_len)
+{
+    { // Input Checks
+        ASSERT(inout_pipe);
+        ASSERT(in_data);
+    }
+    return prv_ring_write(&inout_pipe->to_cli, in_data, in_len);
+}
+
+size_t cli_pipe_read_output(cli_pipe_t* const inout_pipe, char* const out_data, size_t in_capacity)
+{
+    { // Input Checks
+        ASSERT(inout_pipe);
+        ASSERT(out_data);
+    }
+    return prv_ring_read(&inout_pipe->from_cli, out_data, in_capacity);
+}
+
+/* #############################################################################
+ * # static function implementations
+ * ###########################################################################*/
+
+static size_t prv_ring_fill_level(const cli_pipe_ring_t* const in_ring)
+{
+    return in_ring->nof_written_chars - in_ring->nof_read_chars;
+}
+
+static size_t prv_ring_write(cli_pipe_ring_t* const inout_ring, const char* in_data, size_t in_len)
+{
+    const size_t free_space = CLI_PIPE_BUFFER_SIZE - prv_ring_fill_level(inout_ring);
+    const size_t nof_chars = (in_len < free_space) ? in_len : free_space;
+
+    for (size_t i = 0; i < nof_chars; i++)
+    {
+        inout_ring->data[inout_ring->nof_written_chars % CLI_PIPE_BUFFER_SIZE] = in_data[i];
+        inout_ring->nof_written_chars++;
+    }
+    return nof_chars;
+}
+
+static size_t prv_ring_read(cli_pipe_ring_t* const inout_ring, char* out_data, size_t in_capacity)
+{
+    const size_t fill_level = prv_ring_fill_level(inout_ring);
+    const size_t nof_chars = (in_capacity < fill_level) ? in_capacity : fill_level;
+
+    for (size_t i = 0; i < nof_chars; i++)
+    {
+        out_data[i] = inout_ring->data[inout_ring->nof_read_chars % CLI_PIPE_BUFFER_SIZE];
+        inout_ring->nof_read_chars++;
+    }
+    return nof_chars;
+}
+
+static int prv_transport_read(void* context, char* out_data, size_t in_capacity)
+{
+    cli_pipe_t* const pipe = (cli_pipe_t*)context;
+    ASSERT(pipe);
+
+    pipe->nof_read_calls++;
+    return (int)prv_ring_read(&pipe->to_cli, out_data, in_capacity);
+}
+
+static int prv_transport_writev(void* context, const cli_iovec_t* in_iov, size_t in_nof_iov)
+{
+    cli_pipe_t* const pipe = (cli_pipe_t*)context;
+    ASSERT(pipe);
+    ASSERT(in_iov);
+
+    size_t nof_written_chars = 0;
+
+    pipe->nof_writev_calls++;
+    for (size_t i = 0; i < in_nof_iov; i++)
+    {
+        size_t nof_chars = prv_ring_write(&pipe->from_cli, (const char*)in_iov[i].base, in_iov[i].len);
+        pipe->nof_dropped_chars += (uint32_t)(in_iov[i].len - nof_chars);
+        nof_written_chars += nof_chars;
+    }
+    return (int)nof_written_chars;
+}
+
+static bool prv_transport_poll_ready(void* context)
+{
+    cli_pipe_t* const pipe = (cli_pipe_t*)context;
+    ASSERT(pipe);
+
+    return (prv_ring_fill_level(&pipe->to_cli) > 0) ? true : false;
+}
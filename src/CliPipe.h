@@ -0,0 +1,71 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(CLI_PIPE_H)
+#define CLI_PIPE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Cli.h"
+
+#define CLI_PIPE_BUFFER_SIZE (1024)
+
+    /**
+     * In-memory byte pipe between an application (or a unit test) and the cli. It implements the
+     * cli_transport_t interface: the cli reads what was written with cli_pipe_write_input and its output
+     * is collected for cli_pipe_read_output. Output that does not fit anymore is dropped.
+     */
+    typedef struct
+    {
+        char data[CLI_PIPE_BUFFER_SIZE];
+        size_t nof_written_chars; // free running - the difference to nof_read_chars is the fill level
+        size_t nof_read_chars;
+    } cli_pipe_ring_t;
+
+    typedef struct
+    {
+        cli_pipe_ring_t to_cli;
+        cli_pipe_ring_t from_cli;
+        uint32_t nof_read_calls;
+        uint32_t nof_writev_calls;
+        uint32_t nof_dropped_chars;
+    } cli_pipe_t;
+
+    void cli_pipe_init(cli_pipe_t* const inout_pipe, cli_transport_t* const out_transport);
+
+    size_t cli_pipe_write_input(cli_pipe_t* const inout_pipe, const char* const in_data, size_t in_len);
+
+    size_t cli_pipe_read_output(cli_pipe_t* const inout_pipe, char* const out_data, size_t in_capacity);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif // CLI_PIPE_H
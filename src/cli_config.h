@@ -0,0 +1,86 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(CLI_CONFIG_H)
+#define CLI_CONFIG_H
+
+/* Compile time feature switches - a subsystem that is switched off (0) compiles out completely. Override single
+ * switches from the build system (e.g. -DCLI_FEATURE_HELP=0), or collect them in a header of your own and pass its
+ * name with -DCLI_USER_CONFIG_FILE=\"my_cli_config.h\". The defaults keep every feature, the buffer sizes are
+ * configured in Cli.h. */
+
+#if defined(CLI_USER_CONFIG_FILE)
+#include CLI_USER_CONFIG_FILE
+#endif
+
+/* Tab completion of command names and of arguments (cli_complete_fn) - without it Tab is ignored */
+#if !defined(CLI_FEATURE_AUTOCOMPLETE)
+#define CLI_FEATURE_AUTOCOMPLETE (1)
+#endif
+
+/* The built-in "help" command and the hints that point to it */
+#if !defined(CLI_FEATURE_HELP)
+#define CLI_FEATURE_HELP (1)
+#endif
+
+/* Green / red status on ANSI terminals - without it the status is plain text on every terminal */
+#if !defined(CLI_FEATURE_COLOR)
+#define CLI_FEATURE_COLOR (1)
+#endif
+
+/* Banner and clear screen in cli_init, rulers around the output of a command */
+#if !defined(CLI_FEATURE_DECORATION)
+#define CLI_FEATURE_DECORATION (1)
+#endif
+
+/* printf style formatting (vsnprintf) in cli_print and cli_log - without it the format string is the text */
+#if !defined(CLI_FEATURE_PRINT_FORMATTER)
+#define CLI_FEATURE_PRINT_FORMATTER (1)
+#endif
+
+/* cli_unregister - without it bindings can only be added */
+#if !defined(CLI_FEATURE_UNREGISTER)
+#define CLI_FEATURE_UNREGISTER (1)
+#endif
+
+/* cli_out_* - maps, arrays and values written as text, JSON or CBOR, and the "output" command */
+#if !defined(CLI_FEATURE_STRUCTURED_OUTPUT)
+#define CLI_FEATURE_STRUCTURED_OUTPUT (1)
+#endif
+
+/**
+ * Integrity checks (ASSERTs) on the cli_cfg_t - its canaries, pointers and counters:
+ *   2 - in every function, so a corruption is caught close to where it happened
+ *   1 - in the public cli_* functions only
+ *   0 - none
+ */
+#if !defined(CLI_INTEGRITY_TIER)
+#define CLI_INTEGRITY_TIER (2)
+#endif
+
+#if (CLI_INTEGRITY_TIER < 0) || (CLI_INTEGRITY_TIER > 2)
+#error "CLI_INTEGRITY_TIER must be 0, 1 or 2"
+#endif
+
+#endif // CLI_CONFIG_H
@@ -0,0 +1,86 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "cli_test_helpers.h"
+#include <stdbool.h>
+#include <string.h>
+
+uint32_t nof_triggered_asserts = 0;
+char mock_print_buffer[MOCK_BUFFER_SIZE];
+size_t mock_print_index = 0;
+
+void mock_assert_callback(const char* file, uint32_t line, const char* expr)
+{
+    (void)file;
+    (void)line;
+    (void)expr;
+    nof_triggered_asserts++;
+}
+
+int mock_put_char(char c)
+{
+    if (mock_print_index < (MOCK_BUFFER_SIZE - 1))
+    {
+        mock_print_buffer[mock_print_index++] = c;
+    }
+    return 0;
+}
+
+void clear_output(void)
+{
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+}
+
+void receive_chars(const char* in_chars)
+{
+    for (size_t i = 0; i < strlen(in_chars); i++)
+    {
+        cli_receive(in_chars[i]);
+    }
+}
+
+void send_line(const char* in_line)
+{
+    receive_chars(in_line);
+    cli_process();
+}
+
+void setup_cli(cli_cfg_t* const inout_cfg)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+
+    cli_init(inout_cfg, mock_put_char);
+    clear_output();
+}
+
+void teardown_cli(cli_cfg_t* const inout_cfg)
+{
+    if (true == inout_cfg->is_initialized)
+    {
+        cli_deinit(inout_cfg);
+    }
+    custom_assert_deinit();
+}
@@ -0,0 +1,64 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(CLI_TEST_HELPERS_H)
+#define CLI_TEST_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Cli.h"
+#include "custom_assert.h"
+
+/**
+ * Mocks and setup shared by the unit tests - Ceedling links cli_test_helpers.c to every test that includes this
+ * header. Tests with their own terminal or assert handling keep their local mocks.
+ */
+
+#define MOCK_BUFFER_SIZE (4096)
+
+extern uint32_t nof_triggered_asserts;
+extern char mock_print_buffer[MOCK_BUFFER_SIZE];
+extern size_t mock_print_index;
+
+/** Counts the triggered asserts in nof_triggered_asserts. */
+void mock_assert_callback(const char* file, uint32_t line, const char* expr);
+
+/** Collects the terminal output in mock_print_buffer - the rest is dropped, when it is full. */
+int mock_put_char(char c);
+
+void clear_output(void);
+
+/** Receives the chars one by one - without cli_process. */
+void receive_chars(const char* in_chars);
+
+/** Receives the chars and processes what they completed. */
+void send_line(const char* in_line);
+
+/** Installs the assert mock and initializes the cli with mock_put_char, the output is cleared. */
+void setup_cli(cli_cfg_t* const inout_cfg);
+
+/** Deinitializes the cli, if it was initialized, and removes the assert mock. */
+void teardown_cli(cli_cfg_t* const inout_cfg);
+
+#endif // CLI_TEST_HELPERS_H
@@ -24,8 +24,10 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "Cli.h"
+#include "CliPipe.h"
 #include "custom_assert.h"
 #include "custom_types.h"
 #include "unity.h"
@@ -82,10 +84,10 @@ int cmd_dummy(int argc, char* argv[], void* context)
 }
 
 static cli_binding_t cli_bindings[] = {
-    {"hello", prv_cmd_hello_world, NULL, "Say hello"},
-    {"args", prv_cmd_display_args, NULL, "Displays the given cli arguments"},
-    {"echo", prv_cmd_echo_string, NULL, "Echoes the given string"},
-    {"dummy", cmd_dummy, NULL, "dummy stuffens"},
+    {"hello", prv_cmd_hello_world, NULL, "Say hello", NULL, NULL},
+    {"args", prv_cmd_display_args, NULL, "Displays the given cli arguments", NULL, NULL},
+    {"echo", prv_cmd_echo_string, NULL, "Echoes the given string", NULL, NULL},
+    {"dummy", cmd_dummy, NULL, "dummy stuffens", NULL, NULL},
 };
 
 // #############################################################################
@@ -531,7 +533,7 @@ void test_cli_command_with_context(void)
 {
     // Create a command with context
     static int test_context = 42;
-    static cli_binding_t context_cmd = {"context", cmd_dummy, &test_context, "Command with context"};
+    static cli_binding_t context_cmd = {"context", cmd_dummy, &test_context, "Command with context", NULL, NULL};
 
     cli_register(&context_cmd);
 
@@ -609,7 +611,7 @@ void test_prv_find_matching_strings(void)
 {
     const char* input_strings[] = {"help", "hello", "dummy"};
     const char* matches[10];
-    uint8_t num_matches;
+    cli_size_t num_matches;
 
     prv_find_matching_strings("he", input_strings, CLI_GET_ARRAY_SIZE(input_strings), matches, &num_matches);
 
@@ -630,3 +632,1248 @@ void test_cli_receive_found_several_matches(void)
     cli_receive('e');
     cli_receive('\t');
 }
+
+void test_cli_autocomplete_writes_only_the_missing_suffix(void)
+{
+    cli_register(&cli_bindings[0]); // hello command
+
+    cli_receive('h');
+    cli_receive('e');
+    cli_receive('l');
+    cli_receive('l');
+
+    // Only the completion must go over the wire - the typed prefix is already on the console
+    size_t output_index_before_tab = mock_print_index;
+    cli_receive('\t');
+
+    TEST_ASSERT_EQUAL_STRING("o", &mock_print_buffer[output_index_before_tab]);
+    TEST_ASSERT_EQUAL_STRING("hello", g_cli_cfg_test.rx_char_buffer);
+    TEST_ASSERT_EQUAL(5, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+
+    cli_unregister("hello");
+}
+
+void test_cli_rulers_use_rep_sequence_when_supported(void)
+{
+    cli_set_terminal_caps(CLI_TERM_CAP_ANSI | CLI_TERM_CAP_REP);
+
+    const char* input = "help\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+    cli_process();
+
+    // One '-' followed by "repeat 49 times" instead of 50 individual characters
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "-\033[49b\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "------"));
+}
+
+void test_cli_dumb_terminal_gets_no_escape_sequences(void)
+{
+    cli_set_terminal_caps(CLI_TERM_CAP_NONE);
+
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+
+    const char* input = "helq\b\b\bxyz\b\b\b\b\bhelp\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+    cli_process();
+
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\033'));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "* help:"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> [OK]"));
+}
+
+void test_cli_autocomplete_of_substring_erases_input_to_end_of_line(void)
+{
+    cli_receive('e');
+    cli_receive('l');
+    cli_receive('p');
+
+    // "elp" matches "help" but is not its prefix - the typed input is erased in one go and the command rewritten
+    size_t output_index_before_tab = mock_print_index;
+    cli_receive('\t');
+
+    TEST_ASSERT_EQUAL_STRING("\033[3D\033[Khelp", &mock_print_buffer[output_index_before_tab]);
+    TEST_ASSERT_EQUAL_STRING("help", g_cli_cfg_test.rx_char_buffer);
+}
+
+static uint32_t mock_clock_us = 0;
+static uint32_t mock_clock_step_us = 0;
+
+static uint32_t mock_clock(void)
+{
+    mock_clock_us += mock_clock_step_us;
+    return mock_clock_us;
+}
+
+void test_cli_process_budget_does_one_step_per_call_when_budget_is_exhausted(void)
+{
+    mock_clock_us = 0;
+    mock_clock_step_us = 100;
+    cli_set_clock(mock_clock);
+
+    const char* input = "help\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+
+    // detect line -> tokenize -> header -> dispatch -> footer -> done
+    uint32_t nof_calls = 1;
+    while (true == cli_process_budget(50))
+    {
+        nof_calls++;
+        if (4 == nof_calls)
+        {
+            // The help command runs in the dispatch step - nothing has been listed yet
+            TEST_ASSERT_NULL(strstr(mock_print_buffer, "* help:"));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(6, nof_calls);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "* help:"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> "));
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+}
+
+void test_cli_process_budget_finishes_line_when_budget_is_large_enough(void)
+{
+    mock_clock_us = 0;
+    mock_clock_step_us = 1;
+    cli_set_clock(mock_clock);
+
+    const char* input = "help\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+
+    TEST_ASSERT_FALSE(cli_process_budget(1000));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> "));
+    TEST_ASSERT_FALSE(cli_process_budget(1000));
+}
+
+void test_cli_receive_keeps_characters_typed_while_a_line_is_pending(void)
+{
+    const char* input = "help\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+
+    // No clock is set - a single step is done
+    TEST_ASSERT_TRUE(cli_process_budget(0));
+
+    // The processed line stays untouched - the character is typed ahead
+    cli_receive('x');
+    TEST_ASSERT_EQUAL(5, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+
+    cli_process();
+    TEST_ASSERT_EQUAL(1, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+    TEST_ASSERT_EQUAL('x', g_cli_cfg_test.rx_char_buffer[0]);
+    cli_receive('y');
+    TEST_ASSERT_EQUAL(2, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.stats.nof_lost_typeahead_chars);
+}
+
+void test_cli_transport_gathers_the_output_of_a_command_into_one_writev(void)
+{
+    static cli_pipe_t pipe;
+    static cli_transport_t transport;
+    static char output[CLI_PIPE_BUFFER_SIZE];
+
+    cli_pipe_init(&pipe, &transport);
+    cli_set_transport(&transport);
+    cli_set_terminal_caps(CLI_TERM_CAP_ANSI | CLI_TERM_CAP_REP);
+
+    const char* input = "help\n";
+    cli_pipe_write_input(&pipe, input, strlen(input));
+
+    cli_process();
+    TEST_ASSERT_EQUAL(1, pipe.nof_read_calls);
+
+    // The echo and the complete output of the command went out in one writev call
+    TEST_ASSERT_EQUAL(1, pipe.nof_writev_calls);
+    memset(output, 0, sizeof(output));
+    TEST_ASSERT_GREATER_THAN(80, cli_pipe_read_output(&pipe, output, sizeof(output) - 1));
+    TEST_ASSERT_NOT_NULL(strstr(output, "help\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "* help:"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "Status -> "));
+
+    // Nothing went through the put_char_fn
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "* help:"));
+
+    cli_set_transport(NULL);
+}
+
+void test_cli_transport_processes_all_lines_of_one_input_chunk(void)
+{
+    static cli_pipe_t pipe;
+    static cli_transport_t transport;
+    static char output[CLI_PIPE_BUFFER_SIZE];
+
+    cli_pipe_init(&pipe, &transport);
+    cli_set_transport(&transport);
+
+    const char* input = "unknowncmd\nhelp\nhel";
+    cli_pipe_write_input(&pipe, input, strlen(input));
+
+    cli_process();
+    TEST_ASSERT_EQUAL(1, pipe.nof_read_calls);
+
+    memset(output, 0, sizeof(output));
+    cli_pipe_read_output(&pipe, output, sizeof(output) - 1);
+    TEST_ASSERT_NOT_NULL(strstr(output, "Unknown command: unknowncmd"));
+    TEST_ASSERT_NOT_NULL(strstr(output, "* help:"));
+
+    // The incomplete line waits in the rx buffer for the rest
+    TEST_ASSERT_EQUAL(3, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+
+    cli_set_transport(NULL);
+}
+
+static void send_line(const char* in_line)
+{
+    for (size_t i = 0; i < strlen(in_line); i++)
+    {
+        cli_receive(in_line[i]);
+    }
+}
+
+void test_cli_help_lists_only_commands_with_the_given_prefix(void)
+{
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(cli_bindings); i++)
+    {
+        cli_register(&cli_bindings[i]);
+    }
+
+    send_line("help he\n");
+    cli_process();
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "* help:"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "* hello:"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "* args:"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "* echo:"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "* dummy:"));
+
+    // No match is reported as failure
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    send_line("help xyz\n");
+    cli_process();
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "No command starts with: xyz"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "[FAIL]"));
+}
+
+void test_cli_help_compact_format_uses_one_line_per_command(void)
+{
+    cli_register(&cli_bindings[0]); // hello command
+
+    send_line("help -c\n");
+    cli_process();
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhelp - List all commands"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhello - Say hello\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "* help:"));
+}
+
+void test_cli_help_is_streamed_over_several_processing_steps(void)
+{
+    static cli_binding_t commands[CLI_MAX_NOF_CALLBACKS - 1];
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(commands); i++)
+    {
+        snprintf((char*)commands[i].name, CLI_MAX_CMD_NAME_LENGTH, "cmd%d", (int)i);
+        commands[i].cmd_fn = cmd_dummy;
+        snprintf((char*)commands[i].help, CLI_MAX_HELPER_STRING_LENGTH, "command %d", (int)i);
+        cli_register(&commands[i]);
+    }
+
+    send_line("help -c\n");
+
+    // detect line -> tokenize -> header -> 3 x dispatch (4 + 4 + 2 entries) -> footer -> done
+    uint32_t nof_calls = 1;
+    while (true == cli_process_budget(0))
+    {
+        nof_calls++;
+        if (5 == nof_calls)
+        {
+            // The first dispatch step listed help, cmd0, cmd1 and cmd2
+            TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "cmd2 - command 2"));
+            TEST_ASSERT_NULL(strstr(mock_print_buffer, "cmd3 - command 3"));
+            TEST_ASSERT_EQUAL(1, cli_get_continuation_index());
+        }
+    }
+
+    TEST_ASSERT_EQUAL(8, nof_calls);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "cmd8 - command 8"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "[OK]"));
+    verify_no_assert_triggered();
+}
+
+static int cmd_count_calls(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (*(uint32_t*)context)++;
+    return CLI_OK_STATUS;
+}
+
+void test_cli_register_unregister_churn_keeps_all_commands_reachable(void)
+{
+    static uint32_t nof_calls[CLI_MAX_NOF_CALLBACKS - 1];
+    static cli_binding_t commands[CLI_MAX_NOF_CALLBACKS - 1];
+    char line[CLI_MAX_CMD_NAME_LENGTH + 1];
+
+    memset(nof_calls, 0, sizeof(nof_calls));
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(commands); i++)
+    {
+        snprintf((char*)commands[i].name, CLI_MAX_CMD_NAME_LENGTH, "c%d", (int)i);
+        commands[i].cmd_fn = cmd_count_calls;
+        commands[i].context = &nof_calls[i];
+        cli_register(&commands[i]);
+    }
+
+    // Remove and re-add commands in a different order - the moved bindings must stay findable
+    for (size_t round = 0; round < 50; round++)
+    {
+        const size_t victim = (round * 7) % CLI_GET_ARRAY_SIZE(commands);
+        cli_unregister(commands[victim].name);
+        cli_register(&commands[victim]);
+    }
+    cli_unregister("c4");
+    verify_no_assert_triggered();
+    TEST_ASSERT_NULL(last_assert_trigger.last_assert_file);
+
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(commands); i++)
+    {
+        snprintf(line, sizeof(line), "c%d\n", (int)i);
+        send_line(line);
+        cli_process();
+        TEST_ASSERT_EQUAL((4 == i) ? 0 : 1, nof_calls[i]);
+    }
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Unknown command: c4"));
+    TEST_ASSERT_EQUAL(CLI_MAX_NOF_CALLBACKS - 1, g_cli_cfg_test.nof_stored_cmd_bindings);
+}
+
+void test_cli_log_restores_the_prompt_and_the_partial_input(void)
+{
+    send_line("hel");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+
+    cli_log("sensor %d ready", 3);
+    cli_log("link up");
+    TEST_ASSERT_EQUAL_STRING("", mock_print_buffer);
+
+    cli_process();
+
+    TEST_ASSERT_EQUAL_STRING("\r\033[Ksensor 3 ready\r\nlink up\r\n> hel", mock_print_buffer);
+    TEST_ASSERT_EQUAL_STRING("hel", g_cli_cfg_test.rx_char_buffer);
+
+    // The queue is empty again - nothing is redrawn
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    cli_process();
+    TEST_ASSERT_EQUAL_STRING("", mock_print_buffer);
+}
+
+void test_cli_log_erases_input_that_wrapped_past_the_terminal_width(void)
+{
+    // The prompt and 100 chars take two rows of CLI_TERMINAL_WIDTH (80) columns
+    char input[101];
+    memset(input, 'a', sizeof(input) - 1);
+    input[sizeof(input) - 1] = '\0';
+    send_line(input);
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+
+    cli_log("link up");
+    cli_process();
+
+    // Up one row to the prompt, then erase to the end of the screen
+    const char* const expected = "\033[1A\r\033[Jlink up\r\n> aaa";
+    TEST_ASSERT_EQUAL_MEMORY(expected, mock_print_buffer, strlen(expected));
+    verify_no_assert_triggered();
+}
+
+void test_cli_log_drops_messages_when_the_queue_is_full(void)
+{
+    cli_set_terminal_caps(CLI_TERM_CAP_NONE);
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+
+    for (int i = 0; i < CLI_LOG_QUEUE_DEPTH + 3; i++)
+    {
+        cli_log("msg %d", i);
+    }
+    cli_process();
+
+    char last_message[16];
+    snprintf(last_message, sizeof(last_message), "msg %d\r\n", CLI_LOG_QUEUE_DEPTH - 1);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\r\nmsg 0\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, last_message));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "3 log messages dropped\r\n> "));
+
+    // The freed slots can be used again
+    cli_log("again");
+    cli_process();
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "again\r\n"));
+}
+
+static void run_line(const char* in_line)
+{
+    send_line(in_line);
+    cli_process();
+}
+
+void test_cli_alias_runs_its_command_line_with_the_typed_arguments_appended(void)
+{
+    cli_register_alias_commands();
+    cli_register(&cli_bindings[1]); // args
+
+    run_line("alias rd = args read 0x48\n");
+    run_line("rd 0x00 2\n");
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[0] --> \"args\""));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[2] --> \"0x48\""));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[4] --> \"2\""));
+
+    // The binding was resolved once and is now cached with the alias
+    TEST_ASSERT_EQUAL(1, g_cli_cfg_test.nof_aliases);
+    TEST_ASSERT_NOT_NULL(g_cli_cfg_test.aliases[0].cmd_binding);
+    TEST_ASSERT_EQUAL_STRING("args", g_cli_cfg_test.aliases[0].cmd_binding->name);
+    verify_no_assert_triggered();
+}
+
+void test_cli_alias_cache_follows_moved_bindings(void)
+{
+    cli_register_alias_commands();
+    cli_register(&cli_bindings[0]); // hello
+    cli_register(&cli_bindings[1]); // args
+
+    run_line("alias a = args\n");
+    run_line("a\n");
+
+    // Removing hello moves args into its slot - the cached pointer must not be used anymore
+    cli_unregister("hello");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("a x\n");
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[1] --> \"x\""));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "Unknown command"));
+}
+
+void test_cli_alias_sequence_can_be_longer_than_an_input_line(void)
+{
+    static uint32_t nof_calls = 0;
+    static cli_binding_t tick_binding = {"tick", cmd_count_calls, &nof_calls, "Count the calls", NULL, NULL};
+
+    nof_calls = 0;
+    cli_register_alias_commands();
+    cli_register(&tick_binding);
+
+    run_line("alias many = tick\n");
+    for (int i = 0; i < 5; i++)
+    {
+        run_line("alias many += ; tick ; tick ; tick ; tick ; tick ; tick\n");
+    }
+    TEST_ASSERT_GREATER_THAN(CLI_MAX_RX_BUFFER_SIZE, g_cli_cfg_test.aliases[0].length);
+
+    run_line("many\n");
+
+    TEST_ASSERT_EQUAL(31, nof_calls);
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.active_alias);
+}
+
+void test_cli_variables_are_expanded_when_the_alias_runs(void)
+{
+    cli_register_alias_commands();
+    cli_register(&cli_bindings[2]); // echo
+
+    run_line("set X 42\n");
+    run_line("echo $X\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "42\"\""));
+
+    run_line("alias e = echo $X\n");
+    run_line("set X 7\n");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("e\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "7\"\""));
+
+    // Aliases and variables can not be changed from within an alias
+    run_line("alias bad = set X 1\n");
+    run_line("bad\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Variables can not be changed by an alias"));
+
+    run_line("set X\n");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("e\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "$X\"\""));
+}
+
+void test_cli_set_copies_a_variable_that_moves_in_the_arena(void)
+{
+    cli_register_alias_commands();
+
+    // D sits in front of E - removing the old D moves the value of E
+    run_line("set D 1\n");
+    run_line("set E abcdefghij\n");
+    run_line("set D $E\n");
+
+    // A variable set to its own value is removed before it is added again
+    run_line("set C xyz\n");
+    run_line("set C $C\n");
+
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("set\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "D = abcdefghij"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "E = abcdefghij"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "C = xyz"));
+    verify_no_assert_triggered();
+}
+
+void test_cli_alias_arena_is_compacted_when_entries_are_removed(void)
+{
+    cli_register_alias_commands();
+
+    // Fill the arena with a single long alias
+    run_line("alias big = x\n");
+    while (g_cli_cfg_test.nof_used_arena_chars < (CLI_ALIAS_ARENA_SIZE - 40))
+    {
+        run_line("alias big += 0123456789 0123456789\n");
+    }
+    run_line("alias small = y\n");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("alias big += 0123456789 0123456789 0123456789\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "No space left for aliases and variables"));
+
+    // Deleting the big alias frees its chars for the others
+    run_line("alias big\n");
+    TEST_ASSERT_EQUAL(1, g_cli_cfg_test.nof_aliases);
+    TEST_ASSERT_EQUAL(strlen("small") + strlen("y") + 2, g_cli_cfg_test.nof_used_arena_chars);
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.aliases[0].offset);
+
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("alias\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "small = y\r\n"));
+    verify_no_assert_triggered();
+}
+
+static void register_test_bindings(void)
+{
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(cli_bindings); i++)
+    {
+        cli_register(&cli_bindings[i]);
+    }
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+}
+
+void test_cli_pipeline_grep_keeps_only_matching_lines(void)
+{
+    register_test_bindings();
+
+    run_line("help -c | grep hel\n");
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhelp - List all commands"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhello - Say hello\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "args"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "dummy"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> "));
+}
+
+void test_cli_pipeline_count_replaces_the_output_with_the_number_of_lines(void)
+{
+    register_test_bindings();
+
+    run_line("help -c | count\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\n5\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "hello"));
+
+    // Filters can be chained - count feeds its result into the next one
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    run_line("args a b c | grep argv | count\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\n4\r\n"));
+}
+
+void test_cli_pipeline_head_stops_a_pending_handler(void)
+{
+    register_test_bindings();
+
+    // help lists 4 bindings per call - the second call is not needed anymore
+    run_line("help -c | head 2\n");
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhelp - List all commands"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\nhello - Say hello\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "args - "));
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.nof_handler_calls);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "[OK]"));
+}
+
+void test_cli_pipeline_with_invalid_filter_does_not_run_the_command(void)
+{
+    static uint32_t nof_calls = 0;
+    static cli_binding_t tick_binding = {"tick", cmd_count_calls, &nof_calls, "Count the calls", NULL, NULL};
+
+    nof_calls = 0;
+    cli_register(&tick_binding);
+
+    run_line("tick | sort\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Invalid filter: sort"));
+
+    run_line("tick | head\n");
+    run_line("tick | count 3\n");
+    run_line("tick |\n");
+    TEST_ASSERT_EQUAL(0, nof_calls);
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "[OK]"));
+}
+
+void test_cli_watch_runs_a_command_periodically_until_it_is_killed(void)
+{
+    static uint32_t nof_calls = 0;
+    static cli_binding_t tick_binding = {"tick", cmd_count_calls, &nof_calls, "Count the calls", NULL, NULL};
+
+    nof_calls = 0;
+    cli_register_job_commands();
+    cli_register(&tick_binding);
+    cli_tick(1000); // starts the clock
+
+    run_line("watch 100 tick\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Job 0 started"));
+
+    for (uint32_t now_ms = 1010; now_ms <= 1500; now_ms += 10)
+    {
+        cli_tick(now_ms);
+        cli_process();
+    }
+    TEST_ASSERT_EQUAL(5, nof_calls);
+
+    // The user keeps typing while the job runs - the partial input is written again after each run
+    send_line("jo");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    cli_tick(1600);
+    cli_process();
+    TEST_ASSERT_EQUAL(6, nof_calls);
+    TEST_ASSERT_EQUAL_STRING("\r\033[K> jo", mock_print_buffer);
+
+    send_line("bs\n");
+    cli_process();
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "0: every 100 ms: tick"));
+
+    run_line("kill 0\n");
+    cli_tick(2600);
+    cli_process();
+    TEST_ASSERT_EQUAL(6, nof_calls);
+    verify_no_assert_triggered();
+}
+
+void test_cli_watch_periods_beyond_the_wheel_are_kept(void)
+{
+    static uint32_t nof_fast_calls = 0;
+    static uint32_t nof_slow_calls = 0;
+    static cli_binding_t fast_binding = {"fast", cmd_count_calls, &nof_fast_calls, "Count the calls", NULL, NULL};
+    static cli_binding_t slow_binding = {"slow", cmd_count_calls, &nof_slow_calls, "Count the calls", NULL, NULL};
+
+    nof_fast_calls = 0;
+    nof_slow_calls = 0;
+    cli_register_job_commands();
+    cli_register(&fast_binding);
+    cli_register(&slow_binding);
+
+    // The clock wraps around during the test
+    uint32_t now_ms = UINT32_MAX - 1005;
+    cli_tick(now_ms);
+
+    // 50 s is beyond both levels of the wheel (64 * 64 ticks of 10 ms), 10 ms is the next tick
+    run_line("watch 50000 slow\n");
+    run_line("watch 10 fast\n");
+
+    // One long jump - only one turn of the wheel (4096 ticks) is caught up, the slow job is due at tick 5000
+    now_ms += 100000;
+    cli_tick(now_ms);
+    cli_process();
+    TEST_ASSERT_EQUAL(0, nof_slow_calls);
+    TEST_ASSERT_EQUAL(1, nof_fast_calls); // a job is queued once, even if it expired several times
+
+    nof_fast_calls = 0;
+    for (uint32_t step = 0; step < 12000; step++)
+    {
+        now_ms += 10;
+        cli_tick(now_ms);
+        cli_process();
+    }
+
+    // Due at tick 5000, 10000 and 15000
+    TEST_ASSERT_EQUAL(12000, nof_fast_calls);
+    TEST_ASSERT_EQUAL(3, nof_slow_calls);
+    verify_no_assert_triggered();
+}
+
+uint16_t prv_crc16(const uint8_t* in_data, size_t in_len);
+
+static uint8_t received_data[512];
+static uint32_t nof_received_bytes = 0;
+static int transfer_done_status = 1;
+static int chunk_status = CLI_OK_STATUS;
+
+static int mock_chunk(uint32_t in_offset, const uint8_t* in_data, size_t in_len, void* context)
+{
+    (void)context;
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(received_data), in_offset + in_len);
+    memcpy(&received_data[in_offset], in_data, in_len);
+    nof_received_bytes += (uint32_t)in_len;
+    return chunk_status;
+}
+
+static void mock_transfer_done(int in_status, uint32_t in_nof_bytes, void* context)
+{
+    (void)in_nof_bytes;
+    (void)context;
+    transfer_done_status = in_status;
+}
+
+static cli_transfer_t test_transfer = {mock_chunk, mock_transfer_done, NULL, 0, false};
+
+static int cmd_upload(int argc, char* argv[], void* context)
+{
+    (void)context;
+    test_transfer.is_base64 = ((argc > 1) && (0 == strcmp(argv[1], "-b64"))) ? true : false;
+    test_transfer.start_offset = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 0;
+    cli_start_transfer(&test_transfer);
+    return CLI_OK_STATUS;
+}
+
+static size_t build_frame(uint8_t* out_frame, uint16_t in_seq, const uint8_t* in_payload, uint8_t in_len)
+{
+    out_frame[0] = (uint8_t)in_seq;
+    out_frame[1] = (uint8_t)(in_seq >> 8);
+    out_frame[2] = in_len;
+    memcpy(&out_frame[3], in_payload, in_len);
+    const uint16_t crc = prv_crc16(out_frame, 3U + in_len);
+    out_frame[3 + in_len] = (uint8_t)crc;
+    out_frame[4 + in_len] = (uint8_t)(crc >> 8);
+    return 5U + in_len;
+}
+
+static void send_raw_frame(uint16_t in_seq, const uint8_t* in_payload, uint8_t in_len, bool in_is_corrupted)
+{
+    uint8_t frame[CLI_TRANSFER_CHUNK_SIZE + 5];
+    const size_t length = build_frame(frame, in_seq, in_payload, in_len);
+    if (true == in_is_corrupted)
+    {
+        frame[length - 1] ^= 0x55U;
+    }
+    cli_receive((char)0x02);
+    for (size_t i = 0; i < length; i++)
+    {
+        cli_receive((char)frame[i]);
+    }
+}
+
+static void send_base64_frame(uint16_t in_seq, const uint8_t* in_payload, uint8_t in_len)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t frame[CLI_TRANSFER_CHUNK_SIZE + 5];
+    const size_t length = build_frame(frame, in_seq, in_payload, in_len);
+
+    for (size_t i = 0; i < length; i += 3)
+    {
+        const uint32_t bits = ((uint32_t)frame[i] << 16) | ((i + 1 < length) ? ((uint32_t)frame[i + 1] << 8) : 0U)
+                              | ((i + 2 < length) ? frame[i + 2] : 0U);
+        cli_receive(alphabet[(bits >> 18) & 0x3FU]);
+        cli_receive(alphabet[(bits >> 12) & 0x3FU]);
+        cli_receive((i + 1 < length) ? alphabet[(bits >> 6) & 0x3FU] : '=');
+        cli_receive((i + 2 < length) ? alphabet[bits & 0x3FU] : '=');
+    }
+    cli_receive('\r');
+    cli_receive('\n');
+}
+
+static void start_upload(const char* in_line)
+{
+    static cli_binding_t upload_binding = {"upload", cmd_upload, NULL, "Receive a binary transfer", NULL, NULL};
+
+    memset(received_data, 0, sizeof(received_data));
+    nof_received_bytes = 0;
+    transfer_done_status = 1;
+    chunk_status = CLI_OK_STATUS;
+    cli_register(&upload_binding);
+    run_line(in_line);
+}
+
+static void clear_output(void)
+{
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+}
+
+void test_cli_crc16_matches_the_ccitt_false_check_value(void)
+{
+    TEST_ASSERT_EQUAL(0x29B1, prv_crc16((const uint8_t*)"123456789", 9));
+}
+
+void test_cli_raw_transfer_delivers_chunks_and_returns_to_line_mode(void)
+{
+    uint8_t payload[200];
+    for (size_t i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(i * 7U); // includes '\n', '\b', '\t', STX and CAN bytes
+    }
+
+    start_upload("upload\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "READY 0 64\r\n"));
+
+    clear_output();
+    send_raw_frame(0, &payload[0], 64, false);
+    send_raw_frame(1, &payload[64], 64, false);
+    send_raw_frame(2, &payload[128], 64, false);
+    send_raw_frame(3, &payload[192], 8, false);
+    send_raw_frame(4, NULL, 0, false);
+
+    TEST_ASSERT_EQUAL_STRING("ACK 0\r\nACK 1\r\nACK 2\r\nACK 3\r\nACK 4\r\nDONE 200\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(200, nof_received_bytes);
+    TEST_ASSERT_EQUAL(0, memcmp(payload, received_data, sizeof(payload)));
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, transfer_done_status);
+
+    // Back in line mode
+    cli_register(&cli_bindings[0]);
+    run_line("hello\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Hello World!"));
+}
+
+void test_cli_transfer_naks_broken_frames_and_ignores_repeated_ones(void)
+{
+    const uint8_t payload[] = "0123456789abcdef";
+
+    start_upload("upload\n");
+    clear_output();
+
+    send_raw_frame(0, &payload[0], 8, true);  // CRC error
+    send_raw_frame(1, &payload[8], 8, false); // frame 0 is still missing
+    send_raw_frame(0, &payload[0], 8, false);
+    send_raw_frame(0, &payload[0], 8, false); // the ACK got lost - sent again
+    send_raw_frame(1, &payload[8], 8, false);
+    TEST_ASSERT_EQUAL_STRING("NAK 0\r\nNAK 0\r\nACK 0\r\nACK 0\r\nACK 1\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(16, nof_received_bytes);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdef", (const char*)received_data);
+
+    // CAN aborts
+    clear_output();
+    cli_receive((char)0x18);
+    TEST_ASSERT_EQUAL_STRING("ABORT\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, transfer_done_status);
+}
+
+void test_cli_base64_transfer_resumes_at_the_given_offset(void)
+{
+    const uint8_t payload[] = "calibration table";
+
+    start_upload("upload -b64 100\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "READY 100 64\r\n"));
+
+    // Different payload lengths exercise the base64 padding
+    clear_output();
+    send_base64_frame(0, &payload[0], 5);
+    send_base64_frame(1, &payload[5], 6);
+    send_base64_frame(2, &payload[11], 6);
+    send_base64_frame(3, NULL, 0);
+
+    TEST_ASSERT_EQUAL_STRING("ACK 0\r\nACK 1\r\nACK 2\r\nACK 3\r\nDONE 117\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(0, memcmp(payload, &received_data[100], 17));
+}
+
+void test_cli_transfer_is_aborted_by_the_chunk_callback(void)
+{
+    const uint8_t payload[] = "xyz";
+
+    start_upload("upload\n");
+    clear_output();
+    chunk_status = CLI_FAIL_STATUS;
+    send_raw_frame(0, payload, 3, false);
+
+    TEST_ASSERT_EQUAL_STRING("ABORT\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, transfer_done_status);
+}
+
+// #############################################################################
+// # Streaming Arguments
+// ###########################################################################
+
+static uint32_t streamed_sum = 0;
+static int nof_streamed_args = 0;
+static int sum_argc = 0;
+
+static int sum_arg(int in_arg_idx, const char* in_arg, void* context)
+{
+    (void)context;
+    if (1 == in_arg_idx)
+    {
+        streamed_sum = 0;
+    }
+    nof_streamed_args = in_arg_idx;
+    streamed_sum += (uint32_t)strtoul(in_arg, NULL, 0);
+    return CLI_OK_STATUS;
+}
+
+static int cmd_sum(int argc, char* argv[], void* context)
+{
+    (void)argv;
+    (void)context;
+    sum_argc = argc;
+    return CLI_OK_STATUS;
+}
+
+static cli_binding_t sum_binding = {"sum", cmd_sum, NULL, "Sums the streamed arguments", sum_arg, NULL};
+
+void test_cli_streamed_arguments_can_exceed_the_rx_buffer(void)
+{
+    cli_register(&sum_binding);
+    streamed_sum = 0;
+    nof_streamed_args = 0;
+
+    send_line("sum");
+    for (int i = 0; i < 100; i++)
+    {
+        send_line(" 1234");
+    }
+    run_line("\n");
+
+    TEST_ASSERT_EQUAL(100, nof_streamed_args);
+    TEST_ASSERT_EQUAL_UINT32(123400, streamed_sum);
+    TEST_ASSERT_EQUAL(1, sum_argc);
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "Buffer is full"));
+    verify_no_assert_triggered();
+}
+
+void test_cli_streamed_arguments_can_not_be_erased(void)
+{
+    cli_register(&sum_binding);
+    nof_streamed_args = 0;
+
+    run_line("sum 12 3\b\b\b4\n");
+
+    TEST_ASSERT_EQUAL(2, nof_streamed_args);
+    TEST_ASSERT_EQUAL_UINT32(16, streamed_sum);
+    verify_no_assert_triggered();
+}
+
+void test_cli_streaming_stops_at_a_pipeline(void)
+{
+    cli_register(&sum_binding);
+    nof_streamed_args = 0;
+    sum_argc = 0;
+
+    run_line("sum 5 6 | count\n");
+
+    // The pipeline is kept in the rx buffer and runs as usual
+    TEST_ASSERT_EQUAL(2, nof_streamed_args);
+    TEST_ASSERT_EQUAL_UINT32(11, streamed_sum);
+    TEST_ASSERT_EQUAL(1, sum_argc);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "\n0\r\n"));
+    verify_no_assert_triggered();
+}
+
+// #############################################################################
+// # cli_execute
+// ###########################################################################
+
+void test_cli_execute_returns_the_status_and_only_the_output_of_the_handler(void)
+{
+    char output[128];
+    size_t output_length = 0;
+    register_test_bindings();
+
+    int status = cli_execute("args one", output, sizeof(output), &output_length);
+
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, status);
+    TEST_ASSERT_EQUAL_STRING("argv[0] --> \"args\" \n\nargv[1] --> \"one\" \n\n", output);
+    TEST_ASSERT_EQUAL(strlen(output), output_length);
+
+    // Nothing reached the terminal
+    TEST_ASSERT_EQUAL(0, mock_print_index);
+
+    status = cli_execute("nope", output, sizeof(output), NULL);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, status);
+    TEST_ASSERT_EQUAL_STRING("Unknown command: nope\nType 'help' to list all commands\n", output);
+    verify_no_assert_triggered();
+}
+
+void test_cli_execute_truncates_the_output_to_the_buffer(void)
+{
+    char output[8];
+    size_t output_length = 0;
+    register_test_bindings();
+
+    int status = cli_execute("hello", output, sizeof(output), &output_length);
+
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, status);
+    TEST_ASSERT_EQUAL_STRING("Hello W", output);
+    TEST_ASSERT_EQUAL(7, output_length);
+    verify_no_assert_triggered();
+}
+
+void test_cli_execute_keeps_the_partial_input_of_the_user(void)
+{
+    char output[64];
+    register_test_bindings();
+
+    send_line("arg");
+    int status = cli_execute("help -c | count", output, sizeof(output), NULL);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, status);
+    TEST_ASSERT_EQUAL_STRING("5\n", output);
+
+    run_line("s hi\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[1] --> \"hi\""));
+    verify_no_assert_triggered();
+}
+
+void test_cli_receive_runs_lines_typed_ahead_in_order(void)
+{
+    static uint32_t nof_calls = 0;
+    static cli_binding_t count_binding = {"count", cmd_count_calls, &nof_calls, "Count the calls", NULL, NULL};
+    cli_register(&count_binding);
+    nof_calls = 0;
+
+    // Two more lines and a started one arrive before the first line is processed
+    const char* input = "count\ncount\ncount\nco";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+    cli_process();
+
+    TEST_ASSERT_EQUAL(3, nof_calls);
+    TEST_ASSERT_EQUAL(2, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+    TEST_ASSERT_EQUAL_MEMORY("co", g_cli_cfg_test.rx_char_buffer, 2);
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    verify_no_assert_triggered();
+}
+
+void test_cli_receive_rings_the_bell_for_keys_beyond_the_typeahead(void)
+{
+    const char* input = "help\n";
+    for (size_t i = 0; i < strlen(input); i++)
+    {
+        cli_receive(input[i]);
+    }
+
+    for (uint32_t i = 0; i < CLI_TYPEAHEAD_SIZE; i++)
+    {
+        cli_receive('a');
+    }
+    clear_output();
+    cli_receive('b');
+    TEST_ASSERT_EQUAL_STRING("\a", mock_print_buffer);
+    TEST_ASSERT_EQUAL(1, g_cli_cfg_test.stats.nof_lost_typeahead_chars);
+
+    // The queued keys are input again, the lost one is not
+    cli_process();
+    TEST_ASSERT_EQUAL(CLI_TYPEAHEAD_SIZE, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+    TEST_ASSERT_EQUAL('a', g_cli_cfg_test.rx_char_buffer[CLI_TYPEAHEAD_SIZE - 1]);
+}
+
+static void count_completed_lines(void* context)
+{
+    (*(uint32_t*)context)++;
+}
+
+void test_cli_poll_reports_lines_and_logs_until_they_are_processed(void)
+{
+    uint32_t nof_completed_lines = 0;
+    register_test_bindings();
+    cli_set_line_callback(count_completed_lines, &nof_completed_lines);
+
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+
+    send_line("hello");
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    TEST_ASSERT_EQUAL(0, nof_completed_lines);
+
+    send_line("\n");
+    TEST_ASSERT_EQUAL(CLI_WORK_LINE_READY, cli_poll(NULL));
+    TEST_ASSERT_EQUAL(1, nof_completed_lines);
+
+    // Characters typed while the line waits do not complete it again - they are a line of their own afterwards
+    send_line("x\n");
+    TEST_ASSERT_EQUAL(1, nof_completed_lines);
+
+    cli_process();
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.nof_stored_chars_in_rx_buffer);
+
+    cli_log("from elsewhere");
+    TEST_ASSERT_EQUAL(CLI_WORK_OUTPUT_PENDING, cli_poll(NULL));
+    cli_process();
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+
+    cli_set_line_callback(NULL, NULL);
+    run_line("hello\n");
+    TEST_ASSERT_EQUAL(1, nof_completed_lines);
+    verify_no_assert_triggered();
+}
+
+void test_cli_poll_reports_the_deadline_of_the_next_job(void)
+{
+    static uint32_t nof_calls = 0;
+    static cli_binding_t tick_binding = {"tick", cmd_count_calls, &nof_calls, "Count the calls", NULL, NULL};
+    uint32_t next_deadline_ms = 0;
+
+    nof_calls = 0;
+    cli_register_job_commands();
+    cli_register(&tick_binding);
+    cli_tick(1000);
+
+    run_line("watch 500 tick\n");
+    run_line("watch 120 tick\n");
+    TEST_ASSERT_EQUAL(CLI_WORK_JOB_SCHEDULED, cli_poll(&next_deadline_ms));
+    TEST_ASSERT_EQUAL(1120, next_deadline_ms);
+
+    cli_tick(1125);
+    TEST_ASSERT_EQUAL(CLI_WORK_JOB_DUE | CLI_WORK_JOB_SCHEDULED, cli_poll(&next_deadline_ms));
+    TEST_ASSERT_EQUAL(1240, next_deadline_ms);
+
+    cli_process();
+    TEST_ASSERT_EQUAL(1, nof_calls);
+    TEST_ASSERT_EQUAL(CLI_WORK_JOB_SCHEDULED, cli_poll(&next_deadline_ms));
+    TEST_ASSERT_EQUAL(1240, next_deadline_ms);
+
+    run_line("kill 1\n");
+    TEST_ASSERT_EQUAL(CLI_WORK_JOB_SCHEDULED, cli_poll(&next_deadline_ms));
+    TEST_ASSERT_EQUAL(1500, next_deadline_ms);
+
+    run_line("kill 0\n");
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    verify_no_assert_triggered();
+}
+
+void test_cli_command_is_resolved_while_its_arguments_are_typed(void)
+{
+    register_test_bindings();
+
+    send_line("  args one  two");
+    TEST_ASSERT_TRUE(g_cli_cfg_test.rx_tokens.is_cmd_resolved);
+    TEST_ASSERT_TRUE(&g_cli_cfg_test.cmd_bindings_buffer[2] == g_cli_cfg_test.rx_tokens.cmd_binding);
+    TEST_ASSERT_EQUAL(3, g_cli_cfg_test.rx_tokens.nof_tokens);
+    TEST_ASSERT_TRUE(g_cli_cfg_test.rx_tokens.is_token_open);
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\a'));
+
+    // Erasing into the previous token opens it again
+    send_line("\b\b\b\b\b");
+    TEST_ASSERT_EQUAL(2, g_cli_cfg_test.rx_tokens.nof_tokens);
+    TEST_ASSERT_TRUE(g_cli_cfg_test.rx_tokens.is_token_open);
+
+    run_line("s\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[1] --> \"ones\""));
+    TEST_ASSERT_EQUAL(0, g_cli_cfg_test.rx_tokens.nof_tokens);
+    verify_no_assert_triggered();
+}
+
+void test_cli_unknown_command_rings_the_bell_when_its_name_is_complete(void)
+{
+    register_test_bindings();
+
+    send_line("helo");
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\a'));
+    send_line(" ");
+    TEST_ASSERT_NOT_NULL(strchr(mock_print_buffer, '\a'));
+
+    // The corrected name is looked up again with its next delimiter
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    send_line("\b\blo ");
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\a'));
+    run_line("\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Hello World!"));
+
+    // BEL needs no escape sequences - dumb terminals get it as well
+    cli_set_terminal_caps(CLI_TERM_CAP_NONE);
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    send_line("helo ");
+    TEST_ASSERT_NOT_NULL(strchr(mock_print_buffer, '\a'));
+    verify_no_assert_triggered();
+}
+
+void test_cli_binding_resolved_while_typing_follows_moved_bindings(void)
+{
+    register_test_bindings();
+
+    send_line("dummy ");
+    cli_unregister("hello"); // "dummy" takes the place of "hello"
+    run_line("\n");
+
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "Unknown command"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> "));
+    verify_no_assert_triggered();
+}
+
+static const char* complete_gpio(int in_arg_idx, const char* in_prefix, uint16_t in_idx, void* context)
+{
+    static const char* const pins[] = {"PA0", "PA1", "PB5"};
+    static const char* const leds[] = {"led_red", "led_green"};
+    (void)in_prefix;
+    (void)context;
+
+    if (1 == in_arg_idx)
+    {
+        return (in_idx < CLI_GET_ARRAY_SIZE(pins)) ? pins[in_idx] : NULL;
+    }
+    return ((2 == in_arg_idx) && (in_idx < CLI_GET_ARRAY_SIZE(leds))) ? leds[in_idx] : NULL;
+}
+
+static cli_binding_t gpio_binding = {"gpio", prv_cmd_display_args, NULL, "Completes pins", NULL, complete_gpio};
+
+void test_cli_tab_completes_arguments_with_the_common_prefix_of_the_candidates(void)
+{
+    register_test_bindings();
+    cli_register(&gpio_binding);
+
+    send_line("gpio PB\t");
+    TEST_ASSERT_EQUAL_STRING("gpio PB5 ", g_cli_cfg_test.rx_char_buffer);
+    TEST_ASSERT_EQUAL_STRING("gpio PB5 ", mock_print_buffer);
+
+    send_line("\t");
+    TEST_ASSERT_EQUAL_STRING("gpio PB5 led_", g_cli_cfg_test.rx_char_buffer);
+    send_line("g\t");
+    TEST_ASSERT_EQUAL_STRING("gpio PB5 led_green ", g_cli_cfg_test.rx_char_buffer);
+
+    run_line("\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "argv[2] --> \"led_green\""));
+    verify_no_assert_triggered();
+}
+
+void test_cli_tab_lists_the_candidates_when_there_is_nothing_to_insert(void)
+{
+    register_test_bindings();
+    cli_register(&gpio_binding);
+
+    send_line("gpio PA");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    send_line("\t");
+
+    TEST_ASSERT_EQUAL_STRING("\r\033[KPA0  PA1\r\n> gpio PA", mock_print_buffer);
+    TEST_ASSERT_EQUAL_STRING("gpio PA", g_cli_cfg_test.rx_char_buffer);
+
+    // Commands without completion keep the tab to themselves
+    run_line("1\n");
+    memset(mock_print_buffer, 0, MOCK_BUFFER_SIZE);
+    mock_print_index = 0;
+    send_line("args P\t");
+    TEST_ASSERT_EQUAL_STRING("args P", g_cli_cfg_test.rx_char_buffer);
+    TEST_ASSERT_EQUAL_STRING("args P", mock_print_buffer);
+    verify_no_assert_triggered();
+}
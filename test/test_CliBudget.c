@@ -0,0 +1,178 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "CliPipe.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+/**
+ * Count based performance tests - the cost of an operation is counted instead of timed, so the budgets hold on
+ * any machine. Built with CLI_ENABLE_COST_COUNTERS and room for BUDGET_NOF_COMMANDS bindings (see project.yml).
+ * A budget that breaks means the operation got more expensive - raise it only, when that is intended.
+ */
+
+#define BUDGET_NOF_COMMANDS (100)
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_nop(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    return CLI_OK_STATUS;
+}
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+static cli_binding_t g_commands[BUDGET_NOF_COMMANDS];
+static cli_cost_counters_t g_cost;
+
+static void register_commands(void)
+{
+    for (size_t i = 0; i < BUDGET_NOF_COMMANDS; i++)
+    {
+        memset(&g_commands[i], 0, sizeof(g_commands[i]));
+        snprintf((char*)g_commands[i].name, CLI_MAX_CMD_NAME_LENGTH, "module%u_cmd", (unsigned)i);
+        g_commands[i].cmd_fn = cmd_nop;
+        cli_register(&g_commands[i]);
+    }
+}
+
+void setUp(void)
+{
+    setup_cli(&g_cli_cfg);
+    cli_reset_cost_counters();
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg);
+}
+
+static void measure(void (*in_operation)(void))
+{
+    cli_reset_cost_counters();
+    in_operation();
+    cli_get_cost_counters(&g_cost);
+}
+
+static void type_line(void)
+{
+    receive_chars("module42_cmd arg");
+}
+
+static void process_line(void)
+{
+    send_line("module42_cmd arg\n");
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_budget_echo_costs_one_sink_call_per_char(void)
+{
+    const uint32_t nof_chars = (uint32_t)strlen("module42_cmd arg");
+    register_commands();
+
+    measure(type_line);
+
+    TEST_ASSERT_EQUAL_UINT32(nof_chars, g_cost.nof_sink_calls);
+    TEST_ASSERT_EQUAL_UINT32(nof_chars, g_cost.nof_sink_bytes);
+    // Includes the tokenizer, which advances with every char so that Enter only has to dispatch
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(13 * nof_chars, g_cost.nof_integrity_checks);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, g_cost.nof_name_compares);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_budget_processed_line_stays_within_budget(void)
+{
+    register_commands();
+
+    measure(process_line);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(160, g_cost.nof_sink_bytes);
+    TEST_ASSERT_EQUAL_UINT32(g_cost.nof_sink_bytes, g_cost.nof_sink_calls);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(550, g_cost.nof_integrity_checks);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, g_cost.nof_name_compares);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_budget_transport_writes_a_line_in_one_call(void)
+{
+    cli_pipe_t pipe;
+    cli_transport_t transport;
+    register_commands();
+    cli_pipe_init(&pipe, &transport);
+    cli_set_transport(&transport);
+
+    cli_reset_cost_counters();
+    cli_pipe_write_input(&pipe, "module1_cmd\n", 12);
+    cli_process();
+    cli_get_cost_counters(&g_cost);
+
+    TEST_ASSERT_EQUAL_UINT32(1, g_cost.nof_sink_calls);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(160, g_cost.nof_sink_bytes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(400, g_cost.nof_integrity_checks);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+
+    cli_set_transport(NULL);
+}
+
+void test_cli_budget_dispatch_does_not_scan_the_registry(void)
+{
+    char output[64];
+    uint32_t max_compares = 0;
+    register_commands();
+
+    cli_reset_cost_counters();
+    for (size_t i = 0; i < BUDGET_NOF_COMMANDS; i++)
+    {
+        cli_cost_counters_t before;
+        cli_get_cost_counters(&before);
+        TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute(g_commands[i].name, output, sizeof(output), NULL));
+        cli_get_cost_counters(&g_cost);
+
+        const uint32_t nof_compares = g_cost.nof_name_compares - before.nof_name_compares;
+        max_compares = (nof_compares > max_compares) ? nof_compares : max_compares;
+    }
+
+    // Linear lookup would average BUDGET_NOF_COMMANDS / 2 compares per dispatch
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2 * BUDGET_NOF_COMMANDS, g_cost.nof_name_compares);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, max_compares);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(15 * BUDGET_NOF_COMMANDS, g_cost.nof_integrity_checks);
+    TEST_ASSERT_EQUAL(0, g_cost.nof_sink_calls);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
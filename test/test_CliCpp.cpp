@@ -0,0 +1,208 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Cli.hpp is C++17 - Ceedling builds the C tests only, this one is the test-cli-cpp target of CMakeLists.txt
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "Cli.hpp"
+extern "C"
+{
+#include "custom_assert.h" // a C header without its own linkage guard
+}
+
+#define CHECK(condition)                                                         \
+    do                                                                           \
+    {                                                                            \
+        if (!(condition))                                                        \
+        {                                                                        \
+            std::printf("  FAIL %s:%d %s\n", __FILE__, __LINE__, #condition);    \
+            g_nof_failed_checks++;                                               \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_STRING(expected, actual) CHECK(0 == std::strcmp((expected), (actual)))
+
+static uint32_t g_nof_failed_checks = 0;
+
+// #############################################################################
+// # Mocks
+// ###########################################################################
+
+static uint32_t nof_triggered_asserts = 0;
+
+static void mock_assert_callback(const char* file, uint32_t line, const char* expr)
+{
+    (void)file;
+    (void)line;
+    (void)expr;
+    nof_triggered_asserts++;
+}
+
+static int mock_put_char(char c)
+{
+    (void)c;
+    return 0;
+}
+
+static uint8_t g_channel = 0;
+static float g_duty = 0.0F;
+static uint32_t g_nof_calls = 0;
+
+static void set_pwm(uint8_t ch, float duty)
+{
+    g_channel = ch;
+    g_duty = duty;
+    g_nof_calls++;
+}
+
+static bool enable(bool on)
+{
+    g_nof_calls++;
+    return on;
+}
+
+static int offset(const char* name, int16_t value)
+{
+    g_nof_calls++;
+    return ((0 == std::strcmp(name, "up")) && (value > 0)) ? CLI_OK_STATUS : CLI_FAIL_STATUS;
+}
+
+static constexpr cli_binding_t g_bindings[] = {
+    cli::command<&set_pwm>("pwm", "Set a PWM duty"),
+    cli::command<&enable>("en", "Enable"),
+    cli::command<&offset>("offset", "Move"),
+};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg{};
+static char g_output[256];
+static size_t g_output_len = 0;
+
+static void setUp(void)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+    g_nof_calls = 0;
+
+    cli_init(&g_cli_cfg, mock_put_char);
+    for (const cli_binding_t& binding : g_bindings)
+    {
+        cli_register(&binding);
+    }
+    std::memset(g_output, 0, sizeof(g_output));
+}
+
+static void tearDown(void)
+{
+    cli_deinit(&g_cli_cfg);
+    custom_assert_deinit();
+}
+
+static int execute(const char* const in_line)
+{
+    return cli_execute(in_line, g_output, sizeof(g_output), &g_output_len);
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+static void test_cli_cpp_builds_the_help_text_at_compile_time(void)
+{
+    static_assert('S' == g_bindings[0].help[0], "the help text is a constant expression");
+
+    CHECK_STRING("pwm", g_bindings[0].name);
+    CHECK_STRING("Set a PWM duty - pwm u8 float", g_bindings[0].help);
+    CHECK_STRING("Enable - en bool", g_bindings[1].help);
+    CHECK_STRING("Move - offset str i16", g_bindings[2].help);
+}
+
+static void test_cli_cpp_parses_the_arguments(void)
+{
+    CHECK(CLI_OK_STATUS == execute("pwm 0x10 0.25"));
+    CHECK(16 == g_channel);
+    CHECK(0.25F == g_duty);
+    CHECK_STRING("", g_output);
+
+    // A bool result becomes the status, an int result is the status
+    CHECK(CLI_OK_STATUS == execute("en on"));
+    CHECK(CLI_FAIL_STATUS == execute("en 0"));
+    CHECK(CLI_OK_STATUS == execute("offset up 3"));
+    CHECK(CLI_FAIL_STATUS == execute("offset up -3"));
+    CHECK(5 == g_nof_calls);
+    CHECK(0 == nof_triggered_asserts);
+}
+
+static void test_cli_cpp_checks_the_range(void)
+{
+    // One line per message - the usage follows the invalid argument without a blank line
+    CHECK(CLI_FAIL_STATUS == execute("pwm 256 1"));
+    CHECK_STRING("Invalid argument 1: 256 is no u8\nUsage: pwm u8 float\n", g_output);
+
+    CHECK(CLI_FAIL_STATUS == execute("pwm -1 1"));
+    CHECK_STRING("Invalid argument 1: -1 is no u8\nUsage: pwm u8 float\n", g_output);
+
+    CHECK(CLI_FAIL_STATUS == execute("offset up 40000"));
+    CHECK_STRING("Invalid argument 2: 40000 is no i16\nUsage: offset str i16\n", g_output);
+
+    CHECK(CLI_FAIL_STATUS == execute("en maybe"));
+    CHECK_STRING("Invalid argument 1: maybe is no bool\nUsage: en bool\n", g_output);
+    CHECK(0 == g_nof_calls);
+}
+
+static void test_cli_cpp_checks_the_arity(void)
+{
+    CHECK(CLI_FAIL_STATUS == execute("pwm 1"));
+    CHECK_STRING("Usage: pwm u8 float\n", g_output);
+
+    CHECK(CLI_FAIL_STATUS == execute("en on off"));
+    CHECK_STRING("Usage: en bool\n", g_output);
+    CHECK(0 == g_nof_calls);
+}
+
+int main(void)
+{
+    void (*const tests[])(void) = {
+        test_cli_cpp_builds_the_help_text_at_compile_time,
+        test_cli_cpp_parses_the_arguments,
+        test_cli_cpp_checks_the_range,
+        test_cli_cpp_checks_the_arity,
+    };
+
+    for (void (*const test)(void) : tests)
+    {
+        setUp();
+        test();
+        tearDown();
+    }
+
+    std::printf("test_CliCpp: %u tests, %u failed checks\n", static_cast<unsigned>(CLI_GET_ARRAY_SIZE(tests)),
+                static_cast<unsigned>(g_nof_failed_checks));
+    return (0 == g_nof_failed_checks) ? 0 : 1;
+}
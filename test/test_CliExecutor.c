@@ -0,0 +1,305 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// Built with CLI_ENABLE_EXECUTOR and run under ThreadSanitizer (see project.yml) - the handlers run on two
+// worker threads while the test thread keeps calling cli_receive / cli_process.
+
+#define NOF_WORKERS       (2)
+#define MAX_WAIT_MS       (5000)
+
+// #############################################################################
+// # Test executor - a queue of offloads and two workers
+// ###########################################################################
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_changed = PTHREAD_COND_INITIALIZER;
+static cli_offload_t* g_queue[CLI_MAX_NOF_OFFLOADS];
+static size_t g_nof_queued = 0;
+static bool g_is_stop_requested = false;
+static bool g_is_released[4]; // gates of the "slow N" handlers
+static bool g_is_submit_refused = false;
+static pthread_t g_workers[NOF_WORKERS];
+
+static void* worker_main(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&g_lock);
+    for (;;)
+    {
+        while ((0 == g_nof_queued) && (false == g_is_stop_requested))
+        {
+            pthread_cond_wait(&g_changed, &g_lock);
+        }
+        if (0 == g_nof_queued)
+        {
+            break;
+        }
+        cli_offload_t* const offload = g_queue[0];
+        g_nof_queued--;
+        memmove(&g_queue[0], &g_queue[1], g_nof_queued * sizeof(g_queue[0]));
+
+        pthread_mutex_unlock(&g_lock);
+        cli_run_offload(offload);
+        pthread_mutex_lock(&g_lock);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+static bool is_offloaded(void* context, const cli_binding_t* in_binding)
+{
+    (void)context;
+    return (0 == strcmp(in_binding->name, "slow")) || (0 == strcmp(in_binding->name, "chatty"));
+}
+
+static bool submit(void* context, cli_offload_t* inout_offload)
+{
+    (void)context;
+    pthread_mutex_lock(&g_lock);
+    const bool is_accepted = (false == g_is_submit_refused) && (g_nof_queued < CLI_MAX_NOF_OFFLOADS);
+    if (true == is_accepted)
+    {
+        g_queue[g_nof_queued++] = inout_offload;
+        pthread_cond_broadcast(&g_changed);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return is_accepted;
+}
+
+static const cli_executor_t g_executor = {is_offloaded, submit, NULL};
+
+static void release(int in_gate)
+{
+    pthread_mutex_lock(&g_lock);
+    g_is_released[in_gate] = true;
+    pthread_cond_broadcast(&g_changed);
+    pthread_mutex_unlock(&g_lock);
+}
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_slow(int argc, char* argv[], void* context)
+{
+    (void)context;
+    const int gate = (argc > 1) ? atoi(argv[1]) : 0;
+
+    pthread_mutex_lock(&g_lock);
+    while (false == g_is_released[gate])
+    {
+        pthread_cond_wait(&g_changed, &g_lock);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    cli_print("slow %d done", gate);
+    return CLI_OK_STATUS;
+}
+
+static int cmd_chatty(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    // Pending handlers are called again on the worker - one line per call
+    cli_print("line %u of a long output", (unsigned)cli_get_continuation_index());
+    return (cli_get_continuation_index() < 19) ? CLI_PENDING_STATUS : CLI_FAIL_STATUS;
+}
+
+static int cmd_fast(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    cli_print("fast done");
+    return CLI_OK_STATUS;
+}
+
+static cli_binding_t g_bindings[] = {
+    {"slow", cmd_slow, NULL, "Waits for its gate", NULL, NULL},
+    {"chatty", cmd_chatty, NULL, "Prints more than fits", NULL, NULL},
+    {"fast", cmd_fast, NULL, "Runs inline", NULL, NULL},
+};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+
+static void wait_for_output(void)
+{
+    const struct timespec one_ms = {0, 1000000};
+    for (uint32_t waited_ms = 0; waited_ms < MAX_WAIT_MS; waited_ms++)
+    {
+        if (0 != (cli_poll(NULL) & CLI_WORK_OUTPUT_PENDING))
+        {
+            return;
+        }
+        nanosleep(&one_ms, NULL);
+    }
+    TEST_FAIL_MESSAGE("the offload did not finish");
+}
+
+void setUp(void)
+{
+    g_nof_queued = 0;
+    g_is_stop_requested = false;
+    g_is_submit_refused = false;
+    memset(g_is_released, 0, sizeof(g_is_released));
+    for (size_t i = 0; i < NOF_WORKERS; i++)
+    {
+        pthread_create(&g_workers[i], NULL, worker_main, NULL);
+    }
+
+    setup_cli(&g_cli_cfg);
+    cli_set_terminal_caps(CLI_TERM_CAP_NONE);
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(g_bindings); i++)
+    {
+        cli_register(&g_bindings[i]);
+    }
+    cli_set_executor(&g_executor);
+}
+
+void tearDown(void)
+{
+    pthread_mutex_lock(&g_lock);
+    g_is_stop_requested = true;
+    memset(g_is_released, 1, sizeof(g_is_released));
+    pthread_cond_broadcast(&g_changed);
+    pthread_mutex_unlock(&g_lock);
+    for (size_t i = 0; i < NOF_WORKERS; i++)
+    {
+        pthread_join(g_workers[i], NULL);
+    }
+
+    // Whatever is still running was finished by the workers above
+    cli_process();
+    teardown_cli(&g_cli_cfg);
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_offloaded_handler_does_not_block_the_input(void)
+{
+    receive_chars("slow 0\n");
+    cli_process();
+    TEST_ASSERT_EQUAL(CLI_WORK_OFFLOAD_RUNNING, cli_poll(NULL));
+
+    // The user types the next line while the handler runs - it waits until the output of the handler is printed
+    clear_output();
+    receive_chars("fast\n");
+    TEST_ASSERT_EQUAL_STRING("fast\r\n", mock_print_buffer);
+    TEST_ASSERT_EQUAL(CLI_WORK_OFFLOAD_RUNNING, cli_poll(NULL));
+    cli_process();
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "fast done"));
+
+    release(0);
+    wait_for_output();
+    cli_process();
+
+    const char* const slow_output = strstr(mock_print_buffer, "slow 0 done");
+    const char* const fast_output = strstr(mock_print_buffer, "fast done");
+    TEST_ASSERT_NOT_NULL(slow_output);
+    TEST_ASSERT_NOT_NULL(fast_output);
+    TEST_ASSERT_TRUE(slow_output < fast_output);
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_offloads_are_printed_in_the_order_they_were_entered(void)
+{
+    receive_chars("slow 1\n");
+    cli_process();
+    receive_chars("slow 2\n");
+    cli_process();
+
+    // Both run at the same time - the second one finishes first, but its output waits for the first one
+    release(2);
+    const struct timespec ten_ms = {0, 10000000};
+    nanosleep(&ten_ms, NULL);
+    cli_process();
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "slow 2 done"));
+
+    release(1);
+    while (NULL == strstr(mock_print_buffer, "slow 2 done"))
+    {
+        wait_for_output();
+        cli_process();
+    }
+
+    const char* const first_output = strstr(mock_print_buffer, "slow 1 done");
+    TEST_ASSERT_NOT_NULL(first_output);
+    TEST_ASSERT_TRUE(first_output < strstr(mock_print_buffer, "slow 2 done"));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_offload_output_is_truncated_to_whole_lines(void)
+{
+    receive_chars("chatty\n");
+    cli_process();
+    wait_for_output();
+    cli_process();
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "line 0 of a long output\r\n"));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "line 19 of a long output"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Output truncated\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> [FAIL]"));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_refused_offload_runs_inline(void)
+{
+    g_is_submit_refused = true;
+    release(3);
+
+    receive_chars("slow 3\n");
+    cli_process();
+
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "slow 3 done"));
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+
+    // Pipelines are not offloaded either
+    g_is_submit_refused = false;
+    clear_output();
+    receive_chars("slow 3 | count\n");
+    cli_process();
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "1\r\n"));
+    TEST_ASSERT_EQUAL(0, cli_poll(NULL));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// Runs under ThreadSanitizer (see project.yml) - any unsynchronized access between cli_log and cli_process
+// fails the build of this test.
+
+#define NOF_PRODUCERS          (4)
+#define NOF_LOGS_PER_PRODUCER  (20000)
+
+// #############################################################################
+// # Output parser - only ever called from the consumer thread
+// ###########################################################################
+
+static char line_buffer[CLI_LOG_MESSAGE_SIZE + 64];
+static size_t line_length = 0;
+static long next_expected_seq[NOF_PRODUCERS];
+static long nof_received_logs = 0;
+static long nof_dropped_logs = 0;
+static long nof_out_of_order_logs = 0;
+
+static void prv_parse_line(void)
+{
+    int producer = 0;
+    long seq = 0;
+    long dropped = 0;
+
+    if (2 == sscanf(line_buffer, "p%d %ld", &producer, &seq) && (producer >= 0) && (producer < NOF_PRODUCERS))
+    {
+        // Lines of one producer may be dropped, but never reordered
+        if (seq < next_expected_seq[producer])
+        {
+            nof_out_of_order_logs++;
+        }
+        next_expected_seq[producer] = seq + 1;
+        nof_received_logs++;
+    }
+    else if (1 == sscanf(line_buffer, "%ld log messages dropped", &dropped))
+    {
+        nof_dropped_logs += dropped;
+    }
+}
+
+// The output is parsed line by line instead of collected - it is far more than any buffer holds
+static int parse_output_char(char c)
+{
+    if ('\n' == c)
+    {
+        line_buffer[line_length] = '\0';
+        prv_parse_line();
+        line_length = 0;
+    }
+    else if ('\r' == c)
+    {
+        // part of every line end
+    }
+    else if (line_length < (sizeof(line_buffer) - 1))
+    {
+        line_buffer[line_length++] = c;
+    }
+    return 0;
+}
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg_test;
+
+void setUp(void)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+
+    memset(next_expected_seq, 0, sizeof(next_expected_seq));
+    line_length = 0;
+    nof_received_logs = 0;
+    nof_dropped_logs = 0;
+    nof_out_of_order_logs = 0;
+
+    cli_init(&g_cli_cfg_test, parse_output_char);
+    cli_set_terminal_caps(CLI_TERM_CAP_NONE); // plain lines are easier to parse
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg_test);
+}
+
+static int producers_done = 0;
+
+static void* prv_producer(void* arg)
+{
+    const int producer = (int)(intptr_t)arg;
+    for (long seq = 0; seq < NOF_LOGS_PER_PRODUCER; seq++)
+    {
+        cli_log("p%d %ld", producer, seq);
+    }
+    __atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void test_cli_log_from_several_threads_loses_or_reorders_nothing_silently(void)
+{
+    pthread_t threads[NOF_PRODUCERS];
+
+    __atomic_store_n(&producers_done, 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < NOF_PRODUCERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, prv_producer, (void*)(intptr_t)i));
+    }
+
+    // Keep typing while the logs come in - the partial input is redrawn after every batch
+    const char* const input = "hello";
+    size_t nof_typed_chars = 0;
+    while ((NOF_PRODUCERS != __atomic_load_n(&producers_done, __ATOMIC_ACQUIRE))
+           || (nof_typed_chars < strlen(input)))
+    {
+        if (nof_typed_chars < strlen(input))
+        {
+            cli_receive(input[nof_typed_chars++]);
+        }
+        cli_process();
+    }
+    for (int i = 0; i < NOF_PRODUCERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+    }
+    cli_process(); // the last published batch
+
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+    TEST_ASSERT_EQUAL(0, nof_out_of_order_logs);
+    TEST_ASSERT_EQUAL(NOF_PRODUCERS * NOF_LOGS_PER_PRODUCER, nof_received_logs + nof_dropped_logs);
+    TEST_ASSERT_EQUAL_STRING("hello", g_cli_cfg_test.rx_char_buffer);
+}
@@ -0,0 +1,244 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_result(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    cli_out_begin_map(NULL);
+    cli_out_kv_str("name", "a\"b");
+    cli_out_kv_int("n", -5);
+    cli_out_kv_bool("ok", true);
+    cli_out_begin_array("regs");
+    cli_out_kv_hex(NULL, 0x0DU);
+    cli_out_kv_uint(NULL, 300U);
+    cli_out_end_array();
+    cli_out_begin_map("empty");
+    cli_out_end_map();
+    cli_out_end_map();
+    return CLI_OK_STATUS;
+}
+
+static int cmd_unclosed(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    cli_out_begin_map(NULL);
+    cli_out_begin_array("list");
+    cli_out_kv_int(NULL, INT32_MIN);
+    return CLI_OK_STATUS;
+}
+
+static int cmd_misuse(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    cli_out_begin_map(NULL);
+    cli_out_kv_int(NULL, 1); // a map item without a key
+    cli_out_end_array();     // the open level is a map
+    cli_out_end_map();
+    return CLI_OK_STATUS;
+}
+
+static cli_binding_t g_bindings[] = {
+    {"result", cmd_result, NULL, "Writes a nested result", NULL, NULL},
+    {"unclosed", cmd_unclosed, NULL, "Leaves a map and an array open", NULL, NULL},
+    {"misuse", cmd_misuse, NULL, "Gets keys and ends wrong", NULL, NULL},
+};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+static char g_output[MOCK_BUFFER_SIZE];
+static size_t g_output_len = 0;
+
+void setUp(void)
+{
+    setup_cli(&g_cli_cfg);
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(g_bindings); i++)
+    {
+        cli_register(&g_bindings[i]);
+    }
+    cli_register_output_command();
+    memset(g_output, 0, sizeof(g_output));
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg);
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_out_writes_text(void)
+{
+    TEST_ASSERT_EQUAL(CLI_OUTPUT_MODE_TEXT, cli_get_output_mode());
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("result", g_output, sizeof(g_output), &g_output_len));
+
+    TEST_ASSERT_EQUAL_STRING("name: a\"b\n"
+                             "n: -5\n"
+                             "ok: true\n"
+                             "regs:\n"
+                             "  - 0x0000000D\n"
+                             "  - 300\n"
+                             "empty:\n",
+                             g_output);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_writes_json(void)
+{
+    cli_set_output_mode(CLI_OUTPUT_MODE_JSON);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("result", g_output, sizeof(g_output), &g_output_len));
+
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"a\\\"b\",\"n\":-5,\"ok\":true,\"regs\":[13,300],\"empty\":{}}\n", g_output);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_writes_cbor(void)
+{
+    // {_ "name": "a\"b", "n": -5, "ok": true, "regs": [_ 13, 300], "empty": {_ }}
+    const uint8_t expected[] = {0xBF, 0x64, 'n',  'a',  'm',  'e',  0x63, 'a',  '"',  'b',  0x61, 'n',
+                                0x24, 0x62, 'o',  'k',  0xF5, 0x64, 'r',  'e',  'g',  's',  0x9F, 0x0D,
+                                0x19, 0x01, 0x2C, 0xFF, 0x65, 'e',  'm',  'p',  't',  'y',  0xBF, 0xFF, 0xFF};
+
+    cli_set_output_mode(CLI_OUTPUT_MODE_CBOR);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("result", g_output, sizeof(g_output), &g_output_len));
+
+    // 0x0D is a CR - binary output keeps it, although cli_execute drops the CR of line ends
+    TEST_ASSERT_EQUAL(sizeof(expected), g_output_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_output, sizeof(expected));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_closes_what_the_handler_left_open(void)
+{
+    cli_set_output_mode(CLI_OUTPUT_MODE_JSON);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("unclosed", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("{\"list\":[-2147483648]}\n", g_output);
+
+    // The next command starts at the top level again
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("unclosed", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("{\"list\":[-2147483648]}\n", g_output);
+
+    // INT32_MIN in CBOR: major type 1 with -1 - n = 0x7FFFFFFF
+    const uint8_t expected[] = {0xBF, 0x64, 'l', 'i', 's', 't', 0x9F, 0x3A, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    cli_set_output_mode(CLI_OUTPUT_MODE_CBOR);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("unclosed", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL(sizeof(expected), g_output_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_output, sizeof(expected));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_rejects_wrong_keys_and_ends(void)
+{
+    cli_set_output_mode(CLI_OUTPUT_MODE_JSON);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("misuse", g_output, sizeof(g_output), &g_output_len));
+
+    // Both wrong calls assert and write nothing
+    TEST_ASSERT_EQUAL_STRING("{}\n", g_output);
+    TEST_ASSERT_EQUAL(2, nof_triggered_asserts);
+}
+
+void test_cli_out_mode_is_switched_with_the_output_command(void)
+{
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("output json", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL(CLI_OUTPUT_MODE_JSON, cli_get_output_mode());
+
+    // The current mode is answered in that mode
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("output", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("\"json\"\n", g_output);
+
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("output yaml", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL(CLI_OUTPUT_MODE_JSON, cli_get_output_mode());
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("output text", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL(CLI_OUTPUT_MODE_TEXT, cli_get_output_mode());
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_goes_through_the_filters(void)
+{
+    // One line per value - grep works on structured text output as well
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("result | grep ok", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("ok: true\n", g_output);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_rejects_filters_in_the_structured_modes(void)
+{
+    // A grep would split the JSON apart and a CR in the CBOR would be dropped
+    cli_set_output_mode(CLI_OUTPUT_MODE_JSON);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("result | grep ok", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("Invalid filter: |\nFilters work on text output only - use: output text\n", g_output);
+
+    cli_set_output_mode(CLI_OUTPUT_MODE_CBOR);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("result | count", g_output, sizeof(g_output), &g_output_len));
+    TEST_ASSERT_EQUAL_STRING("Invalid filter: |\nFilters work on text output only - use: output text\n", g_output);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_out_is_not_decorated_on_the_wire(void)
+{
+    // A typed line in text mode gets the echo, the rulers and the status
+    send_line("unclosed\r");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "unclosed\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> "));
+
+    // The structured modes put the answer alone on the wire
+    cli_set_output_mode(CLI_OUTPUT_MODE_JSON);
+    clear_output();
+    send_line("unclosed\r");
+    TEST_ASSERT_EQUAL_STRING("{\"list\":[-2147483648]}\r\n", mock_print_buffer);
+
+    // An unknown command is answered without the echo of the typed and erased characters
+    clear_output();
+    send_line("xy\bz\r");
+    TEST_ASSERT_EQUAL_STRING("Unknown command: xz\r\nType 'help' to list all commands\r\n", mock_print_buffer);
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\a'));
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\b'));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "Cli.h" // links Cli.c for the shared helpers
+#include "CliPipe.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_pipe_t g_pipe;
+static cli_transport_t g_transport;
+
+void setUp(void)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+
+    cli_pipe_init(&g_pipe, &g_transport);
+}
+
+void tearDown(void)
+{
+    custom_assert_deinit();
+}
+
+void test_cli_pipe_input_is_read_through_the_transport(void)
+{
+    char data[8] = {0};
+
+    TEST_ASSERT_FALSE(g_transport.poll_ready(g_transport.context));
+
+    TEST_ASSERT_EQUAL(5, cli_pipe_write_input(&g_pipe, "hello", 5));
+    TEST_ASSERT_TRUE(g_transport.poll_ready(g_transport.context));
+
+    TEST_ASSERT_EQUAL(3, g_transport.read(g_transport.context, data, 3));
+    TEST_ASSERT_EQUAL_STRING("hel", data);
+
+    memset(data, 0, sizeof(data));
+    TEST_ASSERT_EQUAL(2, g_transport.read(g_transport.context, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_STRING("lo", data);
+
+    TEST_ASSERT_FALSE(g_transport.poll_ready(g_transport.context));
+    TEST_ASSERT_EQUAL(0, g_transport.read(g_transport.context, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_pipe_gathers_all_iovecs_of_one_writev_call(void)
+{
+    const cli_iovec_t iovecs[] = {{"> ", 2}, {"abc", 3}, {"\r\n", 2}};
+    char data[16] = {0};
+
+    TEST_ASSERT_EQUAL(7, g_transport.writev(g_transport.context, iovecs, CLI_GET_ARRAY_SIZE(iovecs)));
+    TEST_ASSERT_EQUAL(1, g_pipe.nof_writev_calls);
+
+    TEST_ASSERT_EQUAL(7, cli_pipe_read_output(&g_pipe, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_STRING("> abc\r\n", data);
+}
+
+void test_cli_pipe_drops_output_when_full_and_wraps_around(void)
+{
+    static char data[CLI_PIPE_BUFFER_SIZE];
+    memset(data, 'x', sizeof(data));
+
+    const cli_iovec_t iovec = {data, sizeof(data)};
+    TEST_ASSERT_EQUAL(CLI_PIPE_BUFFER_SIZE, g_transport.writev(g_transport.context, &iovec, 1));
+
+    // The pipe is full now
+    const cli_iovec_t overflow = {"yz", 2};
+    TEST_ASSERT_EQUAL(0, g_transport.writev(g_transport.context, &overflow, 1));
+    TEST_ASSERT_EQUAL(2, g_pipe.nof_dropped_chars);
+
+    // Make room for two characters - they are stored at the start of the ring
+    char out[4] = {0};
+    TEST_ASSERT_EQUAL(2, cli_pipe_read_output(&g_pipe, out, 2));
+    TEST_ASSERT_EQUAL(2, g_transport.writev(g_transport.context, &overflow, 1));
+
+    TEST_ASSERT_EQUAL(CLI_PIPE_BUFFER_SIZE - 2, cli_pipe_read_output(&g_pipe, data, CLI_PIPE_BUFFER_SIZE - 2));
+    memset(out, 0, sizeof(out));
+    TEST_ASSERT_EQUAL(2, cli_pipe_read_output(&g_pipe, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("yz", out);
+}
@@ -0,0 +1,100 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// Built with every feature of cli_config.h switched off (see project.yml) - the minimal profile
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_percent(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    cli_print("duty 50%");
+    return CLI_OK_STATUS;
+}
+
+static cli_binding_t g_bindings[] = {
+    {"percent", cmd_percent, NULL, "Prints a percent sign", NULL, NULL},
+};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+
+void setUp(void)
+{
+    setup_cli(&g_cli_cfg);
+    cli_set_terminal_caps(CLI_TERM_CAP_ANSI);
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(g_bindings); i++)
+    {
+        cli_register(&g_bindings[i]);
+    }
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg);
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_profile_minimal_prints_plain_output(void)
+{
+    send_line("percent\n");
+
+    // The text is not formatted, and neither rulers nor colors are written - even to an ANSI terminal
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "duty 50%\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Status -> [OK]"));
+    TEST_ASSERT_NULL(strchr(mock_print_buffer, '\x1b'));
+    TEST_ASSERT_NULL(strstr(mock_print_buffer, "----"));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_profile_minimal_has_no_help_and_no_completion(void)
+{
+    send_line("help\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Unknown command: help"));
+
+    // Tab is ignored, so the typed prefix stays unknown
+    clear_output();
+    send_line("perc\t\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "Unknown command: perc"));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
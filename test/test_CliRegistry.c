@@ -0,0 +1,189 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_print_name(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)context;
+    cli_print("%s ran", argv[0]);
+    return CLI_OK_STATUS;
+}
+
+static const cli_binding_t g_shared_bindings[] = {
+    {"led", cmd_print_name, NULL, "Shared - set a led", NULL, NULL},
+    {"adc", cmd_print_name, NULL, "Shared - read an adc", NULL, NULL},
+    {"pwm", cmd_print_name, NULL, "Shared - set a pwm", NULL, NULL},
+};
+
+static const cli_binding_t g_local_binding = {"port", cmd_print_name, NULL, "Local to one instance", NULL, NULL};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+static cli_registry_t g_registry;
+static cli_size_t g_registry_index[CLI_REGISTRY_INDEX_SIZE(CLI_GET_ARRAY_SIZE(g_shared_bindings))];
+static char g_output[MOCK_BUFFER_SIZE];
+
+void setUp(void)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+
+    memset(&g_cli_cfg, 0, sizeof(g_cli_cfg));
+    memset(&g_registry, 0, sizeof(g_registry));
+    memset(g_output, 0, sizeof(g_output));
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg);
+}
+
+static void build_registry(void)
+{
+    TEST_ASSERT_TRUE(cli_registry_build(&g_registry, g_shared_bindings, CLI_GET_ARRAY_SIZE(g_shared_bindings),
+                                        g_registry_index, CLI_GET_ARRAY_SIZE(g_registry_index)));
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_registry_commands_run_next_to_the_overlay(void)
+{
+    build_registry();
+    cli_init(&g_cli_cfg, mock_put_char);
+    cli_set_registry(&g_registry);
+    cli_register(&g_local_binding);
+
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("adc", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL_STRING("adc ran\n", g_output);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("port", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL_STRING("port ran\n", g_output);
+
+    // The registry is listed first, then the overlay (help and port) - the bindings are not copied
+    cli_size_t cursor = 0;
+    TEST_ASSERT_TRUE(&g_shared_bindings[0] == cli_find_next_binding("", &cursor));
+    TEST_ASSERT_TRUE(&g_shared_bindings[1] == cli_find_next_binding("", &cursor));
+    TEST_ASSERT_TRUE(&g_shared_bindings[2] == cli_find_next_binding("", &cursor));
+    TEST_ASSERT_EQUAL_STRING("help", cli_find_next_binding("", &cursor)->name);
+    TEST_ASSERT_EQUAL_STRING("port", cli_find_next_binding("", &cursor)->name);
+    TEST_ASSERT_NULL(cli_find_next_binding("", &cursor));
+
+    // Only the instance's own binding slots are used
+    cli_stats_t stats;
+    cli_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.max_nof_bindings);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_registry_is_shared_by_instances_and_never_written(void)
+{
+    build_registry();
+    cli_size_t index_copy[CLI_GET_ARRAY_SIZE(g_registry_index)];
+    memcpy(index_copy, g_registry_index, sizeof(index_copy));
+
+    // One instance after the other - each with its own overlay, both with the same registry
+    for (uint8_t instance = 0; instance < 2; instance++)
+    {
+        cli_init(&g_cli_cfg, mock_put_char);
+        cli_set_registry(&g_registry);
+        if (0 == instance)
+        {
+            cli_register(&g_local_binding);
+        }
+
+        TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("pwm", g_output, sizeof(g_output), NULL));
+        TEST_ASSERT_EQUAL((0 == instance) ? CLI_OK_STATUS : CLI_FAIL_STATUS,
+                          cli_execute("port", g_output, sizeof(g_output), NULL));
+        cli_deinit(&g_cli_cfg);
+        memset(&g_cli_cfg, 0, sizeof(g_cli_cfg));
+    }
+
+    TEST_ASSERT_EQUAL_MEMORY(index_copy, g_registry_index, sizeof(index_copy));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_registry_refuses_duplicate_names(void)
+{
+    const cli_binding_t duplicates[] = {
+        {"led", cmd_print_name, NULL, "First", NULL, NULL},
+        {"led", cmd_print_name, NULL, "Second", NULL, NULL},
+    };
+    cli_size_t index[CLI_REGISTRY_INDEX_SIZE(2)];
+
+    TEST_ASSERT_FALSE(cli_registry_build(&g_registry, duplicates, 2, index, CLI_GET_ARRAY_SIZE(index)));
+    TEST_ASSERT_EQUAL(1, nof_triggered_asserts);
+
+    // A registry that is not frozen can not be used
+    cli_init(&g_cli_cfg, mock_put_char);
+    cli_set_registry(&g_registry);
+    TEST_ASSERT_EQUAL(2, nof_triggered_asserts);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("led", g_output, sizeof(g_output), NULL));
+
+    // The overlay must not hide a name of the registry and the other way round
+    build_registry();
+    cli_set_registry(&g_registry);
+    const cli_binding_t local_led = {"led", cmd_print_name, NULL, "Local led", NULL, NULL};
+    cli_register(&local_led); // the name exists, so it is not stored either
+    TEST_ASSERT_EQUAL(4, nof_triggered_asserts);
+    cli_set_registry(NULL);
+    cli_register(&local_led);
+    cli_set_registry(&g_registry);
+    TEST_ASSERT_EQUAL(5, nof_triggered_asserts);
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("led", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("adc", g_output, sizeof(g_output), NULL));
+}
+
+void test_cli_registry_change_invalidates_cached_bindings(void)
+{
+    build_registry();
+    cli_init(&g_cli_cfg, mock_put_char);
+    cli_register_alias_commands();
+    cli_set_registry(&g_registry);
+
+    // The alias caches the binding of "led" on its first run
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("alias l = led", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL(CLI_OK_STATUS, cli_execute("l", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL_STRING("led ran\n", g_output);
+
+    cli_set_registry(NULL);
+    TEST_ASSERT_EQUAL(CLI_FAIL_STATUS, cli_execute("l", g_output, sizeof(g_output), NULL));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
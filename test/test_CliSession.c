@@ -0,0 +1,154 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+#include "CliPipe.h"
+#include "CliSession.h"
+#include "custom_assert.h"
+#include "unity.h"
+
+// #############################################################################
+// # Assert Mocks
+// ###########################################################################
+
+static uint32_t nof_triggered_asserts = 0;
+
+static void mock_assert_callback(const char* file, uint32_t line, const char* expr)
+{
+    (void)file;
+    (void)line;
+    (void)expr;
+    nof_triggered_asserts++;
+}
+
+// #############################################################################
+// # Clock and Log Mocks
+// ###########################################################################
+
+static uint32_t mock_time_us = 0;
+
+static uint32_t mock_clock(void) { return mock_time_us; }
+
+static uint8_t session_log[256];
+static size_t session_log_size = 0;
+
+static void mock_write(const uint8_t* in_data, size_t in_len, void* context)
+{
+    (void)context;
+    TEST_ASSERT_TRUE(session_log_size + in_len <= sizeof(session_log));
+    memcpy(&session_log[session_log_size], in_data, in_len);
+    session_log_size += in_len;
+}
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_pipe_t g_pipe;
+static cli_transport_t g_pipe_transport;
+static cli_session_recorder_t g_recorder;
+static cli_transport_t g_transport;
+
+void setUp(void)
+{
+    custom_assert_init(mock_assert_callback);
+    nof_triggered_asserts = 0;
+    mock_time_us = 1000;
+    session_log_size = 0;
+
+    cli_pipe_init(&g_pipe, &g_pipe_transport);
+    cli_session_start_recording(&g_recorder, &g_pipe_transport, mock_clock, mock_write, NULL, &g_transport);
+}
+
+void tearDown(void)
+{
+    custom_assert_deinit();
+}
+
+void test_cli_session_records_input_and_output_with_their_timing(void)
+{
+    const cli_iovec_t iovecs[] = {{"he", 2}, {"llo\r\n", 5}};
+    char data[8] = {0};
+    cli_session_reader_t reader;
+    cli_session_record_t record;
+
+    mock_time_us += 40;
+    (void)cli_pipe_write_input(&g_pipe, "ab", 2);
+    TEST_ASSERT_EQUAL(2, g_transport.read(g_transport.context, data, sizeof(data)));
+
+    // Reads without data are not recorded
+    TEST_ASSERT_EQUAL(0, g_transport.read(g_transport.context, data, sizeof(data)));
+
+    mock_time_us += 300000;
+    TEST_ASSERT_EQUAL(7, g_transport.writev(g_transport.context, iovecs, CLI_GET_ARRAY_SIZE(iovecs)));
+    TEST_ASSERT_EQUAL(7, cli_pipe_read_output(&g_pipe, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(2, g_recorder.nof_records);
+
+    TEST_ASSERT_TRUE(cli_session_open(&reader, session_log, session_log_size));
+
+    TEST_ASSERT_TRUE(cli_session_next_record(&reader, &record));
+    TEST_ASSERT_EQUAL(CLI_SESSION_RECORD_INPUT, record.kind);
+    TEST_ASSERT_EQUAL_UINT32(40, record.delta_us);
+    TEST_ASSERT_EQUAL(2, record.len);
+    TEST_ASSERT_EQUAL_MEMORY("ab", record.data, 2);
+
+    // The iovecs of one writev call end up in one record
+    TEST_ASSERT_TRUE(cli_session_next_record(&reader, &record));
+    TEST_ASSERT_EQUAL(CLI_SESSION_RECORD_OUTPUT, record.kind);
+    TEST_ASSERT_EQUAL_UINT32(300000, record.delta_us);
+    TEST_ASSERT_EQUAL(7, record.len);
+    TEST_ASSERT_EQUAL_MEMORY("hello\r\n", record.data, 7);
+
+    TEST_ASSERT_FALSE(cli_session_next_record(&reader, &record));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_session_keeps_the_optional_transport_functions_optional(void)
+{
+    TEST_ASSERT_NULL(g_transport.flush);
+    TEST_ASSERT_NOT_NULL(g_transport.poll_ready);
+
+    TEST_ASSERT_FALSE(g_transport.poll_ready(g_transport.context));
+    (void)cli_pipe_write_input(&g_pipe, "x", 1);
+    TEST_ASSERT_TRUE(g_transport.poll_ready(g_transport.context));
+}
+
+void test_cli_session_reader_rejects_foreign_and_truncated_logs(void)
+{
+    const cli_iovec_t iovec = {"output", 6};
+    cli_session_reader_t reader;
+    cli_session_record_t record;
+
+    TEST_ASSERT_FALSE(cli_session_open(&reader, (const uint8_t*)"CLIX\x01", 5));
+    TEST_ASSERT_FALSE(cli_session_open(&reader, (const uint8_t*)"CLI", 3));
+
+    (void)g_transport.writev(g_transport.context, &iovec, 1);
+
+    // The last byte of the record is missing
+    TEST_ASSERT_TRUE(cli_session_open(&reader, session_log, session_log_size - 1));
+    TEST_ASSERT_FALSE(cli_session_next_record(&reader, &record));
+    TEST_ASSERT_EQUAL(CLI_SESSION_HEADER_SIZE, reader.pos);
+}
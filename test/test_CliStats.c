@@ -0,0 +1,216 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) <2025> <Max Koell (maxkoell@proton.me)>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Cli.h"
+#include "cli_test_helpers.h"
+#include "unity.h"
+
+// Built with CLI_ENABLE_STACK_PAINTING (see project.yml), so the stack use of the handlers is measured as well
+
+#define DEEP_STACK_BYTES (512)
+
+// #############################################################################
+// # Commands
+// ###########################################################################
+
+static int cmd_nop(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+    return CLI_OK_STATUS;
+}
+
+static int cmd_deep(int argc, char* argv[], void* context)
+{
+    (void)argv;
+    (void)context;
+
+    // Touches DEEP_STACK_BYTES of stack below the frame of the handler
+    volatile uint8_t scratch[DEEP_STACK_BYTES];
+    for (size_t i = 0; i < sizeof(scratch); i++)
+    {
+        scratch[i] = (uint8_t)(i + (size_t)argc);
+    }
+    return (0 != scratch[1]) ? CLI_OK_STATUS : CLI_FAIL_STATUS;
+}
+
+static int cmd_long_print(int argc, char* argv[], void* context)
+{
+    (void)argc;
+    (void)argv;
+    (void)context;
+
+    char line[CLI_PRINT_BUFFER_SIZE + 16];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    cli_print("%s", line);
+    cli_print("short");
+    return CLI_OK_STATUS;
+}
+
+static cli_binding_t g_bindings[] = {
+    {"nop", cmd_nop, NULL, "Does nothing", NULL, NULL},
+    {"deep", cmd_deep, NULL, "Uses some stack", NULL, NULL},
+    {"long", cmd_long_print, NULL, "Prints a line that does not fit", NULL, NULL},
+};
+
+// #############################################################################
+// # setup & teardown for testing
+// ###########################################################################
+
+static cli_cfg_t g_cli_cfg;
+static cli_stats_t g_stats;
+
+void setUp(void)
+{
+    setup_cli(&g_cli_cfg);
+    for (size_t i = 0; i < CLI_GET_ARRAY_SIZE(g_bindings); i++)
+    {
+        cli_register(&g_bindings[i]);
+    }
+    cli_register_stats_command();
+}
+
+void tearDown(void)
+{
+    teardown_cli(&g_cli_cfg);
+}
+
+// #############################################################################
+// # Tests
+// ###########################################################################
+
+void test_cli_stats_keep_the_high_water_marks(void)
+{
+    send_line("nop a b c\n");
+    send_line("nop\n");
+    cli_get_stats(&g_stats);
+
+    TEST_ASSERT_EQUAL(strlen("nop a b c\n"), g_stats.max_nof_rx_chars);
+    TEST_ASSERT_EQUAL(4, g_stats.max_nof_args);
+    TEST_ASSERT_EQUAL(5, g_stats.max_nof_bindings); // help, the three above and stats
+
+    // An unregistered binding does not lower the mark - a reset starts from the current use
+    cli_unregister("nop");
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_EQUAL(5, g_stats.max_nof_bindings);
+    cli_reset_stats();
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_EQUAL(4, g_stats.max_nof_bindings);
+    TEST_ASSERT_EQUAL(0, g_stats.max_nof_rx_chars);
+    TEST_ASSERT_EQUAL(0, g_stats.max_nof_args);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_stats_count_overflows_and_truncations(void)
+{
+    // One character more than the rx buffer holds
+    for (size_t i = 0; i <= CLI_MAX_RX_BUFFER_SIZE; i++)
+    {
+        cli_receive('a');
+    }
+
+    // More arguments than argv holds
+    char line[CLI_MAX_RX_BUFFER_SIZE] = "nop";
+    for (size_t i = 0; i < CLI_MAX_NOF_ARGUMENTS; i++)
+    {
+        strcat(line, " x");
+    }
+    strcat(line, "\n");
+    send_line(line);
+
+    send_line("long\n");
+    cli_get_stats(&g_stats);
+
+    TEST_ASSERT_EQUAL(1, g_stats.nof_rx_overflows);
+    TEST_ASSERT_EQUAL(CLI_MAX_RX_BUFFER_SIZE, g_stats.max_nof_rx_chars);
+    TEST_ASSERT_EQUAL(1, g_stats.nof_cut_arg_lists);
+    TEST_ASSERT_EQUAL(CLI_MAX_NOF_ARGUMENTS, g_stats.max_nof_args);
+    TEST_ASSERT_EQUAL(1, g_stats.nof_truncated_prints);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_stats_count_dropped_log_lines(void)
+{
+    for (size_t i = 0; i <= CLI_LOG_QUEUE_DEPTH; i++)
+    {
+        cli_log("log %u", (unsigned)i);
+    }
+
+    // Counted before cli_process reports them and after
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_EQUAL(1, g_stats.nof_dropped_logs);
+    cli_process();
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_EQUAL(1, g_stats.nof_dropped_logs);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_stats_measure_the_stack_of_the_handlers(void)
+{
+    send_line("nop\n");
+    cli_get_stats(&g_stats);
+    const uint32_t nop_stack_bytes = g_stats.max_dispatch_stack_bytes;
+
+    send_line("deep\n");
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_TRUE(g_stats.max_dispatch_stack_bytes >= DEEP_STACK_BYTES);
+    TEST_ASSERT_TRUE(g_stats.max_dispatch_stack_bytes <= CLI_STACK_PAINT_SIZE);
+    TEST_ASSERT_TRUE(g_stats.max_dispatch_stack_bytes > nop_stack_bytes);
+
+    // The mark stays until it is reset
+    const uint32_t deep_stack_bytes = g_stats.max_dispatch_stack_bytes;
+    send_line("nop\n");
+    cli_get_stats(&g_stats);
+    TEST_ASSERT_EQUAL(deep_stack_bytes, g_stats.max_dispatch_stack_bytes);
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}
+
+void test_cli_stats_command_prints_the_marks_next_to_the_limits(void)
+{
+    char expected[64];
+
+    send_line("nop a b\n");
+    clear_output();
+    send_line("stats\n");
+
+    snprintf(expected, sizeof(expected), "args          3 of %u\r\n", (unsigned)CLI_MAX_NOF_ARGUMENTS);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, expected));
+    snprintf(expected, sizeof(expected), "bindings      5 of %u\r\n", (unsigned)CLI_MAX_NOF_CALLBACKS);
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, expected));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "stack bytes   "));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "rx overflows  0\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "lost keys     0\r\n"));
+
+    clear_output();
+    send_line("stats reset\n");
+    send_line("stats\n");
+    TEST_ASSERT_NOT_NULL(strstr(mock_print_buffer, "args          1 of "));
+    TEST_ASSERT_EQUAL(0, nof_triggered_asserts);
+}